@@ -101,6 +101,7 @@ LOCAL_SRC_FILES += \
 	common/mptStringBuffer.cpp \
 	common/mptStringFormat.cpp \
 	common/mptStringParse.cpp \
+	common/mptThreadPool.cpp \
 	common/mptTime.cpp \
 	common/mptUUID.cpp \
 	common/mptWine.cpp \
@@ -175,6 +176,7 @@ LOCAL_SRC_FILES += \
 	soundlib/Paula.cpp \
 	soundlib/patternContainer.cpp \
 	soundlib/pattern.cpp \
+	soundlib/ResampleCache.cpp \
 	soundlib/RowVisitor.cpp \
 	soundlib/S3MTools.cpp \
 	soundlib/SampleFormats.cpp \
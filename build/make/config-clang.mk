@@ -27,7 +27,7 @@ CPPFLAGS +=
 CXXFLAGS += -fPIC
 CFLAGS   += -fPIC
 LDFLAGS  += 
-LDLIBS   += -lm
+LDLIBS   += -lm -lpthread
 ARFLAGS  := rcs
 
 ifeq ($(CHECKED_ADDRESS),1)
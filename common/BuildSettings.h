@@ -560,6 +560,10 @@
 #define MPT_FILEREADER_STD_ISTREAM // MMAP is only supported on Windows
 #endif
 
+#if defined(MPT_FILEREADER_STD_ISTREAM) && (MPT_OS_LINUX || MPT_OS_ANDROID || MPT_OS_MACOSX_OR_IOS || MPT_OS_FREEBSD || MPT_OS_DRAGONFLYBSD || MPT_OS_OPENBSD || MPT_OS_NETBSD || MPT_OS_GENERIC_UNIX) && !defined(MPT_FILEREADER_MMAP_POSIX)
+#define MPT_FILEREADER_MMAP_POSIX // Zero-copy loading of local files via POSIX mmap()
+#endif
+
 #if defined(MODPLUG_TRACKER) && !defined(MPT_ENABLE_FILEIO)
 #define MPT_ENABLE_FILEIO // Tracker requires disk file io
 #endif
@@ -568,6 +572,12 @@
 #define MPT_ENABLE_THREAD // Tracker requires threads
 #endif
 
+#if defined(LIBOPENMPT_BUILD) && MPT_PLATFORM_MULTITHREADED && !defined(MPT_ENABLE_THREAD)
+#if !((defined(__MINGW32__) || defined(__MINGW64__)) && !defined(_GLIBCXX_HAS_GTHREADS) && !defined(MPT_WITH_MINGWSTDTHREADS))
+#define MPT_ENABLE_THREAD // Optional multi-threaded rendering
+#endif
+#endif
+
 #if defined(MPT_EXTERNAL_SAMPLES) && !defined(MPT_ENABLE_FILEIO)
 #define MPT_ENABLE_FILEIO // External samples require disk file io
 #endif
@@ -432,6 +432,13 @@ public:
 		return mpt::byte_cast<const T*>(DataContainer().GetRawData() + streamPos);
 	}
 
+	// Makes sure that the whole underlying file is cached in memory.
+	// Afterwards, independent copies of this file reader (or of chunks read from it) can be read from concurrently.
+	void CacheWholeFile() const
+	{
+		DataContainer().GetRawData();
+	}
+
 	template <typename T>
 	std::size_t GetRawWithOffset(std::size_t offset, T *dst, std::size_t count) const
 	{
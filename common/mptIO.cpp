@@ -20,6 +20,12 @@
 #ifdef MPT_COMPILER_QUIRK_MSVC_STRINGSTREAM
 #include <typeinfo>
 #endif // MPT_COMPILER_QUIRK_MSVC_STRINGSTREAM
+#if defined(MPT_FILEREADER_MMAP_POSIX)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif // MPT_FILEREADER_MMAP_POSIX
 
 
 OPENMPT_NAMESPACE_BEGIN
@@ -582,6 +588,86 @@ IFileDataContainer::off_t FileDataContainerStdStream::InternalRead(mpt::byte *ds
 
 
 
+#if defined(MPT_FILEREADER_MMAP_POSIX)
+
+
+FileDataContainerMappedFile::FileDataContainerMappedFile(const char *filename)
+	: mappedData(nullptr)
+	, mappedLength(0)
+{
+	int flags = O_RDONLY;
+#if defined(O_CLOEXEC)
+	flags |= O_CLOEXEC;
+#endif
+	int fd = ::open(filename, flags);
+	if(fd == -1)
+	{
+		return;
+	}
+	struct stat st;
+	if(::fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0 && static_cast<uint64>(st.st_size) <= static_cast<uint64>(std::numeric_limits<off_t>::max()))
+	{
+		const off_t length = static_cast<off_t>(st.st_size);
+		void *data = ::mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+		if(data != MAP_FAILED)
+		{
+			mappedData = static_cast<const mpt::byte *>(data);
+			mappedLength = length;
+		}
+	}
+	// The mapping stays valid after closing the file descriptor.
+	::close(fd);
+}
+
+FileDataContainerMappedFile::~FileDataContainerMappedFile()
+{
+	if(mappedData)
+	{
+		::munmap(const_cast<mpt::byte *>(mappedData), mappedLength);
+	}
+}
+
+bool FileDataContainerMappedFile::IsValid() const
+{
+	return mappedData != nullptr;
+}
+
+bool FileDataContainerMappedFile::HasFastGetLength() const
+{
+	return true;
+}
+
+bool FileDataContainerMappedFile::HasPinnedView() const
+{
+	return true;
+}
+
+const mpt::byte *FileDataContainerMappedFile::GetRawData() const
+{
+	return mappedData;
+}
+
+IFileDataContainer::off_t FileDataContainerMappedFile::GetLength() const
+{
+	return mappedLength;
+}
+
+IFileDataContainer::off_t FileDataContainerMappedFile::Read(mpt::byte *dst, IFileDataContainer::off_t pos, IFileDataContainer::off_t count) const
+{
+	if(pos >= mappedLength)
+	{
+		return 0;
+	}
+	IFileDataContainer::off_t avail = std::min<IFileDataContainer::off_t>(mappedLength - pos, count);
+	std::copy(mappedData + pos, mappedData + pos + avail, dst);
+	return avail;
+}
+
+
+#endif // MPT_FILEREADER_MMAP_POSIX
+
+
+
 #if defined(MPT_FILEREADER_CALLBACK_STREAM)
 
 
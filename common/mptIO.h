@@ -923,6 +923,36 @@ private:
 };
 
 
+#if defined(MPT_FILEREADER_MMAP_POSIX)
+
+
+// Read-only memory mapping of a local file.
+// Unlike FileDataContainerSeekable, the pinned view is provided directly by the mapping instead of copying the whole file into memory.
+// If the file cannot be opened or mapped (e.g. because it is empty or not a regular file), IsValid() returns false
+// and the caller should fall back to reading the file as a stream.
+class FileDataContainerMappedFile : public IFileDataContainer
+{
+private:
+	const mpt::byte *mappedData;
+	off_t mappedLength;
+public:
+	FileDataContainerMappedFile(const char *filename);
+	~FileDataContainerMappedFile();
+	FileDataContainerMappedFile(const FileDataContainerMappedFile &) = delete;
+	FileDataContainerMappedFile & operator=(const FileDataContainerMappedFile &) = delete;
+public:
+	bool IsValid() const override;
+	bool HasFastGetLength() const override;
+	bool HasPinnedView() const override;
+	const mpt::byte *GetRawData() const override;
+	off_t GetLength() const override;
+	off_t Read(mpt::byte *dst, off_t pos, off_t count) const override;
+};
+
+
+#endif // MPT_FILEREADER_MMAP_POSIX
+
+
 #if defined(MPT_FILEREADER_CALLBACK_STREAM)
 
 
@@ -0,0 +1,147 @@
+/*
+ * mptThreadPool.cpp
+ * -----------------
+ * Purpose: Simple pool of worker threads for running batches of independent jobs.
+ * Notes  : (currently none)
+ * Authors: OpenMPT Devs
+ * The OpenMPT source code is released under the BSD license. Read LICENSE for more details.
+ */
+
+
+#include "stdafx.h"
+#include "mptThreadPool.h"
+
+
+OPENMPT_NAMESPACE_BEGIN
+
+
+#if defined(MPT_ENABLE_THREAD)
+
+namespace mpt
+{
+
+
+ThreadPool::ThreadPool(std::size_t numThreads)
+	: m_nextJob(0)
+{
+	for(std::size_t i = 1; i < numThreads; i++)
+	{
+		m_threads.emplace_back(&ThreadPool::WorkerThread, this);
+	}
+}
+
+
+ThreadPool::~ThreadPool()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_shutdown = true;
+	}
+	m_startCondition.notify_all();
+	for(auto &thread : m_threads)
+	{
+		thread.join();
+	}
+}
+
+
+void ThreadPool::Run(std::size_t numJobs, const Job &job)
+{
+	if(numJobs == 0)
+	{
+		return;
+	}
+	if(m_threads.empty() || numJobs == 1)
+	{
+		for(std::size_t i = 0; i < numJobs; i++)
+		{
+			job(i);
+		}
+		return;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_job = &job;
+		m_numJobs = numJobs;
+		m_nextJob = 0;
+		m_numBusyThreads = m_threads.size();
+		m_exception = nullptr;
+		m_generation++;
+	}
+	m_startCondition.notify_all();
+
+	ProcessJobs();
+
+	std::exception_ptr exception;
+	{
+		std::unique_lock<std::mutex> lock(m_mutex);
+		m_doneCondition.wait(lock, [this] { return m_numBusyThreads == 0; });
+		m_job = nullptr;
+		std::swap(exception, m_exception);
+	}
+	if(exception)
+	{
+		std::rethrow_exception(exception);
+	}
+}
+
+
+void ThreadPool::WorkerThread()
+{
+	uint64 generation = 0;
+	for(;;)
+	{
+		{
+			std::unique_lock<std::mutex> lock(m_mutex);
+			m_startCondition.wait(lock, [this, generation] { return m_shutdown || m_generation != generation; });
+			if(m_shutdown)
+			{
+				return;
+			}
+			generation = m_generation;
+		}
+
+		ProcessJobs();
+
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			if(--m_numBusyThreads == 0)
+			{
+				m_doneCondition.notify_one();
+			}
+		}
+	}
+}
+
+
+void ThreadPool::ProcessJobs()
+{
+	for(;;)
+	{
+		const std::size_t i = m_nextJob++;
+		if(i >= m_numJobs)
+		{
+			break;
+		}
+		try
+		{
+			(*m_job)(i);
+		} catch(...)
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			if(!m_exception)
+			{
+				m_exception = std::current_exception();
+			}
+		}
+	}
+}
+
+
+} // namespace mpt
+
+#endif // MPT_ENABLE_THREAD
+
+
+OPENMPT_NAMESPACE_END
@@ -0,0 +1,88 @@
+/*
+ * mptThreadPool.h
+ * ---------------
+ * Purpose: Simple pool of worker threads for running batches of independent jobs.
+ * Notes  : (currently none)
+ * Authors: OpenMPT Devs
+ * The OpenMPT source code is released under the BSD license. Read LICENSE for more details.
+ */
+
+#pragma once
+
+#include "BuildSettings.h"
+
+#include "mptBaseTypes.h"
+
+#if defined(MPT_ENABLE_THREAD)
+
+#include <atomic>
+#include <exception>
+#include <functional>
+#include <vector>
+#if (defined(__MINGW32__) || defined(__MINGW64__)) && !defined(_GLIBCXX_HAS_GTHREADS) && defined(MPT_WITH_MINGWSTDTHREADS)
+#include <mingw.condition_variable.h>
+#include <mingw.mutex.h>
+#include <mingw.thread.h>
+#else
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#endif
+
+#endif // MPT_ENABLE_THREAD
+
+
+OPENMPT_NAMESPACE_BEGIN
+
+
+#if defined(MPT_ENABLE_THREAD)
+
+namespace mpt
+{
+
+
+// Runs batches of jobs on a fixed set of worker threads.
+// The thread calling Run() also processes jobs, so a pool with numThreads == 1 does not create any threads at all.
+class ThreadPool
+{
+public:
+	typedef std::function<void(std::size_t)> Job;
+
+	explicit ThreadPool(std::size_t numThreads);
+	~ThreadPool();
+
+	ThreadPool(const ThreadPool &) = delete;
+	ThreadPool &operator=(const ThreadPool &) = delete;
+
+	// Total number of threads processing jobs, including the thread calling Run()
+	std::size_t GetNumThreads() const { return m_threads.size() + 1; }
+
+	// Calls job(i) for all i in [0, numJobs) and returns once all of them have finished.
+	// The order in which jobs are started and the thread they run on are unspecified.
+	// If any job throws, the first exception is rethrown after all jobs have finished.
+	void Run(std::size_t numJobs, const Job &job);
+
+protected:
+	void WorkerThread();
+	void ProcessJobs();
+
+	std::vector<std::thread> m_threads;
+	std::mutex m_mutex;
+	std::condition_variable m_startCondition;
+	std::condition_variable m_doneCondition;
+	std::exception_ptr m_exception;
+	const Job *m_job = nullptr;
+	std::size_t m_numJobs = 0;
+	std::atomic<std::size_t> m_nextJob;
+	std::size_t m_numBusyThreads = 0;
+	uint64 m_generation = 0;
+	bool m_shutdown = false;
+};
+
+
+} // namespace mpt
+
+#endif // MPT_ENABLE_THREAD
+
+
+OPENMPT_NAMESPACE_END
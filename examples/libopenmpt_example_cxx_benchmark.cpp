@@ -0,0 +1,92 @@
+/*
+ * libopenmpt_example_cxx_benchmark.cpp
+ * ------------------------------------
+ * Purpose: libopenmpt C++ API example
+ * Notes  : Measures rendering throughput for different internal render block sizes.
+ * Authors: OpenMPT Devs
+ * The OpenMPT source code is released under the BSD license. Read LICENSE for more details.
+ */
+
+/*
+ * Usage: libopenmpt_example_cxx_benchmark SOMEMODULE [BLOCKSIZE...]
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cwchar>
+#include <exception>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <libopenmpt/libopenmpt.hpp>
+
+#if ( defined( _WIN32 ) || defined( WIN32 ) ) && ( defined( _UNICODE ) || defined( UNICODE ) )
+#if defined( __GNUC__ )
+// mingw-w64 g++ does only default to special C linkage for "main", but not for "wmain" (see <https://sourceforge.net/p/mingw-w64/wiki2/Unicode%20apps/>).
+extern "C" int wmain( int argc, wchar_t * argv[] ) {
+#else
+int wmain( int argc, wchar_t * argv[] ) {
+#endif
+#else
+int main( int argc, char * argv[] ) {
+#endif
+	try {
+		if ( argc < 2 ) {
+			throw std::runtime_error( "Usage: libopenmpt_example_cxx_benchmark SOMEMODULE [BLOCKSIZE...]" );
+		}
+		const std::size_t buffersize = 16384;
+		const std::int32_t samplerate = 48000;
+		const int iterations = 3;
+		std::vector<std::string> blocksizes;
+		for ( int i = 2; i < argc; ++i ) {
+#if ( defined( _WIN32 ) || defined( WIN32 ) ) && ( defined( _UNICODE ) || defined( UNICODE ) )
+			blocksizes.push_back( std::to_string( std::wcstol( argv[i], nullptr, 10 ) ) );
+#else
+			blocksizes.push_back( argv[i] );
+#endif
+		}
+		if ( blocksizes.empty() ) {
+			blocksizes = { "16", "64", "256", "512", "1024", "4096", "16384" };
+		}
+		std::vector<float> buffer( buffersize * 2 );
+		std::ifstream file( argv[1], std::ios::binary );
+		openmpt::module mod( file );
+		mod.set_repeat_count( 0 );
+		std::cout << std::setw( 10 ) << "block size" << std::setw( 14 ) << "frames" << std::setw( 14 ) << "seconds" << std::setw( 16 ) << "frames/second" << std::setw( 12 ) << "realtime" << std::endl;
+		for ( const auto & blocksize : blocksizes ) {
+			mod.ctl_set( "render.block_size", blocksize );
+			double best = 0.0;
+			std::size_t frames = 0;
+			for ( int iteration = 0; iteration < iterations; ++iteration ) {
+				mod.set_position_seconds( 0.0 );
+				frames = 0;
+				const auto start = std::chrono::steady_clock::now();
+				while ( true ) {
+					std::size_t count = mod.read_interleaved_stereo( samplerate, buffersize, buffer.data() );
+					if ( count == 0 ) {
+						break;
+					}
+					frames += count;
+				}
+				const double seconds = std::chrono::duration<double>( std::chrono::steady_clock::now() - start ).count();
+				if ( iteration == 0 || seconds < best ) {
+					best = seconds;
+				}
+			}
+			const double frames_per_second = best > 0.0 ? frames / best : 0.0;
+			std::cout << std::setw( 10 ) << blocksize << std::setw( 14 ) << frames << std::setw( 14 ) << std::fixed << std::setprecision( 3 ) << best << std::setw( 16 ) << std::setprecision( 0 ) << frames_per_second << std::setw( 11 ) << std::setprecision( 1 ) << frames_per_second / samplerate << "x" << std::endl;
+		}
+	} catch ( const std::bad_alloc & ) {
+		std::cerr << "Error: " << std::string( "out of memory" ) << std::endl;
+		return 1;
+	} catch ( const std::exception & e ) {
+		std::cerr << "Error: " << std::string( e.what() ? e.what() : "unknown error" ) << std::endl;
+		return 1;
+	}
+	return 0;
+}
@@ -0,0 +1,101 @@
+/*
+ * libopenmpt_example_cxx_probe_benchmark.cpp
+ * ------------------------------------------
+ * Purpose: libopenmpt C++ API example
+ * Notes  : Measures probing and loading throughput over a set of files, which may also include files that are not modules.
+ * Authors: OpenMPT Devs
+ * The OpenMPT source code is released under the BSD license. Read LICENSE for more details.
+ */
+
+/*
+ * Usage: libopenmpt_example_cxx_probe_benchmark FILE...
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <exception>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <iterator>
+#include <new>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <libopenmpt/libopenmpt.hpp>
+
+#if ( defined( _WIN32 ) || defined( WIN32 ) ) && ( defined( _UNICODE ) || defined( UNICODE ) )
+#if defined( __GNUC__ )
+// mingw-w64 g++ does only default to special C linkage for "main", but not for "wmain" (see <https://sourceforge.net/p/mingw-w64/wiki2/Unicode%20apps/>).
+extern "C" int wmain( int argc, wchar_t * argv[] ) {
+#else
+int wmain( int argc, wchar_t * argv[] ) {
+#endif
+#else
+int main( int argc, char * argv[] ) {
+#endif
+	try {
+		if ( argc < 2 ) {
+			throw std::runtime_error( "Usage: libopenmpt_example_cxx_probe_benchmark FILE..." );
+		}
+		const int iterations = 3;
+		std::vector<std::vector<char>> files;
+		for ( int i = 1; i < argc; ++i ) {
+			std::ifstream file( argv[i], std::ios::binary );
+			if ( !file ) {
+				throw std::runtime_error( "Cannot open file" );
+			}
+			std::vector<char> data( ( std::istreambuf_iterator<char>( file ) ), std::istreambuf_iterator<char>() );
+			if ( !data.empty() ) {
+				files.push_back( std::move( data ) );
+			}
+		}
+		std::ostringstream log;
+		std::size_t probed = 0;
+		std::size_t loaded = 0;
+		double best_probe = 0.0;
+		double best_load = 0.0;
+		for ( int iteration = 0; iteration < iterations; ++iteration ) {
+			probed = 0;
+			auto start = std::chrono::steady_clock::now();
+			for ( const auto & data : files ) {
+				const std::size_t size = std::min( data.size(), openmpt::probe_file_header_get_recommended_size() );
+				if ( openmpt::probe_file_header( openmpt::probe_file_header_flags_default, reinterpret_cast<const std::uint8_t *>( data.data() ), size, data.size() ) == openmpt::probe_file_header_result_success ) {
+					probed++;
+				}
+			}
+			const double probe_seconds = std::chrono::duration<double>( std::chrono::steady_clock::now() - start ).count();
+			loaded = 0;
+			start = std::chrono::steady_clock::now();
+			for ( const auto & data : files ) {
+				try {
+					openmpt::module mod( data, log, { { "load.skip_samples", "1" } } );
+					loaded++;
+				} catch ( const openmpt::exception & ) {
+					// not a module
+				}
+			}
+			const double load_seconds = std::chrono::duration<double>( std::chrono::steady_clock::now() - start ).count();
+			if ( iteration == 0 || probe_seconds < best_probe ) {
+				best_probe = probe_seconds;
+			}
+			if ( iteration == 0 || load_seconds < best_load ) {
+				best_load = load_seconds;
+			}
+		}
+		std::cout << std::setw( 8 ) << "stage" << std::setw( 10 ) << "files" << std::setw( 10 ) << "modules" << std::setw( 14 ) << "seconds" << std::setw( 14 ) << "files/second" << std::endl;
+		std::cout << std::setw( 8 ) << "probe" << std::setw( 10 ) << files.size() << std::setw( 10 ) << probed << std::setw( 14 ) << std::fixed << std::setprecision( 6 ) << best_probe << std::setw( 14 ) << std::setprecision( 0 ) << ( best_probe > 0.0 ? files.size() / best_probe : 0.0 ) << std::endl;
+		std::cout << std::setw( 8 ) << "load" << std::setw( 10 ) << files.size() << std::setw( 10 ) << loaded << std::setw( 14 ) << std::fixed << std::setprecision( 6 ) << best_load << std::setw( 14 ) << std::setprecision( 0 ) << ( best_load > 0.0 ? files.size() / best_load : 0.0 ) << std::endl;
+	} catch ( const std::bad_alloc & ) {
+		std::cerr << "Error: " << std::string( "out of memory" ) << std::endl;
+		return 1;
+	} catch ( const std::exception & e ) {
+		std::cerr << "Error: " << std::string( e.what() ? e.what() : "unknown error" ) << std::endl;
+		return 1;
+	}
+	return 0;
+}
@@ -0,0 +1,103 @@
+/*
+ * libopenmpt_example_cxx_read_benchmark.cpp
+ * -----------------------------------------
+ * Purpose: libopenmpt C++ API example
+ * Notes  : Measures rendering throughput of all openmpt::module::read variants, including the conversion to the output sample format and layout.
+ * Authors: OpenMPT Devs
+ * The OpenMPT source code is released under the BSD license. Read LICENSE for more details.
+ */
+
+/*
+ * Usage: libopenmpt_example_cxx_read_benchmark SOMEMODULE
+ */
+
+#include <chrono>
+#include <cstdint>
+#include <exception>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <libopenmpt/libopenmpt.hpp>
+
+#if ( defined( _WIN32 ) || defined( WIN32 ) ) && ( defined( _UNICODE ) || defined( UNICODE ) )
+#if defined( __GNUC__ )
+// mingw-w64 g++ does only default to special C linkage for "main", but not for "wmain" (see <https://sourceforge.net/p/mingw-w64/wiki2/Unicode%20apps/>).
+extern "C" int wmain( int argc, wchar_t * argv[] ) {
+#else
+int wmain( int argc, wchar_t * argv[] ) {
+#endif
+#else
+int main( int argc, char * argv[] ) {
+#endif
+	try {
+		if ( argc != 2 ) {
+			throw std::runtime_error( "Usage: libopenmpt_example_cxx_read_benchmark SOMEMODULE" );
+		}
+		const int iterations = 3;
+		const std::int32_t samplerate = 48000;
+		const std::size_t buffersize = 1024;
+		const std::size_t frames = samplerate * 60;
+		std::ifstream file( argv[1], std::ios::binary );
+		openmpt::module mod( file );
+		mod.set_repeat_count( -1 );
+		std::vector<std::int16_t> i16( buffersize * 4 );
+		std::vector<float> f32( buffersize * 4 );
+		std::int16_t * const i16p[4] = { &i16[0], &i16[buffersize], &i16[buffersize * 2], &i16[buffersize * 3] };
+		float * const f32p[4] = { &f32[0], &f32[buffersize], &f32[buffersize * 2], &f32[buffersize * 3] };
+		struct variant {
+			const char * name;
+			std::function<std::size_t()> read;
+		};
+		const variant variants[] = {
+			{ "read mono int16", [&]() { return mod.read( samplerate, buffersize, i16p[0] ); } },
+			{ "read stereo int16", [&]() { return mod.read( samplerate, buffersize, i16p[0], i16p[1] ); } },
+			{ "read quad int16", [&]() { return mod.read( samplerate, buffersize, i16p[0], i16p[1], i16p[2], i16p[3] ); } },
+			{ "read mono float", [&]() { return mod.read( samplerate, buffersize, f32p[0] ); } },
+			{ "read stereo float", [&]() { return mod.read( samplerate, buffersize, f32p[0], f32p[1] ); } },
+			{ "read quad float", [&]() { return mod.read( samplerate, buffersize, f32p[0], f32p[1], f32p[2], f32p[3] ); } },
+			{ "read_interleaved_stereo int16", [&]() { return mod.read_interleaved_stereo( samplerate, buffersize, i16.data() ); } },
+			{ "read_interleaved_quad int16", [&]() { return mod.read_interleaved_quad( samplerate, buffersize, i16.data() ); } },
+			{ "read_interleaved_stereo float", [&]() { return mod.read_interleaved_stereo( samplerate, buffersize, f32.data() ); } },
+			{ "read_interleaved_quad float", [&]() { return mod.read_interleaved_quad( samplerate, buffersize, f32.data() ); } },
+		};
+		// Render with and without master gain, as float output applies the gain during the sample format conversion
+		const std::int32_t gains[] = { 0, -600 };
+		std::cout << std::setw( 32 ) << std::left << "variant" << std::right << std::setw( 8 ) << "gain" << std::setw( 12 ) << "seconds" << std::setw( 12 ) << "realtime" << std::endl;
+		for ( const auto gain : gains ) {
+			mod.set_render_param( openmpt::module::RENDER_MASTERGAIN_MILLIBEL, gain );
+			for ( const auto & v : variants ) {
+				double best = 0.0;
+				for ( int iteration = 0; iteration < iterations; ++iteration ) {
+					mod.set_position_seconds( 0.0 );
+					const auto start = std::chrono::steady_clock::now();
+					std::size_t rendered = 0;
+					while ( rendered < frames ) {
+						const std::size_t count = v.read();
+						if ( count == 0 ) {
+							break;
+						}
+						rendered += count;
+					}
+					const double seconds = std::chrono::duration<double>( std::chrono::steady_clock::now() - start ).count();
+					if ( iteration == 0 || seconds < best ) {
+						best = seconds;
+					}
+				}
+				std::cout << std::setw( 32 ) << std::left << v.name << std::right << std::setw( 8 ) << gain << std::setw( 12 ) << std::fixed << std::setprecision( 4 ) << best << std::setw( 11 ) << std::setprecision( 1 ) << ( best > 0.0 ? static_cast<double>( frames ) / samplerate / best : 0.0 ) << "x" << std::endl;
+			}
+		}
+	} catch ( const std::bad_alloc & ) {
+		std::cerr << "Error: " << std::string( "out of memory" ) << std::endl;
+		return 1;
+	} catch ( const std::exception & e ) {
+		std::cerr << "Error: " << std::string( e.what() ? e.what() : "unknown error" ) << std::endl;
+		return 1;
+	}
+	return 0;
+}
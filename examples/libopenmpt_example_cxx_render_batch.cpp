@@ -0,0 +1,159 @@
+/*
+ * libopenmpt_example_cxx_render_batch.cpp
+ * ---------------------------------------
+ * Purpose: libopenmpt C++ API example
+ * Notes  : Renders several modules concurrently with openmpt::render_batch, loading each module both from its file name and from memory.
+ * Authors: OpenMPT Devs
+ * The OpenMPT source code is released under the BSD license. Read LICENSE for more details.
+ */
+
+/*
+ * Usage: libopenmpt_example_cxx_render_batch SOMEMODULE ...
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <exception>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <iterator>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <libopenmpt/libopenmpt.hpp>
+
+namespace {
+
+struct job_result {
+	std::string name;
+	std::uint64_t frames = 0;
+	std::uint64_t checksum = 0;
+	float peak = 0.0f;
+	double duration = 0.0;
+	std::string error;
+};
+
+class example_callback : public openmpt::batch_callback {
+public:
+	example_callback( std::vector<job_result> & results, int channels ) : results( results ), channels( channels ) {
+		return;
+	}
+	// The callbacks of different jobs run concurrently, so every job only touches its own result.
+	bool loaded( std::size_t job, openmpt::module & mod ) override {
+		results[job].duration = mod.get_duration_seconds();
+		return true;
+	}
+	void render( std::size_t job, const float * interleaved, std::size_t frames ) override {
+		job_result & result = results[job];
+		for ( std::size_t i = 0; i < frames * channels; ++i ) {
+			result.peak = std::max( result.peak, std::fabs( interleaved[i] ) );
+			result.checksum = result.checksum * 31 + static_cast<std::uint64_t>( static_cast<std::int64_t>( interleaved[i] * 32768.0f ) );
+		}
+		result.frames += frames;
+	}
+	void finished( std::size_t job, const std::string & error, const std::string & /* log */ ) override {
+		results[job].error = error;
+	}
+private:
+	std::vector<job_result> & results;
+	const int channels;
+};
+
+// openmpt::batch_job::filename uses the native narrow character encoding of the platform.
+#if ( defined( _WIN32 ) || defined( WIN32 ) ) && ( defined( _UNICODE ) || defined( UNICODE ) )
+std::string native_filename( const wchar_t * filename ) {
+	const std::size_t size = std::wcstombs( nullptr, filename, 0 );
+	if ( size == static_cast<std::size_t>( -1 ) ) {
+		throw std::runtime_error( "file name cannot be represented in the native narrow character encoding" );
+	}
+	std::string result( size + 1, '\0' );
+	std::wcstombs( &result[0], filename, result.size() );
+	result.resize( size );
+	return result;
+}
+#else
+std::string native_filename( const char * filename ) {
+	return filename;
+}
+#endif
+
+} // namespace
+
+#if ( defined( _WIN32 ) || defined( WIN32 ) ) && ( defined( _UNICODE ) || defined( UNICODE ) )
+#if defined( __GNUC__ )
+// mingw-w64 g++ does only default to special C linkage for "main", but not for "wmain" (see <https://sourceforge.net/p/mingw-w64/wiki2/Unicode%20apps/>).
+extern "C" int wmain( int argc, wchar_t * argv[] ) {
+#else
+int wmain( int argc, wchar_t * argv[] ) {
+#endif
+#else
+int main( int argc, char * argv[] ) {
+#endif
+	try {
+		if ( argc < 2 ) {
+			throw std::runtime_error( "Usage: libopenmpt_example_cxx_render_batch SOMEMODULE ..." );
+		}
+		std::vector<openmpt::batch_job> jobs;
+		std::vector<job_result> results;
+		for ( int i = 1; i < argc; ++i ) {
+			// Load every module once by file name and once from memory. Both jobs must render the same audio.
+			openmpt::batch_job file_job;
+			file_job.filename = native_filename( argv[i] );
+			jobs.push_back( file_job );
+			results.emplace_back();
+			results.back().name = "file:" + file_job.filename;
+			openmpt::batch_job memory_job;
+			std::ifstream file( argv[i], std::ios::binary );
+			memory_job.data.assign( std::istreambuf_iterator<char>( file ), std::istreambuf_iterator<char>() );
+			jobs.push_back( memory_job );
+			results.emplace_back();
+			results.back().name = "memory:" + file_job.filename;
+		}
+		// A job that cannot be loaded is reported as failed, but does not stop the other jobs.
+		openmpt::batch_job invalid_job;
+		invalid_job.data.assign( 1024, 0xAA );
+		jobs.push_back( invalid_job );
+		results.emplace_back();
+		results.back().name = "invalid data";
+
+		openmpt::batch_settings settings;
+		settings.samplerate = 48000;
+		settings.channels = 2;
+		settings.repeat_count = 0;
+		example_callback callback( results, settings.channels );
+		const openmpt::batch_statistics statistics = openmpt::render_batch( jobs, settings, callback );
+
+		std::cout << std::setw( 40 ) << std::left << "job" << std::right << std::setw( 12 ) << "frames" << std::setw( 12 ) << "duration" << std::setw( 10 ) << "peak" << "  result" << std::endl;
+		for ( const auto & result : results ) {
+			std::cout << std::setw( 40 ) << std::left << result.name << std::right << std::setw( 12 ) << result.frames << std::setw( 12 ) << std::fixed << std::setprecision( 3 ) << result.duration << std::setw( 10 ) << result.peak << "  " << ( result.error.empty() ? std::string( "ok" ) : result.error ) << std::endl;
+		}
+		std::cout << statistics.jobs << " jobs, " << statistics.failed << " failed, " << statistics.frames << " frames in " << std::setprecision( 3 ) << statistics.seconds << " seconds";
+		if ( statistics.seconds > 0.0 ) {
+			std::cout << " (" << std::setprecision( 1 ) << static_cast<double>( statistics.frames ) / settings.samplerate / statistics.seconds << "x realtime)";
+		}
+		std::cout << std::endl;
+
+		bool ok = !results.back().error.empty();
+		for ( std::size_t i = 0; i + 1 < results.size(); i += 2 ) {
+			if ( results[i].error != results[i + 1].error || results[i].frames != results[i + 1].frames || results[i].checksum != results[i + 1].checksum ) {
+				std::cerr << "Error: " << results[i].name << " and " << results[i + 1].name << " rendered differently" << std::endl;
+				ok = false;
+			}
+		}
+		if ( !ok ) {
+			return 1;
+		}
+	} catch ( const std::bad_alloc & ) {
+		std::cerr << "Error: " << std::string( "out of memory" ) << std::endl;
+		return 1;
+	} catch ( const std::exception & e ) {
+		std::cerr << "Error: " << std::string( e.what() ? e.what() : "unknown error" ) << std::endl;
+		return 1;
+	}
+	return 0;
+}
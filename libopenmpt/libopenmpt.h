@@ -54,8 +54,12 @@
  *
  * \section libopenmpt_c_fileio File I/O
  *
- * libopenmpt can use 3 different strategies for file I/O.
+ * libopenmpt can use 4 different strategies for file I/O.
  *
+ * - openmpt_module_create_from_file() will load the module directly from a
+ * local file. On POSIX systems, the file is memory mapped while loading, which
+ * avoids copying the whole file into memory. On other systems, or if the file
+ * cannot be mapped, it is read like a seekable stream.
  * - openmpt_module_create_from_memory2() will load the module from the provided
  * memory buffer, which will require loading all data upfront by the library
  * caller.
@@ -71,6 +75,7 @@
  *
  * | create function                                 | speed  | memory consumption |
  * | ----------------------------------------------: | :----: | :----------------: |
+ * | openmpt_module_create_from_file()               | <p style="background-color:green" >fast  </p> | <p style="background-color:green" >low   </p> |
  * | openmpt_module_create_from_memory2()            | <p style="background-color:green" >fast  </p> | <p style="background-color:yellow">medium</p> | 
  * | openmpt_module_create2() with seekable stream   | <p style="background-color:red"   >slow  </p> | <p style="background-color:green" >low   </p> |
  * | openmpt_module_create2() with unseekable stream | <p style="background-color:yellow">medium</p> | <p style="background-color:red"   >high  </p> |
@@ -321,7 +326,7 @@ typedef struct openmpt_stream_callbacks {
 /*! \brief Logging function
  *
  * \param message UTF-8 encoded log message.
- * \param user User context that was passed to openmpt_module_create2(), openmpt_module_create_from_memory2() or openmpt_could_open_probability2().
+ * \param user User context that was passed to openmpt_module_create2(), openmpt_module_create_from_memory2(), openmpt_module_create_from_file() or openmpt_could_open_probability2().
  */
 typedef void (*openmpt_log_func)( const char * message, void * user );
 
@@ -412,7 +417,7 @@ LIBOPENMPT_API const char * openmpt_error_string( int error );
 /*! \brief Error function
  *
  * \param error Error code.
- * \param user User context that was passed to openmpt_module_create2(), openmpt_module_create_from_memory2() or openmpt_could_open_probability2().
+ * \param user User context that was passed to openmpt_module_create2(), openmpt_module_create_from_memory2(), openmpt_module_create_from_file() or openmpt_could_open_probability2().
  * \return Mask of OPENMPT_ERROR_FUNC_RESULT_LOG and OPENMPT_ERROR_FUNC_RESULT_STORE.
  * \retval OPENMPT_ERROR_FUNC_RESULT_NONE Do not log or store the error.
  * \retval OPENMPT_ERROR_FUNC_RESULT_LOG Log the error.
@@ -727,6 +732,42 @@ LIBOPENMPT_API LIBOPENMPT_DEPRECATED openmpt_module * openmpt_module_create_from
  */
 LIBOPENMPT_API openmpt_module * openmpt_module_create_from_memory2( const void * filedata, size_t filesize, openmpt_log_func logfunc, void * loguser, openmpt_error_func errfunc, void * erruser, int * error, const char * * error_message, const openmpt_module_initial_ctl * ctls );
 
+/*! \brief Construct an openmpt_module from a local file
+ *
+ * \param filename Path of the file to load the module from, in the native narrow character encoding of the platform (UTF-8 on most POSIX systems).
+ * \param logfunc Logging function where warning and errors are written. The logging function may be called throughout the lifetime of openmpt_module.
+ * \param loguser User-defined data associated with this module. This value will be passed to the logging callback function (logfunc)
+ * \param errfunc Error function to define error behaviour. May be NULL.
+ * \param erruser Error function user context. Used to pass any user-defined data associated with this module to the logging function.
+ * \param error Pointer to an integer where an error may get stored. May be NULL.
+ * \param error_message Pointer to a string pointer where an error message may get stored. May be NULL.
+ * \param ctls A map of initial ctl values. See openmpt_module_get_ctls()
+ * \return A pointer to the constructed openmpt_module, or NULL on failure.
+ * \remarks The file is not accessed anymore after an openmpt_module has been constructed successfully, unless load.lazy_samples is set. In that case, the file stays memory mapped and must not be modified or truncated until the sample data has been decoded.
+ * \remarks The file must not be modified while the module is being constructed.
+ * \sa \ref libopenmpt_c_fileio
+ * \since 0.5.0
+ */
+LIBOPENMPT_API openmpt_module * openmpt_module_create_from_file( const char * filename, openmpt_log_func logfunc, void * loguser, openmpt_error_func errfunc, void * erruser, int * error, const char * * error_message, const openmpt_module_initial_ctl * ctls );
+
+/*! \brief Construct an openmpt_module that plays the same module as another openmpt_module
+ *
+ * \param other The already loaded module to copy.
+ * \param logfunc Logging function where warning and errors are written. The logging function may be called throughout the lifetime of openmpt_module.
+ * \param loguser User-defined data associated with this module. This value will be passed to the logging callback function (logfunc)
+ * \param errfunc Error function to define error behaviour. May be NULL.
+ * \param erruser Error function user context. Used to pass any user-defined data associated with this module to the logging function.
+ * \param error Pointer to an integer where an error may get stored. May be NULL.
+ * \param error_message Pointer to a string pointer where an error message may get stored. May be NULL.
+ * \param ctls A map of initial ctl values. See openmpt_module_get_ctls(). ctls that only affect loading are ignored.
+ * \return A pointer to the constructed openmpt_module, or NULL on failure.
+ * \remarks The new module starts playback from the beginning of the song, independently of the playback state of the other module.
+ * \remarks The sample data is shared between both modules instead of being copied, which makes this considerably faster and cheaper than loading the module again. Either module can be destroyed first.
+ * \remarks Any remaining lazily loaded samples of the other module (see load.lazy_samples) are decoded. The other module must not be used by another thread while it is being copied.
+ * \since 0.5.0
+ */
+LIBOPENMPT_API openmpt_module * openmpt_module_create_copy( openmpt_module * other, openmpt_log_func logfunc, void * loguser, openmpt_error_func errfunc, void * erruser, int * error, const char * * error_message, const openmpt_module_initial_ctl * ctls );
+
 /*! \brief Unload a previously created openmpt_module from memory.
  *
  * \param mod The module to unload.
@@ -828,6 +869,8 @@ LIBOPENMPT_API void openmpt_module_error_clear( openmpt_module * mod );
  *  - 2: linear interpolation
  *  - 4: cubic interpolation
  *  - 8: windowed sinc with 8 taps
+ *  - 16: windowed sinc with 16 taps
+ *  - 32: windowed sinc with 32 taps
  */
 #define OPENMPT_MODULE_RENDER_INTERPOLATIONFILTER_LENGTH 3
 /*! \brief Volume Ramping Strength
@@ -1397,7 +1440,11 @@ LIBOPENMPT_API const char * openmpt_module_highlight_pattern_row_channel( openmp
  *          - load.skip_patterns: Set to "1" to avoid loading patterns into memory
  *          - load.skip_plugins: Set to "1" to avoid loading plugins
  *          - load.skip_subsongs_init: Set to "1" to avoid pre-initializing sub-songs. Skipping results in faster module loading but slower seeking.
+ *          - load.lazy_samples: Set to "1" to decode sample data when a subsong is selected or the playback position is set instead of while loading. This speeds up loading modules that are only inspected and not played. Only has an effect for IT, MPTM, S3M and XM files that are loaded with openmpt_module_create_from_file() on systems where the file can be memory mapped. The file must not be modified or truncated until the sample data has been decoded. Setting it to "0" after loading decodes all remaining sample data. Reading audio never decodes sample data, so select a subsong, set the position or set this ctl to "0" before calling the openmpt_module_read functions; samples that have not been decoded yet are not played.
+ *          - load.threads: Set the number of threads that are used for decoding sample data while loading, including the loading thread. "1" (the default) decodes all samples on the loading thread. The loaded sample data does not depend on this setting. Has no effect if libopenmpt has been built without thread support.
+ *          - load.subsongs_init_threads: Set the number of threads that are used for determining the durations of the sub-songs while loading, including the loading thread. Each sequence of a module with several sequences can be scanned on its own thread. "1" (the default) scans all sequences on the loading thread. The resulting sub-songs and their order do not depend on this setting. Has no effect if libopenmpt has been built without thread support.
  *          - seek.sync_samples: Set to "1" to sync sample playback when using openmpt_module_set_position_seconds or openmpt_module_set_position_order_row.
+ *          - seek.index_interval: Interval in seconds between the playback state snapshots that are recorded while scanning sub-songs. Seeking resumes from the closest snapshot, so seeking cost does not grow with the seek position. Smaller values result in faster seeking but use more memory. Set to "0" to disable the seek index. The default is "10.0".
  *          - subsong: The current subsong. Setting it has identical semantics as openmpt_module_select_subsong(), getting it returns the currently selected subsong.
  *          - play.at_end: Chooses the behaviour when the end of song is reached:
  *                         - "fadeout": Fades the module out for a short while. Subsequent reads after the fadeout will return 0 rendered frames.
@@ -1406,7 +1453,29 @@ LIBOPENMPT_API const char * openmpt_module_highlight_pattern_row_channel( openmp
  *          - play.tempo_factor: Set a floating point tempo factor. "1.0" is the default tempo.
  *          - play.pitch_factor: Set a floating point pitch factor. "1.0" is the default pitch.
  *          - render.resampler.emulate_amiga: Set to "1" to enable the Amiga resampler for Amiga modules. This emulates the sound characteristics of the Paula chip and overrides the selected interpolation filter. Non-Amiga module formats are not affected by this setting.
+ *          - render.block_size: Maximum number of frames that are rendered at once internally. Larger values reduce per-block overhead when rendering offline, smaller values reduce the latency of parameter changes. Blocks are never larger than 512 frames while plugins are loaded. Valid values are 1 to 16384. The default is "512".
+ *          - render.mixer.threads: Set the number of threads that are used for mixing sample voices, including the thread calling read. "1" (the default) mixes all voices on the calling thread. The rendered output does not depend on this setting. Has no effect if libopenmpt has been built without thread support.
+ *          - render.skipped_silent_frames: Number of sample voice frames that were not mixed because only silent sample data would have been read. Skipping silent sample data does not change the rendered output. Set to "0" to reset the counter.
+ *          - render.resample_cache.size: Maximum amount of memory in bytes that is used for caching resampled sample data. Voices that play the same sample at the same pitch with cubic, sinc or Kaiser interpolation share the cached data instead of running the interpolation again. The rendered output is identical to rendering without the cache. "0" disables the cache. The default is "0".
+ *          - render.resample_cache.hits: Number of sample voice frames that were mixed from the resample cache. Set to "0" to reset both this counter and render.resample_cache.misses.
+ *          - render.resample_cache.misses: Number of sample voice frames that could have used the resample cache but had to be resampled. Set to "0" to reset both this counter and render.resample_cache.hits.
+ *          - render.deadline.budget: Time in microseconds that a single call to read may take. If rendering comes close to this budget, the resampling quality of the quietest voices is lowered to linear interpolation until rendering is fast enough again. "0" (the default) disables this behaviour, in which case the rendered output does not depend on the time it takes to render.
+ *          - render.deadline.degradations: Number of times the resampling quality was lowered because rendering came close to the time budget set via render.deadline.budget. Set to "0" to reset the counter.
+ *          - render.deadline.degraded_voices: Number of voices that are currently rendered with lowered resampling quality. This ctl is read-only.
+ *          - render.max_voices: Maximum number of voices, i.e. pattern channels plus the background channels that keep playing notes after a new note has been triggered on the same pattern channel. Fewer voices need less memory and rendering time, but background notes may be cut earlier than in the original tracker. The limit is never lower than the number of pattern channels. Notes that are playing on voices beyond a newly set limit are cut. Valid values are 1 to 256. The default is "256".
  *          - render.opl.volume_factor: Set volume factor applied to synthesized OPL sounds, relative to the default OPL volume.
+ *          - profile.read_calls: Number of calls to the read functions. All profile.* ctls are read-only counters that are collected while rendering; setting any of them to "0" resets all of them.
+ *          - profile.read_ns: Total time in nanoseconds spent in the read functions.
+ *          - profile.frames: Number of rendered frames.
+ *          - profile.ticks: Number of processed module ticks.
+ *          - profile.tick_ns: Time in nanoseconds spent processing pattern data and effects.
+ *          - profile.mix_ns: Time in nanoseconds spent mixing sample voices.
+ *          - profile.voices_mixed: Sum of the number of sample voices mixed in each internal render block.
+ *          - profile.opl_ns: Time in nanoseconds spent synthesizing OPL sounds.
+ *          - profile.reverb_ns: Time in nanoseconds spent in the reverb effect.
+ *          - profile.plugins_ns: Time in nanoseconds spent in mix plugins.
+ *          - profile.dsp_ns: Time in nanoseconds spent applying global volume, stereo separation and DSP effects.
+ *          - profile.output_ns: Time in nanoseconds spent converting the rendered audio to the output format.
  *          - dither: Set the dither algorithm that is used for the 16 bit versions of openmpt_module_read. Supported values are:
  *                    - 0: No dithering.
  *                    - 1: Default mode. Chosen by OpenMPT code, might change.
@@ -45,8 +45,13 @@
  *
  * \section libopenmpt_cpp_fileio File I/O
  *
- * libopenmpt can use 3 different strategies for file I/O.
+ * libopenmpt can use 4 different strategies for file I/O.
  *
+ * - openmpt::module::module() with a file name as parameter will load the
+ * module directly from a local file. On POSIX systems, the file is memory
+ * mapped while loading, which avoids copying the whole file into memory.
+ * On other systems, or if the file cannot be mapped, it is read like a seekable
+ * stream.
  * - openmpt::module::module() with any kind of memory buffer as parameter will
  * load the module from the provided memory buffer, which will require loading
  * all data upfront by the library
@@ -63,6 +68,7 @@
  *
  * | constructor       | speed  | memory consumption |
  * | ----------------: | :----: | :----------------: |
+ * | file name         | <p style="background-color:green" >fast  </p> | <p style="background-color:green" >low   </p> |
  * | memory buffer     | <p style="background-color:green" >fast  </p> | <p style="background-color:yellow">medium</p> | 
  * | seekable stream   | <p style="background-color:red"   >slow  </p> | <p style="background-color:green" >low   </p> |
  * | unseekable stream | <p style="background-color:yellow">medium</p> | <p style="background-color:red"   >high  </p> |
@@ -373,6 +379,8 @@ public:
 		   - 2: linear interpolation
 		   - 4: cubic interpolation
 		   - 8: windowed sinc with 8 taps
+		   - 16: windowed sinc with 16 taps
+		   - 32: windowed sinc with 32 taps
 		*/
 		RENDER_INTERPOLATIONFILTER_LENGTH = 3,
 		//! Volume Ramping Strength
@@ -417,6 +425,17 @@ public:
 	  \sa \ref libopenmpt_cpp_fileio
 	*/
 	module( std::istream & stream, std::ostream & log = std::clog, const std::map< std::string, std::string > & ctls = detail::initial_ctls_map() );
+	/*!
+	  \param filename Path of the local file to load the module from, in the native narrow character encoding of the platform (UTF-8 on most POSIX systems).
+	  \param log Log where any warnings or errors are printed to. The lifetime of the reference has to be as long as the lifetime of the module instance.
+	  \param ctls A map of initial ctl values, see openmpt::module::get_ctls.
+	  \throws openmpt::exception Throws an exception derived from openmpt::exception in case the provided file cannot be opened.
+	  \remarks The file is not accessed anymore after an openmpt::module has been constructed successfully, unless load.lazy_samples is set. In that case, the file stays memory mapped and must not be modified or truncated until the sample data has been decoded.
+	  \remarks The file must not be modified while the module is being constructed.
+	  \sa \ref libopenmpt_cpp_fileio
+	  \since 0.5.0
+	*/
+	module( const std::string & filename, std::ostream & log = std::clog, const std::map< std::string, std::string > & ctls = detail::initial_ctls_map() );
 	/*!
 	  \param data Data to load the module from.
 	  \param log Log where any warnings or errors are printed to. The lifetime of the reference has to be as long as the lifetime of the module instance.
@@ -485,6 +504,17 @@ public:
 	  \sa \ref libopenmpt_cpp_fileio
 	*/
 	module( const void * data, std::size_t size, std::ostream & log = std::clog, const std::map< std::string, std::string > & ctls = detail::initial_ctls_map() );
+	/*!
+	  \param other An already loaded module that is to be played a second time.
+	  \param log Log where any warnings or errors are printed to. The lifetime of the reference has to be as long as the lifetime of the module instance.
+	  \param ctls A map of initial ctl values, see openmpt::module::get_ctls. ctls that only affect loading are ignored.
+	  \throws openmpt::exception Throws an exception derived from openmpt::exception in case the module cannot be copied.
+	  \remarks The new module starts playback from the beginning of the song, independently of the playback state of the other module.
+	  \remarks The sample data is shared between both modules instead of being copied, which makes this considerably faster and cheaper than loading the module again. Either module can be destroyed first.
+	  \remarks Any remaining lazily loaded samples of the other module (see load.lazy_samples) are decoded. The other module must not be used by another thread while it is being copied.
+	  \since 0.5.0
+	*/
+	module( module & other, std::ostream & log, const std::map< std::string, std::string > & ctls = detail::initial_ctls_map() );
 	virtual ~module();
 public:
 
@@ -966,7 +996,11 @@ public:
 	           - load.skip_patterns: Set to "1" to avoid loading patterns into memory
 	           - load.skip_plugins: Set to "1" to avoid loading plugins
 	           - load.skip_subsongs_init: Set to "1" to avoid pre-initializing sub-songs. Skipping results in faster module loading but slower seeking.
+	           - load.lazy_samples: Set to "1" to decode sample data when a subsong is selected or the playback position is set instead of while loading. This speeds up loading modules that are only inspected and not played. Only has an effect for IT, MPTM, S3M and XM files that are loaded with openmpt::module::module(const std::string &) on systems where the file can be memory mapped. The file must not be modified or truncated until the sample data has been decoded. Setting it to "0" after loading decodes all remaining sample data. Reading audio never decodes sample data, so select a subsong, set the position or set this ctl to "0" before calling openmpt::module::read; samples that have not been decoded yet are not played.
+	           - load.threads: Set the number of threads that are used for decoding sample data while loading, including the loading thread. "1" (the default) decodes all samples on the loading thread. The loaded sample data does not depend on this setting. Has no effect if libopenmpt has been built without thread support.
+	           - load.subsongs_init_threads: Set the number of threads that are used for determining the durations of the sub-songs while loading, including the loading thread. Each sequence of a module with several sequences can be scanned on its own thread. "1" (the default) scans all sequences on the loading thread. The resulting sub-songs and their order do not depend on this setting. Has no effect if libopenmpt has been built without thread support.
 	           - seek.sync_samples: Set to "1" to sync sample playback when using openmpt::module::set_position_seconds or openmpt::module::set_position_order_row.
+	           - seek.index_interval: Interval in seconds between the playback state snapshots that are recorded while scanning sub-songs. Seeking resumes from the closest snapshot, so seeking cost does not grow with the seek position. Smaller values result in faster seeking but use more memory. Set to "0" to disable the seek index. The default is "10.0".
 	           - subsong: The current subsong. Setting it has identical semantics as openmpt::module::select_subsong(), getting it returns the currently selected subsong.
 	           - play.at_end: Chooses the behaviour when the end of song is reached:
 	                          - "fadeout": Fades the module out for a short while. Subsequent reads after the fadeout will return 0 rendered frames.
@@ -975,7 +1009,29 @@ public:
 	           - play.tempo_factor: Set a floating point tempo factor. "1.0" is the default tempo.
 	           - play.pitch_factor: Set a floating point pitch factor. "1.0" is the default pitch.
 	           - render.resampler.emulate_amiga: Set to "1" to enable the Amiga resampler for Amiga modules. This emulates the sound characteristics of the Paula chip and overrides the selected interpolation filter. Non-Amiga module formats are not affected by this setting. 
+	           - render.block_size: Maximum number of frames that are rendered at once internally. Larger values reduce per-block overhead when rendering offline, smaller values reduce the latency of parameter changes. Blocks are never larger than 512 frames while plugins are loaded. Valid values are 1 to 16384. The default is "512".
+	           - render.mixer.threads: Set the number of threads that are used for mixing sample voices, including the thread calling read. "1" (the default) mixes all voices on the calling thread. The rendered output does not depend on this setting. Has no effect if libopenmpt has been built without thread support.
+	           - render.skipped_silent_frames: Number of sample voice frames that were not mixed because only silent sample data would have been read. Skipping silent sample data does not change the rendered output. Set to "0" to reset the counter.
+	           - render.resample_cache.size: Maximum amount of memory in bytes that is used for caching resampled sample data. Voices that play the same sample at the same pitch with cubic, sinc or Kaiser interpolation share the cached data instead of running the interpolation again. The rendered output is identical to rendering without the cache. "0" disables the cache. The default is "0".
+	           - render.resample_cache.hits: Number of sample voice frames that were mixed from the resample cache. Set to "0" to reset both this counter and render.resample_cache.misses.
+	           - render.resample_cache.misses: Number of sample voice frames that could have used the resample cache but had to be resampled. Set to "0" to reset both this counter and render.resample_cache.hits.
+	           - render.deadline.budget: Time in microseconds that a single call to read may take. If rendering comes close to this budget, the resampling quality of the quietest voices is lowered to linear interpolation until rendering is fast enough again. "0" (the default) disables this behaviour, in which case the rendered output does not depend on the time it takes to render.
+	           - render.deadline.degradations: Number of times the resampling quality was lowered because rendering came close to the time budget set via render.deadline.budget. Set to "0" to reset the counter.
+	           - render.deadline.degraded_voices: Number of voices that are currently rendered with lowered resampling quality. This ctl is read-only.
+	           - render.max_voices: Maximum number of voices, i.e. pattern channels plus the background channels that keep playing notes after a new note has been triggered on the same pattern channel. Fewer voices need less memory and rendering time, but background notes may be cut earlier than in the original tracker. The limit is never lower than the number of pattern channels. Notes that are playing on voices beyond a newly set limit are cut. Valid values are 1 to 256. The default is "256".
 	           - render.opl.volume_factor: Set volume factor applied to synthesized OPL sounds, relative to the default OPL volume.
+	           - profile.read_calls: Number of calls to the read functions. All profile.* ctls are read-only counters that are collected while rendering; setting any of them to "0" resets all of them.
+	           - profile.read_ns: Total time in nanoseconds spent in the read functions.
+	           - profile.frames: Number of rendered frames.
+	           - profile.ticks: Number of processed module ticks.
+	           - profile.tick_ns: Time in nanoseconds spent processing pattern data and effects.
+	           - profile.mix_ns: Time in nanoseconds spent mixing sample voices.
+	           - profile.voices_mixed: Sum of the number of sample voices mixed in each internal render block.
+	           - profile.opl_ns: Time in nanoseconds spent synthesizing OPL sounds.
+	           - profile.reverb_ns: Time in nanoseconds spent in the reverb effect.
+	           - profile.plugins_ns: Time in nanoseconds spent in mix plugins.
+	           - profile.dsp_ns: Time in nanoseconds spent applying global volume, stereo separation and DSP effects.
+	           - profile.output_ns: Time in nanoseconds spent converting the rendered audio to the output format.
 	           - dither: Set the dither algorithm that is used for the 16 bit versions of openmpt::module::read. Supported values are:
 	                     - 0: No dithering.
 	                     - 1: Default mode. Chosen by OpenMPT code, might change.
@@ -1006,6 +1062,103 @@ public:
 
 }; // class module
 
+//! A module that is to be rendered by openmpt::render_batch
+/*!
+  \since 0.5.0
+*/
+struct batch_job {
+	//! Path of a local file from which the module is loaded. Only used if data is empty.
+	std::string filename;
+	//! Contents of the module file
+	std::vector<std::uint8_t> data;
+	//! Initial ctls, see openmpt::module::get_ctls
+	std::map< std::string, std::string > ctls;
+};
+
+//! Settings that apply to all jobs rendered by openmpt::render_batch
+/*!
+  \since 0.5.0
+*/
+struct batch_settings {
+	//! Sample rate in Hz
+	std::int32_t samplerate = 48000;
+	//! Number of interleaved output channels. Supported values are 1, 2 and 4.
+	int channels = 2;
+	//! Maximum number of frames that are passed to openmpt::batch_callback::render at once
+	std::size_t block_frames = 1024;
+	//! Repeat count of every module, see openmpt::module::set_repeat_count. Infinite repetition (-1) is not allowed.
+	std::int32_t repeat_count = 0;
+	//! Render parameters of every module, indexed by openmpt::module::render_param
+	std::map< int, std::int32_t > render_params;
+	//! Number of jobs that are processed concurrently. 0 uses one thread per available processor core.
+	std::size_t threads = 0;
+};
+
+//! Aggregate statistics returned by openmpt::render_batch
+/*!
+  \since 0.5.0
+*/
+struct batch_statistics {
+	//! Number of jobs
+	std::size_t jobs = 0;
+	//! Number of jobs that failed to load or render
+	std::size_t failed = 0;
+	//! Total number of rendered frames over all jobs
+	std::uint64_t frames = 0;
+	//! Wall clock time in seconds that the whole batch took
+	double seconds = 0.0;
+};
+
+//! Receives the results of openmpt::render_batch
+/*!
+  The member functions are called from several threads concurrently, but never concurrently for the same job.
+  For every job, openmpt::batch_callback::loaded, openmpt::batch_callback::render and openmpt::batch_callback::finished are called in this order.
+  Exceptions thrown by openmpt::batch_callback::loaded or openmpt::batch_callback::render make the job fail.
+  Exceptions thrown by openmpt::batch_callback::finished are rethrown by openmpt::render_batch once all jobs have finished.
+  \since 0.5.0
+*/
+class LIBOPENMPT_CXX_API batch_callback {
+public:
+	virtual ~batch_callback();
+	//! Called once the module has been loaded and its sub-songs have been scanned
+	/*!
+	  \param job Index of the job in the list passed to openmpt::render_batch.
+	  \param mod The loaded module. It can be used to query metadata or to select a sub-song before rendering. It is destroyed once the job has finished.
+	  \return false to skip rendering this job. The default implementation returns true.
+	*/
+	virtual bool loaded( std::size_t job, module & mod );
+	//! Called with every rendered block of audio
+	/*!
+	  \param job Index of the job in the list passed to openmpt::render_batch.
+	  \param interleaved Rendered audio data as interleaved floating point samples, normalized to [-1,1], with openmpt::batch_settings::channels channels.
+	  \param frames Number of frames in interleaved. Never more than openmpt::batch_settings::block_frames.
+	*/
+	virtual void render( std::size_t job, const float * interleaved, std::size_t frames ) = 0;
+	//! Called once a job has finished, whether it succeeded or not
+	/*!
+	  \param job Index of the job in the list passed to openmpt::render_batch.
+	  \param error Error message if the job failed, or an empty string if it succeeded.
+	  \param log Everything the module has logged while loading and rendering.
+	  \remarks The default implementation does nothing.
+	*/
+	virtual void finished( std::size_t job, const std::string & error, const std::string & log );
+}; // class batch_callback
+
+//! Load and render a list of modules concurrently
+/*!
+  Each job is loaded, scanned and rendered to the end of its selected sub-song on one of openmpt::batch_settings::threads threads.
+  Idle threads pick up the next job that has not been started yet, so long and short modules are balanced automatically.
+  Read-only tables like the resampler tables are shared between all modules.
+  \param jobs Modules to render.
+  \param settings Render settings that apply to all jobs.
+  \param callback Receives the loaded modules and the rendered audio.
+  \return Statistics about the whole batch. Failing jobs do not stop the batch; they are reported via openmpt::batch_callback::finished and counted in openmpt::batch_statistics::failed.
+  \throws openmpt::exception Throws an exception derived from openmpt::exception if the settings are invalid.
+  \remarks Without thread support, all jobs are processed on the calling thread.
+  \since 0.5.0
+*/
+LIBOPENMPT_CXX_API batch_statistics render_batch( const std::vector<batch_job> & jobs, const batch_settings & settings, batch_callback & callback );
+
 } // namespace openmpt
 
 /*!
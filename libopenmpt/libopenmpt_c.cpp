@@ -607,6 +607,96 @@ openmpt_module * openmpt_module_create_from_memory2( const void * filedata, size
 	return NULL;
 }
 
+openmpt_module * openmpt_module_create_from_file( const char * filename, openmpt_log_func logfunc, void * loguser, openmpt_error_func errfunc, void * erruser, int * error, const char * * error_message, const openmpt_module_initial_ctl * ctls ) {
+	try {
+		openmpt::interface::check_pointer( filename );
+		openmpt_module * mod = (openmpt_module*)std::calloc( 1, sizeof( openmpt_module ) );
+		if ( !mod ) {
+			throw std::bad_alloc();
+		}
+		std::memset( mod, 0, sizeof( openmpt_module ) );
+		mod->logfunc = logfunc ? logfunc : openmpt_log_func_default;
+		mod->loguser = loguser;
+		mod->errfunc = errfunc ? errfunc : NULL;
+		mod->erruser = erruser;
+		mod->error = OPENMPT_ERROR_OK;
+		mod->error_message = NULL;
+		mod->impl = 0;
+		try {
+			std::map< std::string, std::string > ctls_map;
+			if ( ctls ) {
+				for ( const openmpt_module_initial_ctl * it = ctls; it->ctl; ++it ) {
+					if ( it->value ) {
+						ctls_map[ it->ctl ] = it->value;
+					} else {
+						ctls_map.erase( it->ctl );
+					}
+				}
+			}
+			mod->impl = new openmpt::module_impl( std::string( filename ), openmpt::helper::make_unique<openmpt::logfunc_logger>( mod->logfunc, mod->loguser ), ctls_map );
+			return mod;
+		} catch ( ... ) {
+			openmpt::report_exception( __FUNCTION__, mod, error, error_message );
+		}
+		delete mod->impl;
+		mod->impl = 0;
+		if ( mod->error_message ) {
+			openmpt_free_string( mod->error_message );
+			mod->error_message = NULL;
+		}
+		std::free( (void*)mod );
+		mod = NULL;
+	} catch ( ... ) {
+		openmpt::report_exception( __FUNCTION__, 0, error, error_message );
+	}
+	return NULL;
+}
+
+openmpt_module * openmpt_module_create_copy( openmpt_module * other, openmpt_log_func logfunc, void * loguser, openmpt_error_func errfunc, void * erruser, int * error, const char * * error_message, const openmpt_module_initial_ctl * ctls ) {
+	try {
+		openmpt::interface::check_soundfile( other );
+		openmpt_module * mod = (openmpt_module*)std::calloc( 1, sizeof( openmpt_module ) );
+		if ( !mod ) {
+			throw std::bad_alloc();
+		}
+		std::memset( mod, 0, sizeof( openmpt_module ) );
+		mod->logfunc = logfunc ? logfunc : openmpt_log_func_default;
+		mod->loguser = loguser;
+		mod->errfunc = errfunc ? errfunc : NULL;
+		mod->erruser = erruser;
+		mod->error = OPENMPT_ERROR_OK;
+		mod->error_message = NULL;
+		mod->impl = 0;
+		try {
+			std::map< std::string, std::string > ctls_map;
+			if ( ctls ) {
+				for ( const openmpt_module_initial_ctl * it = ctls; it->ctl; ++it ) {
+					if ( it->value ) {
+						ctls_map[ it->ctl ] = it->value;
+					} else {
+						ctls_map.erase( it->ctl );
+					}
+				}
+			}
+			mod->impl = new openmpt::module_impl( *other->impl, openmpt::helper::make_unique<openmpt::logfunc_logger>( mod->logfunc, mod->loguser ), ctls_map );
+			return mod;
+		} catch ( ... ) {
+			openmpt::report_exception( __FUNCTION__, mod, error, error_message );
+		}
+		delete mod->impl;
+		mod->impl = 0;
+		if ( mod->error_message ) {
+			openmpt_free_string( mod->error_message );
+			mod->error_message = NULL;
+		}
+		std::free( (void*)mod );
+		mod = NULL;
+	} catch ( ... ) {
+		openmpt::report_exception( __FUNCTION__, 0, error, error_message );
+	}
+	return NULL;
+}
+
 void openmpt_module_destroy( openmpt_module * mod ) {
 	try {
 		openmpt::interface::check_soundfile( mod );
@@ -16,7 +16,13 @@
 #include "libopenmpt_impl.hpp"
 #include "libopenmpt_ext_impl.hpp"
 
+#include "common/mptThreadPool.h"
+
 #include <algorithm>
+#include <chrono>
+#include <exception>
+#include <memory>
+#include <sstream>
 #include <stdexcept>
 
 #include <cstdlib>
@@ -177,6 +183,10 @@ module::module( std::istream & stream, std::ostream & log, const std::map< std::
 	impl = new module_impl( stream, openmpt::helper::make_unique<std_ostream_log>( log ), ctls );
 }
 
+module::module( const std::string & filename, std::ostream & log, const std::map< std::string, std::string > & ctls ) : impl(0) {
+	impl = new module_impl( filename, openmpt::helper::make_unique<std_ostream_log>( log ), ctls );
+}
+
 module::module( const std::vector<std::uint8_t> & data, std::ostream & log, const std::map< std::string, std::string > & ctls ) : impl(0) {
 	impl = new module_impl( data, openmpt::helper::make_unique<std_ostream_log>( log ), ctls );
 }
@@ -205,6 +215,10 @@ module::module( const void * data, std::size_t size, std::ostream & log, const s
 	impl = new module_impl( data, size, openmpt::helper::make_unique<std_ostream_log>( log ), ctls );
 }
 
+module::module( module & other, std::ostream & log, const std::map< std::string, std::string > & ctls ) : impl(0) {
+	impl = new module_impl( *other.impl, openmpt::helper::make_unique<std_ostream_log>( log ), ctls );
+}
+
 module::~module() {
 	delete impl;
 	impl = 0;
@@ -433,6 +447,129 @@ void * module_ext::get_interface( const std::string & interface_id ) {
 	return ext_impl->get_interface( interface_id );
 }
 
+batch_callback::~batch_callback() {
+	return;
+}
+
+bool batch_callback::loaded( std::size_t /* job */ , module & /* mod */ ) {
+	return true;
+}
+
+void batch_callback::finished( std::size_t /* job */ , const std::string & /* error */ , const std::string & /* log */ ) {
+	return;
+}
+
+namespace {
+
+struct batch_job_result {
+	std::uint64_t frames = 0;
+	bool failed = false;
+};
+
+batch_job_result render_batch_job( const batch_job & job, std::size_t index, const batch_settings & settings, batch_callback & callback ) {
+	batch_job_result result;
+	std::ostringstream log;
+	std::string error;
+	try {
+		std::unique_ptr<module> mod;
+		if ( job.data.empty() ) {
+			mod = openmpt::helper::make_unique<module>( job.filename, log, job.ctls );
+		} else {
+			mod = openmpt::helper::make_unique<module>( job.data, log, job.ctls );
+		}
+		mod->set_repeat_count( settings.repeat_count );
+		for ( const auto & param : settings.render_params ) {
+			mod->set_render_param( param.first, param.second );
+		}
+		if ( callback.loaded( index, *mod ) ) {
+			std::vector<float> buffer( settings.block_frames * settings.channels );
+			while ( true ) {
+				std::size_t count = 0;
+				switch ( settings.channels ) {
+					case 1:
+						count = mod->read( settings.samplerate, settings.block_frames, buffer.data() );
+						break;
+					case 2:
+						count = mod->read_interleaved_stereo( settings.samplerate, settings.block_frames, buffer.data() );
+						break;
+					case 4:
+						count = mod->read_interleaved_quad( settings.samplerate, settings.block_frames, buffer.data() );
+						break;
+				}
+				if ( count == 0 ) {
+					break;
+				}
+				callback.render( index, buffer.data(), count );
+				result.frames += count;
+			}
+		}
+	} catch ( const std::exception & e ) {
+		error = ( e.what() && *e.what() ) ? e.what() : "unknown error";
+	} catch ( ... ) {
+		error = "unknown error";
+	}
+	result.failed = !error.empty();
+	callback.finished( index, error, log.str() );
+	return result;
+}
+
+} // namespace
+
+batch_statistics render_batch( const std::vector<batch_job> & jobs, const batch_settings & settings, batch_callback & callback ) {
+	if ( settings.channels != 1 && settings.channels != 2 && settings.channels != 4 ) {
+		throw openmpt::exception( "invalid number of channels" );
+	}
+	if ( settings.block_frames == 0 ) {
+		throw openmpt::exception( "invalid block size" );
+	}
+	if ( settings.repeat_count < 0 ) {
+		throw openmpt::exception( "infinite repeat count" );
+	}
+	const auto start = std::chrono::steady_clock::now();
+	std::vector<batch_job_result> results( jobs.size() );
+	const auto run_job = [&]( std::size_t index ) {
+		results[index] = render_batch_job( jobs[index], index, settings, callback );
+	};
+	bool processed = false;
+#if defined(MPT_ENABLE_THREAD)
+	std::size_t num_threads = settings.threads;
+	if ( num_threads == 0 ) {
+		num_threads = std::max( static_cast<std::size_t>( std::thread::hardware_concurrency() ), std::size_t( 1 ) );
+	}
+	num_threads = std::min( num_threads, jobs.size() );
+	if ( num_threads > 1 ) {
+		OpenMPT::mpt::ThreadPool( num_threads ).Run( jobs.size(), run_job );
+		processed = true;
+	}
+#endif // MPT_ENABLE_THREAD
+	if ( !processed ) {
+		// same semantics as the thread pool: finish all jobs, then rethrow the first exception
+		std::exception_ptr exception;
+		for ( std::size_t index = 0; index < jobs.size(); ++index ) {
+			try {
+				run_job( index );
+			} catch ( ... ) {
+				if ( !exception ) {
+					exception = std::current_exception();
+				}
+			}
+		}
+		if ( exception ) {
+			std::rethrow_exception( exception );
+		}
+	}
+	batch_statistics statistics;
+	statistics.jobs = jobs.size();
+	for ( const auto & result : results ) {
+		statistics.frames += result.frames;
+		if ( result.failed ) {
+			statistics.failed++;
+		}
+	}
+	statistics.seconds = std::chrono::duration<double>( std::chrono::steady_clock::now() - start ).count();
+	return statistics;
+}
+
 } // namespace openmpt
 
 #endif // NO_LIBOPENMPT_CXX
@@ -191,7 +191,7 @@ namespace openmpt {
 		m_sndFile->m_PlayState.Chn[channel].dwFlags.set( CHN_MUTE | CHN_SYNCMUTE , mute );
 
 		// Also update NNA channels
-		for ( CHANNELINDEX i = m_sndFile->GetNumChannels(); i < MAX_CHANNELS; i++)
+		for ( CHANNELINDEX i = m_sndFile->GetNumChannels(); i < m_sndFile->GetNumVoices(); i++)
 		{
 			if ( m_sndFile->m_PlayState.Chn[i].nMasterChn == channel + 1)
 			{
@@ -249,10 +249,14 @@ namespace openmpt {
 			throw openmpt::exception("invalid note");
 		}
 
+		if ( m_sndFile->GetNumVoices() <= get_num_channels() ) {
+			throw openmpt::exception("no free channel");
+		}
+
 		// Find a free channel
-		CHANNELINDEX free_channel = MAX_CHANNELS - 1;
+		CHANNELINDEX free_channel = m_sndFile->GetNumVoices() - 1;
 		// Search for available channel
-		for(CHANNELINDEX i = MAX_CHANNELS - 1; i >= get_num_channels(); i--)
+		for(CHANNELINDEX i = m_sndFile->GetNumVoices() - 1; i >= get_num_channels(); i--)
 		{
 			const ModChannel &chn = m_sndFile->m_PlayState.Chn[i];
 			if ( chn.nLength == 0 ) {
@@ -289,7 +293,7 @@ namespace openmpt {
 	}
 
 	void module_ext_impl::stop_note( std::int32_t channel ) {
-		if ( channel < 0 || channel >= MAX_CHANNELS ) {
+		if ( channel < 0 || channel >= m_sndFile->GetNumVoices() ) {
 			throw openmpt::exception("invalid channel");
 		}
 		ModChannel &chn = m_sndFile->m_PlayState.Chn[channel];
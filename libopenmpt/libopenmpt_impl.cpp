@@ -15,6 +15,8 @@
 #include "libopenmpt_impl.hpp"
 
 #include <algorithm>
+#include <chrono>
+#include <fstream>
 #include <iostream>
 #include <istream>
 #include <iterator>
@@ -30,6 +32,7 @@
 #include "common/FileReader.h"
 #include "common/Logging.h"
 #include "common/mptMutex.h"
+#include "common/mptThreadPool.h"
 #include "soundlib/Sndfile.h"
 #include "soundlib/mod_specifications.h"
 #include "soundlib/AudioReadTarget.h"
@@ -335,6 +338,10 @@ static ResamplingMode filterlength_to_resamplingmode(std::int32_t length) {
 	ResamplingMode result = SRCMODE_SINC8LP;
 	if ( length == 0 ) {
 		result = SRCMODE_SINC8LP;
+	} else if ( length >= 32 ) {
+		result = SRCMODE_SINC32;
+	} else if ( length >= 16 ) {
+		result = SRCMODE_SINC16;
 	} else if ( length >= 8 ) {
 		result = SRCMODE_SINC8LP;
 	} else if ( length >= 3 ) {
@@ -363,6 +370,10 @@ static std::int32_t resamplingmode_to_filterlength(ResamplingMode mode) {
 	case SRCMODE_SINC8LP:
 	case SRCMODE_DEFAULT:
 		return 8;
+	case SRCMODE_SINC16:
+		return 16;
+	case SRCMODE_SINC32:
+		return 32;
 	default:
 		throw openmpt::exception("unknown interpolation filter length set internally");
 		break;
@@ -422,12 +433,43 @@ void module_impl::apply_libopenmpt_defaults() {
 }
 module_impl::subsongs_type module_impl::get_subsongs() const {
 	std::vector<subsong_data> subsongs;
-	if ( m_sndFile->Order.GetNumSequences() == 0 ) {
+	const SEQUENCEINDEX num_sequences = m_sndFile->Order.GetNumSequences();
+	if ( num_sequences == 0 ) {
 		throw openmpt::exception("module contains no songs");
 	}
-	for ( SEQUENCEINDEX seq = 0; seq < m_sndFile->Order.GetNumSequences(); ++seq ) {
-		const std::vector<GetLengthType> lengths = m_sndFile->GetLength( eNoAdjust, GetLengthTarget( true ).StartPos( seq, 0, 0 ) );
-		for ( const auto & l : lengths ) {
+	std::vector<std::vector<GetLengthType> > lengths( num_sequences );
+	bool scanned = false;
+#if defined(MPT_ENABLE_THREAD)
+	const std::size_t num_threads = std::min( static_cast<std::size_t>( m_ctl_load_subsongs_init_threads ), static_cast<std::size_t>( num_sequences ) );
+	// A seek index that already contains snapshots would make the scans depend on each other, so only scan in parallel while it is empty.
+	if ( num_threads > 1 && ( !m_seekIndex || m_seekIndex->GetNumCheckpoints() == 0 ) ) {
+		// Each scan records its snapshots in its own seek index. They are merged in sequence order afterwards,
+		// which results in the same seek index as scanning one sequence after another.
+		std::vector<std::unique_ptr<GetLengthSeekIndex> > seek_indices( num_sequences );
+		if ( m_seekIndex ) {
+			for ( auto & seek_index : seek_indices ) {
+				seek_index = mpt::make_unique<GetLengthSeekIndex>( m_seekIndex->GetInterval() );
+			}
+		}
+		const CSoundFile & sndFile = *m_sndFile;
+		mpt::ThreadPool( num_threads ).Run( num_sequences, [&]( std::size_t seq ) {
+			lengths[seq] = sndFile.ScanLength( GetLengthTarget( true ).StartPos( static_cast<SEQUENCEINDEX>( seq ), 0, 0 ), seek_indices[seq].get() );
+		} );
+		if ( m_seekIndex ) {
+			for ( auto & seek_index : seek_indices ) {
+				m_seekIndex->Append( *seek_index );
+			}
+		}
+		scanned = true;
+	}
+#endif // MPT_ENABLE_THREAD
+	if ( !scanned ) {
+		for ( SEQUENCEINDEX seq = 0; seq < num_sequences; ++seq ) {
+			lengths[seq] = m_sndFile->GetLength( eNoAdjust, GetLengthTarget( true ).StartPos( seq, 0, 0 ), m_seekIndex.get() );
+		}
+	}
+	for ( SEQUENCEINDEX seq = 0; seq < num_sequences; ++seq ) {
+		for ( const auto & l : lengths[seq] ) {
 			subsongs.push_back( subsong_data( l.duration, l.startRow, l.startOrder, seq ) );
 		}
 	}
@@ -439,6 +481,13 @@ void module_impl::init_subsongs( subsongs_type & subsongs ) const {
 bool module_impl::has_subsongs_inited() const {
 	return !m_subsongs.empty();
 }
+void module_impl::init_seek_index() {
+	if ( m_ctl_seek_index_interval > 0.0 ) {
+		m_seekIndex = mpt::make_unique<GetLengthSeekIndex>( m_ctl_seek_index_interval );
+	} else {
+		m_seekIndex = nullptr;
+	}
+}
 void module_impl::ctor( const std::map< std::string, std::string > & ctls ) {
 	m_sndFile = mpt::make_unique<CSoundFile>();
 	m_loaded = false;
@@ -454,19 +503,28 @@ void module_impl::ctor( const std::map< std::string, std::string > & ctls ) {
 	m_ctl_load_skip_patterns = false;
 	m_ctl_load_skip_plugins = false;
 	m_ctl_load_skip_subsongs_init = false;
+	m_ctl_load_lazy_samples = false;
+	m_ctl_load_subsongs_init_threads = 1;
 	m_ctl_seek_sync_samples = false;
+	m_ctl_seek_index_interval = 10.0;
+	m_profile_read_calls = 0;
+	m_profile_read_ns = 0;
 	// init member variables that correspond to ctls
 	for ( const auto & ctl : ctls ) {
 		ctl_set( ctl.first, ctl.second, false );
 	}
 }
-void module_impl::load( const FileReader & file, const std::map< std::string, std::string > & ctls ) {
+void module_impl::load( const FileReader & file, const std::map< std::string, std::string > & ctls, bool file_outlives_module ) {
 	loader_log loaderlog;
 	m_sndFile->SetCustomLog( &loaderlog );
 	{
 		int load_flags = CSoundFile::loadCompleteModule;
 		if ( m_ctl_load_skip_samples ) {
 			load_flags &= ~CSoundFile::loadSampleData;
+		} else if ( m_ctl_load_lazy_samples && file_outlives_module ) {
+			// Deferred sample data is read after loading, which is only possible if the file data stays available (memory-mapped files).
+			// The caller's data or stream may be gone by then, and copying it would waste more memory than deferring saves.
+			load_flags |= CSoundFile::deferSampleData;
 		}
 		if ( m_ctl_load_skip_patterns ) {
 			load_flags &= ~CSoundFile::loadPatternData;
@@ -477,6 +535,7 @@ void module_impl::load( const FileReader & file, const std::map< std::string, st
 		if ( !m_sndFile->Create( file, static_cast<CSoundFile::ModLoadingFlags>( load_flags ) ) ) {
 			throw openmpt::exception("error loading file");
 		}
+		init_seek_index();
 		if ( !m_ctl_load_skip_subsongs_init ) {
 			init_subsongs( m_subsongs );
 		}
@@ -497,6 +556,7 @@ bool module_impl::is_loaded() const {
 	return m_loaded;
 }
 std::size_t module_impl::read_wrapper( std::size_t count, std::int16_t * left, std::int16_t * right, std::int16_t * rear_left, std::int16_t * rear_right ) {
+	const auto read_start = std::chrono::steady_clock::now();
 	m_sndFile->ResetMixStat();
 	m_sndFile->m_bIsRendering = ( m_ctl_play_at_end != song_end_action::fadeout_song );
 	std::size_t count_read = 0;
@@ -517,9 +577,12 @@ std::size_t module_impl::read_wrapper( std::size_t count, std::int16_t * left, s
 		// This is the song end, but allow the song or loop to restart on the next call
 		m_sndFile->m_SongFlags.reset(SONG_ENDREACHED);
 	}
+	m_profile_read_calls++;
+	m_profile_read_ns += static_cast<std::uint64_t>( std::chrono::duration_cast<std::chrono::nanoseconds>( std::chrono::steady_clock::now() - read_start ).count() );
 	return count_read;
 }
 std::size_t module_impl::read_wrapper( std::size_t count, float * left, float * right, float * rear_left, float * rear_right ) {
+	const auto read_start = std::chrono::steady_clock::now();
 	m_sndFile->ResetMixStat();
 	m_sndFile->m_bIsRendering = ( m_ctl_play_at_end != song_end_action::fadeout_song );
 	std::size_t count_read = 0;
@@ -540,9 +603,12 @@ std::size_t module_impl::read_wrapper( std::size_t count, float * left, float *
 		// This is the song end, but allow the song or loop to restart on the next call
 		m_sndFile->m_SongFlags.reset(SONG_ENDREACHED);
 	}
+	m_profile_read_calls++;
+	m_profile_read_ns += static_cast<std::uint64_t>( std::chrono::duration_cast<std::chrono::nanoseconds>( std::chrono::steady_clock::now() - read_start ).count() );
 	return count_read;
 }
 std::size_t module_impl::read_interleaved_wrapper( std::size_t count, std::size_t channels, std::int16_t * interleaved ) {
+	const auto read_start = std::chrono::steady_clock::now();
 	m_sndFile->ResetMixStat();
 	m_sndFile->m_bIsRendering = ( m_ctl_play_at_end != song_end_action::fadeout_song );
 	std::size_t count_read = 0;
@@ -562,9 +628,12 @@ std::size_t module_impl::read_interleaved_wrapper( std::size_t count, std::size_
 		// This is the song end, but allow the song or loop to restart on the next call
 		m_sndFile->m_SongFlags.reset(SONG_ENDREACHED);
 	}
+	m_profile_read_calls++;
+	m_profile_read_ns += static_cast<std::uint64_t>( std::chrono::duration_cast<std::chrono::nanoseconds>( std::chrono::steady_clock::now() - read_start ).count() );
 	return count_read;
 }
 std::size_t module_impl::read_interleaved_wrapper( std::size_t count, std::size_t channels, float * interleaved ) {
+	const auto read_start = std::chrono::steady_clock::now();
 	m_sndFile->ResetMixStat();
 	m_sndFile->m_bIsRendering = ( m_ctl_play_at_end != song_end_action::fadeout_song );
 	std::size_t count_read = 0;
@@ -584,6 +653,8 @@ std::size_t module_impl::read_interleaved_wrapper( std::size_t count, std::size_
 		// This is the song end, but allow the song or loop to restart on the next call
 		m_sndFile->m_SongFlags.reset(SONG_ENDREACHED);
 	}
+	m_profile_read_calls++;
+	m_profile_read_ns += static_cast<std::uint64_t>( std::chrono::duration_cast<std::chrono::nanoseconds>( std::chrono::steady_clock::now() - read_start ).count() );
 	return count_read;
 }
 
@@ -838,6 +909,24 @@ module_impl::module_impl( std::istream & stream, std::unique_ptr<log_interface>
 	load( make_FileReader( &stream ), ctls );
 	apply_libopenmpt_defaults();
 }
+module_impl::module_impl( const std::string & filename, std::unique_ptr<log_interface> log, const std::map< std::string, std::string > & ctls ) : m_Log(std::move(log)) {
+	ctor( ctls );
+#if defined(MPT_FILEREADER_MMAP_POSIX)
+	std::shared_ptr<const FileDataContainerMappedFile> mapped = std::make_shared<FileDataContainerMappedFile>( filename.c_str() );
+	if ( mapped->IsValid() ) {
+		load( FileReader( mapped ), ctls, true );
+		apply_libopenmpt_defaults();
+		return;
+	}
+#endif // MPT_FILEREADER_MMAP_POSIX
+	// Fall back to reading the file as a stream if it cannot be mapped.
+	std::ifstream stream( filename, std::ios::binary );
+	if ( !stream ) {
+		throw exception( "cannot open file" );
+	}
+	load( make_FileReader( &stream ), ctls );
+	apply_libopenmpt_defaults();
+}
 module_impl::module_impl( const std::vector<std::uint8_t> & data, std::unique_ptr<log_interface> log, const std::map< std::string, std::string > & ctls ) : m_Log(std::move(log)) {
 	ctor( ctls );
 	load( make_FileReader( mpt::as_span( data ) ), ctls );
@@ -863,6 +952,28 @@ module_impl::module_impl( const void * data, std::size_t size, std::unique_ptr<l
 	load( make_FileReader( mpt::as_span( mpt::void_cast< const mpt::byte * >( data ), size ) ), ctls );
 	apply_libopenmpt_defaults();
 }
+module_impl::module_impl( module_impl & other, std::unique_ptr<log_interface> log, const std::map< std::string, std::string > & ctls ) : m_Log(std::move(log)) {
+	ctor( ctls );
+	if ( !other.m_loaded ) {
+		throw openmpt::exception("module not loaded");
+	}
+	if ( !m_sndFile->CreateSharedCopy( *other.m_sndFile ) ) {
+		throw openmpt::exception("error copying module");
+	}
+	init_seek_index();
+	if ( other.has_subsongs_inited() ) {
+		m_subsongs = other.m_subsongs;
+	} else if ( !m_ctl_load_skip_subsongs_init ) {
+		init_subsongs( m_subsongs );
+	}
+	m_loaded = true;
+	m_loaderMessages = other.m_loaderMessages;
+	// init CSoundFile state that corresponds to ctls
+	for ( const auto & ctl : ctls ) {
+		ctl_set( ctl.first, ctl.second, false );
+	}
+	apply_libopenmpt_defaults();
+}
 module_impl::~module_impl() {
 	m_sndFile->Destroy();
 }
@@ -1052,6 +1163,8 @@ double module_impl::get_position_seconds() const {
 	return m_currentPositionSeconds;
 }
 double module_impl::set_position_seconds( double seconds ) {
+	// Seeking prepares playback, and read() never decodes sample data (see load.lazy_samples).
+	m_sndFile->DecodeDeferredSamples();
 	std::unique_ptr<subsongs_type> subsongs_temp = has_subsongs_inited() ?  std::unique_ptr<subsongs_type>() : mpt::make_unique<subsongs_type>( get_subsongs() );
 	const subsongs_type & subsongs = has_subsongs_inited() ? m_subsongs : *subsongs_temp;
 	const subsong_data * subsong = 0;
@@ -1070,14 +1183,16 @@ double module_impl::set_position_seconds( double seconds ) {
 	} else {
 		subsong = &subsongs[m_current_subsong];
 	}
-	GetLengthType t = m_sndFile->GetLength( eNoAdjust, GetLengthTarget( seconds ).StartPos( static_cast<SEQUENCEINDEX>( subsong->sequence ), static_cast<ORDERINDEX>( subsong->start_order ), static_cast<ROWINDEX>( subsong->start_row ) ) ).back();
+	GetLengthType t = m_sndFile->GetLength( eNoAdjust, GetLengthTarget( seconds ).StartPos( static_cast<SEQUENCEINDEX>( subsong->sequence ), static_cast<ORDERINDEX>( subsong->start_order ), static_cast<ROWINDEX>( subsong->start_row ) ), m_seekIndex.get() ).back();
 	m_sndFile->m_PlayState.m_nCurrentOrder = t.lastOrder;
 	m_sndFile->SetCurrentOrder( t.lastOrder );
 	m_sndFile->m_PlayState.m_nNextRow = t.lastRow;
-	m_currentPositionSeconds = base_seconds + m_sndFile->GetLength( m_ctl_seek_sync_samples ? eAdjustSamplePositions : eAdjust, GetLengthTarget( t.lastOrder, t.lastRow ).StartPos( static_cast<SEQUENCEINDEX>( subsong->sequence ), static_cast<ORDERINDEX>( subsong->start_order ), static_cast<ROWINDEX>( subsong->start_row ) ) ).back().duration;
+	m_currentPositionSeconds = base_seconds + m_sndFile->GetLength( m_ctl_seek_sync_samples ? eAdjustSamplePositions : eAdjust, GetLengthTarget( t.lastOrder, t.lastRow ).StartPos( static_cast<SEQUENCEINDEX>( subsong->sequence ), static_cast<ORDERINDEX>( subsong->start_order ), static_cast<ROWINDEX>( subsong->start_row ) ), m_seekIndex.get() ).back().duration;
 	return m_currentPositionSeconds;
 }
 double module_impl::set_position_order_row( std::int32_t order, std::int32_t row ) {
+	// Seeking prepares playback, and read() never decodes sample data (see load.lazy_samples).
+	m_sndFile->DecodeDeferredSamples();
 	if ( order < 0 || order >= m_sndFile->Order().GetLengthTailTrimmed() ) {
 		return m_currentPositionSeconds;
 	}
@@ -1092,7 +1207,7 @@ double module_impl::set_position_order_row( std::int32_t order, std::int32_t row
 	m_sndFile->m_PlayState.m_nCurrentOrder = static_cast<ORDERINDEX>( order );
 	m_sndFile->SetCurrentOrder( static_cast<ORDERINDEX>( order ) );
 	m_sndFile->m_PlayState.m_nNextRow = static_cast<ROWINDEX>( row );
-	m_currentPositionSeconds = m_sndFile->GetLength( m_ctl_seek_sync_samples ? eAdjustSamplePositions : eAdjust, GetLengthTarget( static_cast<ORDERINDEX>( order ), static_cast<ROWINDEX>( row ) ) ).back().duration;
+	m_currentPositionSeconds = m_sndFile->GetLength( m_ctl_seek_sync_samples ? eAdjustSamplePositions : eAdjust, GetLengthTarget( static_cast<ORDERINDEX>( order ), static_cast<ROWINDEX>( row ) ), m_seekIndex.get() ).back().duration;
 	return m_currentPositionSeconds;
 }
 std::vector<std::string> module_impl::get_metadata_keys() const {
@@ -1517,13 +1632,39 @@ std::vector<std::string> module_impl::get_ctls() const {
 		"load.skip_patterns",
 		"load.skip_plugins",
 		"load.skip_subsongs_init",
+		"load.lazy_samples",
+		"load.threads",
+		"load.subsongs_init_threads",
 		"seek.sync_samples",
+		"seek.index_interval",
 		"subsong",
 		"play.tempo_factor",
 		"play.pitch_factor",
 		"play.at_end",
 		"render.resampler.emulate_amiga",
+		"render.block_size",
+		"render.mixer.threads",
+		"render.skipped_silent_frames",
+		"render.resample_cache.size",
+		"render.resample_cache.hits",
+		"render.resample_cache.misses",
+		"render.deadline.budget",
+		"render.deadline.degradations",
+		"render.deadline.degraded_voices",
+		"render.max_voices",
 		"render.opl.volume_factor",
+		"profile.read_calls",
+		"profile.read_ns",
+		"profile.frames",
+		"profile.ticks",
+		"profile.tick_ns",
+		"profile.mix_ns",
+		"profile.voices_mixed",
+		"profile.opl_ns",
+		"profile.reverb_ns",
+		"profile.plugins_ns",
+		"profile.dsp_ns",
+		"profile.output_ns",
 		"dither",
 	};
 }
@@ -1549,8 +1690,16 @@ std::string module_impl::ctl_get( std::string ctl, bool throw_if_unknown ) const
 		return mpt::fmt::val( m_ctl_load_skip_plugins );
 	} else if ( ctl == "load.skip_subsongs_init" ) {
 		return mpt::fmt::val( m_ctl_load_skip_subsongs_init );
+	} else if ( ctl == "load.lazy_samples" ) {
+		return mpt::fmt::val( m_ctl_load_lazy_samples );
+	} else if ( ctl == "load.threads" ) {
+		return mpt::fmt::val( m_sndFile->GetNumLoadThreads() );
+	} else if ( ctl == "load.subsongs_init_threads" ) {
+		return mpt::fmt::val( m_ctl_load_subsongs_init_threads );
 	} else if ( ctl == "seek.sync_samples" ) {
 		return mpt::fmt::val( m_ctl_seek_sync_samples );
+	} else if ( ctl == "seek.index_interval" ) {
+		return mpt::fmt::val( m_ctl_seek_index_interval );
 	} else if ( ctl == "subsong" ) {
 		return mpt::fmt::val( get_selected_subsong() );
 	} else if ( ctl == "play.at_end" ) {
@@ -1577,8 +1726,52 @@ std::string module_impl::ctl_get( std::string ctl, bool throw_if_unknown ) const
 		return mpt::fmt::val( m_sndFile->m_nFreqFactor / 65536.0 );
 	} else if ( ctl == "render.resampler.emulate_amiga" ) {
 		return mpt::fmt::val( m_sndFile->m_Resampler.m_Settings.emulateAmiga );
+	} else if ( ctl == "render.mixer.threads" ) {
+		return mpt::fmt::val( m_sndFile->m_MixerSettings.NumMixThreads );
+	} else if ( ctl == "render.skipped_silent_frames" ) {
+		return mpt::fmt::val( m_sndFile->GetSilentFramesSkipped() );
+	} else if ( ctl == "render.resample_cache.size" ) {
+		return mpt::fmt::val( m_sndFile->m_MixerSettings.ResampleCacheSize );
+	} else if ( ctl == "render.resample_cache.hits" ) {
+		return mpt::fmt::val( m_sndFile->m_ResampleCache.hits );
+	} else if ( ctl == "render.resample_cache.misses" ) {
+		return mpt::fmt::val( m_sndFile->m_ResampleCache.misses );
+	} else if ( ctl == "render.deadline.budget" ) {
+		return mpt::fmt::val( m_sndFile->m_MixerSettings.RenderTimeBudgetMicroseconds );
+	} else if ( ctl == "render.deadline.degradations" ) {
+		return mpt::fmt::val( m_sndFile->GetQualityDegradations() );
+	} else if ( ctl == "render.deadline.degraded_voices" ) {
+		return mpt::fmt::val( m_sndFile->GetNumDegradedVoices() );
+	} else if ( ctl == "render.max_voices" ) {
+		return mpt::fmt::val( m_sndFile->GetMaxVoices() );
+	} else if ( ctl == "render.block_size" ) {
+		return mpt::fmt::val( m_sndFile->m_MixerSettings.RenderBlockSize );
 	} else if ( ctl == "render.opl.volume_factor" ) {
 		return mpt::fmt::val( static_cast<double>( m_sndFile->m_OPLVolumeFactor ) / static_cast<double>( m_sndFile->m_OPLVolumeFactorScale ) );
+	} else if ( ctl == "profile.read_calls" ) {
+		return mpt::fmt::val( m_profile_read_calls );
+	} else if ( ctl == "profile.read_ns" ) {
+		return mpt::fmt::val( m_profile_read_ns );
+	} else if ( ctl == "profile.frames" ) {
+		return mpt::fmt::val( m_sndFile->GetRenderProfile().frames );
+	} else if ( ctl == "profile.ticks" ) {
+		return mpt::fmt::val( m_sndFile->GetRenderProfile().calls[RenderProfile::stageReadNote] );
+	} else if ( ctl == "profile.tick_ns" ) {
+		return mpt::fmt::val( m_sndFile->GetRenderProfile().nanoseconds[RenderProfile::stageReadNote] );
+	} else if ( ctl == "profile.mix_ns" ) {
+		return mpt::fmt::val( m_sndFile->GetRenderProfile().nanoseconds[RenderProfile::stageMix] );
+	} else if ( ctl == "profile.voices_mixed" ) {
+		return mpt::fmt::val( m_sndFile->GetRenderProfile().voicesMixed );
+	} else if ( ctl == "profile.opl_ns" ) {
+		return mpt::fmt::val( m_sndFile->GetRenderProfile().nanoseconds[RenderProfile::stageOPL] );
+	} else if ( ctl == "profile.reverb_ns" ) {
+		return mpt::fmt::val( m_sndFile->GetRenderProfile().nanoseconds[RenderProfile::stageReverb] );
+	} else if ( ctl == "profile.plugins_ns" ) {
+		return mpt::fmt::val( m_sndFile->GetRenderProfile().nanoseconds[RenderProfile::stagePlugins] );
+	} else if ( ctl == "profile.dsp_ns" ) {
+		return mpt::fmt::val( m_sndFile->GetRenderProfile().nanoseconds[RenderProfile::stageDSP] );
+	} else if ( ctl == "profile.output_ns" ) {
+		return mpt::fmt::val( m_sndFile->GetRenderProfile().nanoseconds[RenderProfile::stageOutput] );
 	} else if ( ctl == "dither" ) {
 		return mpt::fmt::val( static_cast<int>( m_Dither->GetMode() ) );
 	} else {
@@ -1611,8 +1804,37 @@ void module_impl::ctl_set( std::string ctl, const std::string & value, bool thro
 		m_ctl_load_skip_plugins = ConvertStrTo<bool>( value );
 	} else if ( ctl == "load.skip_subsongs_init" ) {
 		m_ctl_load_skip_subsongs_init = ConvertStrTo<bool>( value );
+	} else if ( ctl == "load.lazy_samples" ) {
+		m_ctl_load_lazy_samples = ConvertStrTo<bool>( value );
+		if ( !m_ctl_load_lazy_samples && m_loaded ) {
+			// Prefetch all sample data that has not been decoded yet.
+			m_sndFile->DecodeDeferredSamples();
+		}
+	} else if ( ctl == "load.threads" ) {
+		int32 threads = ConvertStrTo<int32>( value );
+		if ( threads < 1 || threads > MAX_SAMPLES ) {
+			throw openmpt::exception("invalid number of load threads");
+		}
+		m_sndFile->SetNumLoadThreads( threads );
+	} else if ( ctl == "load.subsongs_init_threads" ) {
+		int32 threads = ConvertStrTo<int32>( value );
+		if ( threads < 1 || threads > MAX_SEQUENCES ) {
+			throw openmpt::exception("invalid number of subsong scanning threads");
+		}
+		m_ctl_load_subsongs_init_threads = threads;
 	} else if ( ctl == "seek.sync_samples" ) {
 		m_ctl_seek_sync_samples = ConvertStrTo<bool>( value );
+	} else if ( ctl == "seek.index_interval" ) {
+		double interval = ConvertStrTo<double>( value );
+		if ( interval < 0.0 ) {
+			throw openmpt::exception("invalid seek index interval");
+		}
+		if ( interval != m_ctl_seek_index_interval ) {
+			m_ctl_seek_index_interval = interval;
+			if ( is_loaded() ) {
+				init_seek_index();
+			}
+		}
 	} else if ( ctl == "subsong" ) {
 		select_subsong( ConvertStrTo<int32>( value ) );
 	} else if ( ctl == "play.at_end" ) {
@@ -1651,8 +1873,80 @@ void module_impl::ctl_set( std::string ctl, const std::string & value, bool thro
 		if ( newsettings != m_sndFile->m_Resampler.m_Settings ) {
 			m_sndFile->SetResamplerSettings( newsettings );
 		}
+	} else if ( ctl == "render.mixer.threads" ) {
+		int32 threads = ConvertStrTo<int32>( value );
+		if ( threads < 1 || threads > MAX_CHANNELS ) {
+			throw openmpt::exception("invalid number of mixer threads");
+		}
+		MixerSettings newsettings = m_sndFile->m_MixerSettings;
+		newsettings.NumMixThreads = threads;
+		if ( newsettings.NumMixThreads != m_sndFile->m_MixerSettings.NumMixThreads ) {
+			m_sndFile->SetMixerSettings( newsettings );
+		}
+	} else if ( ctl == "render.skipped_silent_frames" ) {
+		if ( ConvertStrTo<uint64>( value ) != 0 ) {
+			throw openmpt::exception("render.skipped_silent_frames can only be reset to 0");
+		}
+		m_sndFile->ResetSilentFramesSkipped();
+	} else if ( ctl == "render.resample_cache.size" ) {
+		int64 size = ConvertStrTo<int64>( value );
+		if ( size < 0 || size > std::numeric_limits<uint32>::max() ) {
+			throw openmpt::exception("invalid resample cache size");
+		}
+		MixerSettings newsettings = m_sndFile->m_MixerSettings;
+		newsettings.ResampleCacheSize = static_cast<uint32>( size );
+		if ( newsettings.ResampleCacheSize != m_sndFile->m_MixerSettings.ResampleCacheSize ) {
+			m_sndFile->SetMixerSettings( newsettings );
+		}
+	} else if ( ctl == "render.resample_cache.hits" || ctl == "render.resample_cache.misses" ) {
+		if ( ConvertStrTo<uint64>( value ) != 0 ) {
+			throw openmpt::exception(ctl + " can only be reset to 0");
+		}
+		m_sndFile->m_ResampleCache.ResetStatistics();
+	} else if ( ctl == "render.deadline.budget" ) {
+		int64 budget = ConvertStrTo<int64>( value );
+		if ( budget < 0 || budget > std::numeric_limits<uint32>::max() ) {
+			throw openmpt::exception("invalid render time budget");
+		}
+		MixerSettings newsettings = m_sndFile->m_MixerSettings;
+		newsettings.RenderTimeBudgetMicroseconds = static_cast<uint32>( budget );
+		if ( newsettings.RenderTimeBudgetMicroseconds != m_sndFile->m_MixerSettings.RenderTimeBudgetMicroseconds ) {
+			m_sndFile->SetMixerSettings( newsettings );
+		}
+	} else if ( ctl == "render.deadline.degradations" ) {
+		if ( ConvertStrTo<uint64>( value ) != 0 ) {
+			throw openmpt::exception("render.deadline.degradations can only be reset to 0");
+		}
+		m_sndFile->ResetQualityDegradations();
+	} else if ( ctl == "render.deadline.degraded_voices" ) {
+		throw openmpt::exception("render.deadline.degraded_voices is read-only");
+	} else if ( ctl == "render.max_voices" ) {
+		int32 voices = ConvertStrTo<int32>( value );
+		if ( voices < 1 || voices > MAX_CHANNELS ) {
+			throw openmpt::exception("invalid maximum number of voices");
+		}
+		m_sndFile->SetMaxVoices( static_cast<CHANNELINDEX>( voices ) );
+	} else if ( ctl == "render.block_size" ) {
+		int32 block_size = ConvertStrTo<int32>( value );
+		if ( block_size < 1 || block_size > MIXBUFFERSIZE_MAX ) {
+			throw openmpt::exception("invalid render block size");
+		}
+		MixerSettings newsettings = m_sndFile->m_MixerSettings;
+		newsettings.RenderBlockSize = block_size;
+		if ( newsettings.RenderBlockSize != m_sndFile->m_MixerSettings.RenderBlockSize ) {
+			m_sndFile->SetMixerSettings( newsettings );
+		}
 	} else if ( ctl == "render.opl.volume_factor" ) {
 		m_sndFile->m_OPLVolumeFactor = mpt::saturate_round<int32>( ConvertStrTo<double>( value ) * static_cast<double>( m_sndFile->m_OPLVolumeFactorScale ) );
+	} else if ( ctl == "profile.read_calls" || ctl == "profile.read_ns" || ctl == "profile.frames" || ctl == "profile.ticks"
+		|| ctl == "profile.tick_ns" || ctl == "profile.mix_ns" || ctl == "profile.voices_mixed" || ctl == "profile.opl_ns"
+		|| ctl == "profile.reverb_ns" || ctl == "profile.plugins_ns" || ctl == "profile.dsp_ns" || ctl == "profile.output_ns" ) {
+		if ( ConvertStrTo<uint64>( value ) != 0 ) {
+			throw openmpt::exception(ctl + " can only be reset to 0");
+		}
+		m_profile_read_calls = 0;
+		m_profile_read_ns = 0;
+		m_sndFile->ResetRenderProfile();
 	} else if ( ctl == "dither" ) {
 		int dither = ConvertStrTo<int>( value );
 		if ( dither < 0 || dither >= NumDitherModes ) {
@@ -31,6 +31,7 @@ class FileReader;
 } // namespace detail
 typedef detail::FileReader<FileReaderTraitsDefault> FileReader;
 class CSoundFile;
+class GetLengthSeekIndex;
 class Dither;
 } // namespace OpenMPT
 
@@ -95,6 +96,7 @@ protected:
 	std::int32_t m_current_subsong;
 	double m_currentPositionSeconds;
 	std::unique_ptr<OpenMPT::CSoundFile> m_sndFile;
+	std::unique_ptr<OpenMPT::GetLengthSeekIndex> m_seekIndex;
 	bool m_loaded;
 	bool m_mixer_initialized;
 	std::unique_ptr<OpenMPT::Dither> m_Dither;
@@ -105,7 +107,12 @@ protected:
 	bool m_ctl_load_skip_patterns;
 	bool m_ctl_load_skip_plugins;
 	bool m_ctl_load_skip_subsongs_init;
+	bool m_ctl_load_lazy_samples;
+	std::int32_t m_ctl_load_subsongs_init_threads;
 	bool m_ctl_seek_sync_samples;
+	double m_ctl_seek_index_interval;
+	std::uint64_t m_profile_read_calls;
+	std::uint64_t m_profile_read_ns;
 	std::vector<std::string> m_loaderMessages;
 public:
 	void PushToCSoundFileLog( const std::string & text ) const;
@@ -117,8 +124,9 @@ protected:
 	subsongs_type get_subsongs() const;
 	void init_subsongs( subsongs_type & subsongs ) const;
 	bool has_subsongs_inited() const;
+	void init_seek_index();
 	void ctor( const std::map< std::string, std::string > & ctls );
-	void load( const OpenMPT::FileReader & file, const std::map< std::string, std::string > & ctls );
+	void load( const OpenMPT::FileReader & file, const std::map< std::string, std::string > & ctls, bool file_outlives_module = false );
 	bool is_loaded() const;
 	std::size_t read_wrapper( std::size_t count, std::int16_t * left, std::int16_t * right, std::int16_t * rear_left, std::int16_t * rear_right );
 	std::size_t read_wrapper( std::size_t count, float * left, float * right, float * rear_left, float * rear_right );
@@ -142,11 +150,13 @@ public:
 	static int probe_file_header( std::uint64_t flags, callback_stream_wrapper stream );
 	module_impl( callback_stream_wrapper stream, std::unique_ptr<log_interface> log, const std::map< std::string, std::string > & ctls );
 	module_impl( std::istream & stream, std::unique_ptr<log_interface> log, const std::map< std::string, std::string > & ctls );
+	module_impl( const std::string & filename, std::unique_ptr<log_interface> log, const std::map< std::string, std::string > & ctls );
 	module_impl( const std::vector<std::uint8_t> & data, std::unique_ptr<log_interface> log, const std::map< std::string, std::string > & ctls );
 	module_impl( const std::vector<char> & data, std::unique_ptr<log_interface> log, const std::map< std::string, std::string > & ctls );
 	module_impl( const std::uint8_t * data, std::size_t size, std::unique_ptr<log_interface> log, const std::map< std::string, std::string > & ctls );
 	module_impl( const char * data, std::size_t size, std::unique_ptr<log_interface> log, const std::map< std::string, std::string > & ctls );
 	module_impl( const void * data, std::size_t size, std::unique_ptr<log_interface> log, const std::map< std::string, std::string > & ctls );
+	module_impl( module_impl & other, std::unique_ptr<log_interface> log, const std::map< std::string, std::string > & ctls );
 	~module_impl();
 public:
 	void select_subsong( std::int32_t subsong );
@@ -561,7 +561,7 @@ BOOL CModDoc::InitializeMod()
 			m_SndFile.Patterns.Insert(0, 64);
 		}
 
-		MemsetZero(m_SndFile.m_szNames);
+		m_SndFile.m_szNames.clear();
 
 		m_SndFile.m_PlayState.m_nMusicTempo.Set(125);
 		m_SndFile.m_nDefaultTempo.Set(125);
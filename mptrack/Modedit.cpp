@@ -250,7 +250,7 @@ CHANNELINDEX CModDoc::ReArrangeChannels(const std::vector<CHANNELINDEX> &newOrde
 			channel.Reset(ModChannel::resetTotal, m_SndFile, chn);
 	}
 
-	std::vector<ModChannel> chns(m_SndFile.m_PlayState.Chn, m_SndFile.m_PlayState.Chn + oldNumChannels);
+	std::vector<ModChannel> chns(m_SndFile.m_PlayState.Chn.begin(), m_SndFile.m_PlayState.Chn.begin() + oldNumChannels);
 	std::vector<ModChannelSettings> settings(m_SndFile.ChnSettings, m_SndFile.ChnSettings + oldNumChannels);
 	std::vector<BYTE> recordStates(oldNumChannels, 0);
 	auto chnMutePendings = m_SndFile.m_bChannelMuteTogglePending;
@@ -370,7 +370,7 @@ SAMPLEINDEX CModDoc::ReArrangeSamples(const std::vector<SAMPLEINDEX> &newOrder)
 
 	GetSampleUndo().RearrangeSamples(newIndex);
 
-	for(CHANNELINDEX c = 0; c < CountOf(m_SndFile.m_PlayState.Chn); c++)
+	for(CHANNELINDEX c = 0; c < m_SndFile.GetNumVoices(); c++)
 	{
 		ModChannel &chn = m_SndFile.m_PlayState.Chn[c];
 		for(SAMPLEINDEX i = 1; i <= oldNumSamples; i++)
@@ -38,18 +38,28 @@ static const char * const license =
 #include "openmpt123_config.hpp"
 
 #include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <deque>
+#include <exception>
 #include <fstream>
 #include <iomanip>
 #include <iostream>
 #include <iterator>
 #include <limits>
 #include <map>
+#include <memory>
 #include <random>
 #include <set>
 #include <sstream>
 #include <string>
 #include <vector>
+#if !defined(__DJGPP__)
+#include <condition_variable>
+#include <future>
+#include <mutex>
+#include <thread>
+#endif
 
 #include <cmath>
 #include <cstdint>
@@ -83,6 +93,7 @@ static const char * const license =
 #include <unistd.h>
 #include <sys/ioctl.h>
 #include <sys/poll.h>
+#include <sys/resource.h>
 #include <sys/stat.h>
 #include <sys/types.h>
 #endif
@@ -164,6 +175,181 @@ static void set_input_mode() {
 
 #endif
 
+#if !defined(__DJGPP__)
+
+// Runs a file output on its own thread, so that encoding overlaps with rendering.
+// write() copies each block into a queue and only waits while the queue holds max_blocks blocks.
+// Metadata goes through the same queue in order to keep its order relative to the audio data.
+class pipelined_audio_stream : public file_audio_stream_base {
+private:
+	enum block_type {
+		block_metadata,
+		block_updated_metadata,
+		block_float,
+		block_int16
+	};
+	struct block {
+		block_type type;
+		std::map<std::string,std::string> metadata;
+		std::vector<float> float_data;
+		std::vector<std::int16_t> int16_data;
+		std::size_t channels;
+		std::size_t frames;
+		block() : type(block_metadata), channels(0), frames(0) { }
+	};
+	file_audio_stream_base * impl;
+	std::ostream & log;
+	std::size_t max_blocks;
+	std::mutex queue_mutex;
+	std::condition_variable queue_changed;
+	std::deque<block> queue;
+	std::vector<block> free_blocks;
+	bool stop;
+	std::exception_ptr error;
+	bool error_reported;
+	std::thread worker;
+public:
+	// Takes ownership of impl.
+	pipelined_audio_stream( file_audio_stream_base * impl_, std::size_t max_blocks_, std::ostream & log_ )
+		: impl(impl_)
+		, log(log_)
+		, max_blocks(max_blocks_)
+		, stop(false)
+		, error_reported(false)
+	{
+		try {
+			worker = std::thread( [this]() { run(); } );
+		} catch ( ... ) {
+			delete impl;
+			impl = 0;
+			throw;
+		}
+	}
+	virtual ~pipelined_audio_stream() {
+		{
+			std::lock_guard<std::mutex> guard( queue_mutex );
+			stop = true;
+		}
+		queue_changed.notify_all();
+		worker.join();
+		if ( error && !error_reported ) {
+			try {
+				std::rethrow_exception( error );
+			} catch ( std::exception & e ) {
+				log << "error writing output: " << e.what() << std::endl;
+			} catch ( ... ) {
+				log << "unknown error writing output" << std::endl;
+			}
+		}
+		delete impl;
+		impl = 0;
+	}
+private:
+	block get_free_block() {
+		std::lock_guard<std::mutex> guard( queue_mutex );
+		if ( free_blocks.empty() ) {
+			return block();
+		}
+		block b = std::move( free_blocks.back() );
+		free_blocks.pop_back();
+		return b;
+	}
+	void push( block && b ) {
+		std::unique_lock<std::mutex> guard( queue_mutex );
+		queue_changed.wait( guard, [&]() { return queue.size() < max_blocks || error; } );
+		if ( error ) {
+			error_reported = true;
+			std::rethrow_exception( error );
+		}
+		queue.push_back( std::move( b ) );
+		guard.unlock();
+		queue_changed.notify_all();
+	}
+	void push_metadata( block_type type, const std::map<std::string,std::string> & metadata ) {
+		block b = get_free_block();
+		b.type = type;
+		b.metadata = metadata;
+		push( std::move( b ) );
+	}
+	template < typename Tsample >
+	void push_samples( block_type type, std::vector<Tsample> block::*data, const std::vector<Tsample*> & buffers, std::size_t frames ) {
+		block b = get_free_block();
+		b.type = type;
+		b.channels = buffers.size();
+		b.frames = frames;
+		std::vector<Tsample> & samples = b.*data;
+		samples.resize( b.channels * frames );
+		for ( std::size_t channel = 0; channel < b.channels; ++channel ) {
+			std::copy( buffers[channel], buffers[channel] + frames, samples.begin() + channel * frames );
+		}
+		push( std::move( b ) );
+	}
+	template < typename Tsample >
+	void write_samples( std::vector<Tsample> & samples, std::size_t channels, std::size_t frames ) {
+		std::vector<Tsample*> buffers( channels );
+		for ( std::size_t channel = 0; channel < channels; ++channel ) {
+			buffers[channel] = samples.data() + channel * frames;
+		}
+		impl->write( buffers, frames );
+	}
+	void process( block & b ) {
+		switch ( b.type ) {
+			case block_metadata:
+				impl->write_metadata( b.metadata );
+				break;
+			case block_updated_metadata:
+				impl->write_updated_metadata( b.metadata );
+				break;
+			case block_float:
+				write_samples( b.float_data, b.channels, b.frames );
+				break;
+			case block_int16:
+				write_samples( b.int16_data, b.channels, b.frames );
+				break;
+		}
+	}
+	void run() {
+		std::unique_lock<std::mutex> guard( queue_mutex );
+		while ( true ) {
+			queue_changed.wait( guard, [&]() { return !queue.empty() || stop; } );
+			if ( queue.empty() ) {
+				break;
+			}
+			block b = std::move( queue.front() );
+			queue.pop_front();
+			bool failed = error ? true : false;
+			guard.unlock();
+			if ( !failed ) {
+				try {
+					process( b );
+				} catch ( ... ) {
+					guard.lock();
+					error = std::current_exception();
+					guard.unlock();
+				}
+			}
+			guard.lock();
+			free_blocks.push_back( std::move( b ) );
+			queue_changed.notify_all();
+		}
+	}
+public:
+	void write_metadata( std::map<std::string,std::string> metadata ) override {
+		push_metadata( block_metadata, metadata );
+	}
+	void write_updated_metadata( std::map<std::string,std::string> metadata ) override {
+		push_metadata( block_updated_metadata, metadata );
+	}
+	void write( const std::vector<float*> buffers, std::size_t frames ) override {
+		push_samples( block_float, &block::float_data, buffers, frames );
+	}
+	void write( const std::vector<std::int16_t*> buffers, std::size_t frames ) override {
+		push_samples( block_int16, &block::int16_data, buffers, frames );
+	}
+};
+
+#endif // !__DJGPP__
+
 class file_audio_stream_raii : public file_audio_stream_base {
 private:
 	file_audio_stream_base * impl;
@@ -197,6 +383,11 @@ public:
 		if ( !impl ) {
 			throw exception( "file format handler '" + flags.output_extension + "' not found" );
 		}
+#if !defined(__DJGPP__)
+		if ( flags.output_queue > 0 ) {
+			impl = new pipelined_audio_stream( impl, flags.output_queue, log );
+		}
+#endif
 	}
 	virtual ~file_audio_stream_raii() {
 		if ( impl ) {
@@ -282,6 +473,12 @@ static std::ostream & operator << ( std::ostream & s, const commandlineflags & f
 	s << "Standard output: " << flags.use_stdout << std::endl;
 	s << "Output filename: " << flags.output_filename << std::endl;
 	s << "Force overwrite output file: " << flags.force_overwrite << std::endl;
+	s << "Prefetch: " << flags.prefetch << std::endl;
+	s << "Crossfade: " << flags.crossfade << "ms" << std::endl;
+	s << "Jobs: " << flags.jobs << std::endl;
+	s << "Output queue: " << flags.output_queue << std::endl;
+	s << "Benchmark JSON output: " << flags.benchmark_json << std::endl;
+	s << "Render hash reference: " << flags.hash_reference << std::endl;
 	s << "Ctls: " << ctls_to_string( flags.ctls ) << std::endl;
 	s << std::endl;
 	s << "Files: " << std::endl;
@@ -605,6 +802,8 @@ static void show_help( textout & log, bool with_info = true, bool longhelp = fal
 		log << "     --ui                   Interactively play each file" << std::endl;
 		log << "     --batch                Play each file" << std::endl;
 		log << "     --render               Render each file to individual PCM data files" << std::endl;
+		log << "     --benchmark            Render each file without output and report load and render timings" << std::endl;
+		log << "     --render-hash          Render each subsong of each file and write a manifest of output hashes to stdout" << std::endl;
 		if ( !longhelp ) {
 			log << std::endl;
 			log.writeout();
@@ -630,7 +829,7 @@ static void show_help( textout & log, bool with_info = true, bool longhelp = fal
 		log << std::endl;
 		log << "     --gain n               Set output gain to n dB [default: " << commandlineflags().gain / 100.0 << "]" << std::endl;
 		log << "     --stereo n             Set stereo separation to n % [default: " << commandlineflags().separation << "]" << std::endl;
-		log << "     --filter n             Set interpolation filter taps to n [1,2,4,8] [default: " << commandlineflags().filtertaps << "]" << std::endl;
+		log << "     --filter n             Set interpolation filter taps to n [1,2,4,8,16,32] [default: " << commandlineflags().filtertaps << "]" << std::endl;
 		log << "     --ramping n            Set volume ramping strength n [0..5] [default: " << commandlineflags().ramping << "]" << std::endl;
 		log << "     --tempo f              Set tempo factor f [default: " << tempo_flag_to_double( commandlineflags().tempo ) << "]" << std::endl;
 		log << "     --pitch f              Set pitch factor f [default: " << pitch_flag_to_double( commandlineflags().pitch ) << "]" << std::endl;
@@ -640,6 +839,8 @@ static void show_help( textout & log, bool with_info = true, bool longhelp = fal
 		log << "     --[no-]randomize       Randomize playlist [default: " << commandlineflags().randomize << "]" << std::endl;
 		log << "     --[no-]shuffle         Shuffle through playlist [default: " << commandlineflags().shuffle << "]" << std::endl;
 		log << "     --[no-]restart         Restart playlist when finished [default: " << commandlineflags().restart << "]" << std::endl;
+		log << "     --[no-]prefetch        Load the next file in the background while playing (only applies to --ui and --batch modes) [default: " << commandlineflags().prefetch << "]" << std::endl;
+		log << "     --crossfade n          Crossfade n ms between files (only applies to --ui and --batch modes) [default: " << commandlineflags().crossfade << "]" << std::endl;
 		log << std::endl;
 		log << "     --subsong n            Select subsong n (-1 means play all subsongs consecutively) [default: " << commandlineflags().subsong << "]" << std::endl;
 		log << "     --repeat n             Repeat song n times (-1 means forever) [default: " << commandlineflags().repeatcount << "]" << std::endl;
@@ -657,6 +858,10 @@ static void show_help( textout & log, bool with_info = true, bool longhelp = fal
 		log << "     --output-type t        Use output format t when writing to a individual PCM files (only applies to --render mode) [default: " << commandlineflags().output_extension << "]" << std::endl;
 		log << " -o, --output f             Write PCM output to file f instead of streaming to audio device (only applies to --ui and --batch modes) [default: " << commandlineflags().output_filename << "]" << std::endl;
 		log << "     --force                Force overwriting of output file [default: " << commandlineflags().force_overwrite << "]" << std::endl;
+		log << "     --jobs n               Render up to n files concurrently (only applies to --render mode) [default: " << commandlineflags().jobs << "]" << std::endl;
+		log << "     --output-queue n       Encode PCM output files on a separate thread, queueing up to n blocks (0 means encode while rendering) [default: " << commandlineflags().output_queue << "]" << std::endl;
+		log << "     --json                 Write benchmark results as JSON to stdout (only applies to --benchmark mode) [default: " << commandlineflags().benchmark_json << "]" << std::endl;
+		log << "     --hash-compare f       Compare render hashes with manifest f instead of writing a manifest (only applies to --render-hash mode)" << std::endl;
 		log << std::endl;
 		log << "     --                     Interpret further arguments as filenames" << std::endl;
 		log << std::endl;
@@ -742,7 +947,7 @@ template < typename Tmod >
 static void apply_mod_settings( commandlineflags & flags, Tmod & mod ) {
 	flags.separation = std::max( flags.separation, std::int32_t(   0 ) );
 	flags.filtertaps = std::max( flags.filtertaps, std::int32_t(   1 ) );
-	flags.filtertaps = std::min( flags.filtertaps, std::int32_t(   8 ) );
+	flags.filtertaps = std::min( flags.filtertaps, std::int32_t(  32 ) );
 	flags.ramping    = std::max( flags.ramping,    std::int32_t(  -1 ) );
 	flags.ramping    = std::min( flags.ramping,    std::int32_t(  10 ) );
 	flags.tempo      = std::max( flags.tempo,      std::int32_t( -48 ) );
@@ -1686,62 +1891,275 @@ static void probe_file( commandlineflags & flags, const std::string & filename,
 
 }
 
-static void render_file( commandlineflags & flags, const std::string & filename, textout & log, write_buffers_interface & audio_stream ) {
-
-	log.writeout();
+// A loaded module together with the stream it may still read from.
+struct loaded_module {
+	std::unique_ptr<std::istream> file_stream;
+	std::unique_ptr<openmpt::module> mod;
+	std::uint64_t filesize;
+	loaded_module() : filesize(0) { }
+};
 
-	std::ostringstream silentlog;
+static std::unique_ptr<loaded_module> load_module( const commandlineflags & flags, const std::string & filename, std::ostream & silentlog ) {
 
-	try {
+	std::unique_ptr<loaded_module> result( new loaded_module() );
 
 #if defined(WIN32) && defined(UNICODE) && !defined(_MSC_VER)
-		std::istringstream file_stream;
+	std::istringstream * file_stream = new std::istringstream();
 #else
-		std::ifstream file_stream;
+	std::ifstream * file_stream = new std::ifstream();
 #endif
-		std::uint64_t filesize = 0;
-		bool use_stdin = ( filename == "-" );
-		if ( !use_stdin ) {
-			#if defined(WIN32) && defined(UNICODE) && !defined(_MSC_VER)
-				// Only MSVC has std::ifstream::ifstream(std::wstring).
-				// Fake it for other compilers using _wfopen().
-				std::string data;
-				FILE * f = _wfopen( utf8_to_wstring( filename ).c_str(), L"rb" );
-				if ( f ) {
-					while ( !feof( f ) ) {
-						static const std::size_t BUFFER_SIZE = 4096;
-						char buffer[BUFFER_SIZE];
-						size_t data_read = fread( buffer, 1, BUFFER_SIZE, f );
-						std::copy( buffer, buffer + data_read, std::back_inserter( data ) );
-					}
-					fclose( f );
-					f = NULL;
+	result->file_stream.reset( file_stream );
+	bool use_stdin = ( filename == "-" );
+	if ( !use_stdin ) {
+		#if defined(WIN32) && defined(UNICODE) && !defined(_MSC_VER)
+			// Only MSVC has std::ifstream::ifstream(std::wstring).
+			// Fake it for other compilers using _wfopen().
+			std::string data;
+			FILE * f = _wfopen( utf8_to_wstring( filename ).c_str(), L"rb" );
+			if ( f ) {
+				while ( !feof( f ) ) {
+					static const std::size_t BUFFER_SIZE = 4096;
+					char buffer[BUFFER_SIZE];
+					size_t data_read = fread( buffer, 1, BUFFER_SIZE, f );
+					std::copy( buffer, buffer + data_read, std::back_inserter( data ) );
 				}
-				file_stream.str( data );
-				filesize = data.length();
-			#elif defined(_MSC_VER) && defined(UNICODE)
-				file_stream.open( utf8_to_wstring( filename ), std::ios::binary );
-				file_stream.seekg( 0, std::ios::end );
-				filesize = file_stream.tellg();
-				file_stream.seekg( 0, std::ios::beg );
-			#else
-				file_stream.open( filename, std::ios::binary );
-				file_stream.seekg( 0, std::ios::end );
-				filesize = file_stream.tellg();
-				file_stream.seekg( 0, std::ios::beg );
-			#endif
+				fclose( f );
+				f = NULL;
+			}
+			file_stream->str( data );
+			result->filesize = data.length();
+		#elif defined(_MSC_VER) && defined(UNICODE)
+			file_stream->open( utf8_to_wstring( filename ), std::ios::binary );
+			file_stream->seekg( 0, std::ios::end );
+			result->filesize = file_stream->tellg();
+			file_stream->seekg( 0, std::ios::beg );
+		#else
+			file_stream->open( filename, std::ios::binary );
+			file_stream->seekg( 0, std::ios::end );
+			result->filesize = file_stream->tellg();
+			file_stream->seekg( 0, std::ios::beg );
+		#endif
+	}
+	std::istream & data_stream = use_stdin ? std::cin : *file_stream;
+	if ( data_stream.fail() ) {
+		throw exception( "file open error" );
+	}
+
+#if !(defined(WIN32) && defined(UNICODE))
+	if ( !use_stdin ) {
+		// Let libopenmpt open local files itself, which allows it to memory-map them instead of copying them.
+		file_stream->close();
+		result->mod.reset( new openmpt::module( filename, silentlog, flags.ctls ) );
+	} else
+#endif
+	{
+		result->mod.reset( new openmpt::module( data_stream, silentlog, flags.ctls ) );
+	}
+	result->mod->select_subsong( flags.subsong );
+
+	return result;
+
+}
+
+// Loads the next file of the playlist on a background thread while the current one is playing.
+// Load errors are kept and reported once the file is actually played.
+class module_prefetcher {
+#if !defined(__DJGPP__)
+private:
+	struct prefetch_result {
+		std::unique_ptr<loaded_module> loaded;
+		std::string log;
+		std::exception_ptr error;
+	};
+	std::string filename;
+	std::future<prefetch_result> pending;
+#endif
+public:
+	void start( const commandlineflags & flags, const std::string & filename_ ) {
+#if !defined(__DJGPP__)
+		if ( filename_ == "-" || ( pending.valid() && filename_ == filename ) ) {
+			return;
 		}
-		std::istream & data_stream = use_stdin ? std::cin : file_stream;
-		if ( data_stream.fail() ) {
-			throw exception( "file open error" );
+		filename = filename_;
+		pending = std::async( std::launch::async, [flags, filename_]() {
+			prefetch_result result;
+			std::ostringstream silentlog;
+			try {
+				result.loaded = load_module( flags, filename_, silentlog );
+			} catch ( ... ) {
+				result.error = std::current_exception();
+			}
+			result.log = silentlog.str();
+			return result;
+		} );
+#else
+		(void)flags;
+		(void)filename_;
+#endif
+	}
+	// Returns the prefetched module if filename_ has been prefetched, or nullptr otherwise.
+	std::unique_ptr<loaded_module> take( const std::string & filename_, std::ostream & silentlog ) {
+#if !defined(__DJGPP__)
+		if ( !pending.valid() || filename_ != filename ) {
+			return std::unique_ptr<loaded_module>();
+		}
+		prefetch_result result = pending.get();
+		silentlog << result.log;
+		if ( result.error ) {
+			std::rethrow_exception( result.error );
 		}
+		return std::move( result.loaded );
+#else
+		(void)filename_;
+		(void)silentlog;
+		return std::unique_ptr<loaded_module>();
+#endif
+	}
+};
 
-		{
-			openmpt::module mod( data_stream, silentlog, flags.ctls );
-			mod.select_subsong( flags.subsong );
-			silentlog.str( std::string() ); // clear, loader messages get stored to get_metadata( "warnings" ) by libopenmpt internally
-			render_mod_file( flags, filename, filesize, mod, log, audio_stream );
+// Overlaps the end of each file with the start of the next one.
+// The last crossfade ms of audio are held back, and are faded out into the first frames of the following file once next_file() has been called.
+class crossfade_audio_stream : public write_buffers_interface {
+private:
+	write_buffers_interface & impl;
+	std::size_t channels;
+	std::size_t hold_frames;
+	std::vector<std::vector<float> > held;
+	std::vector<std::vector<float> > tail;
+	std::size_t tail_pos;
+	std::vector<std::vector<float> > input;
+public:
+	crossfade_audio_stream( write_buffers_interface & impl_, const commandlineflags & flags )
+		: impl(impl_)
+		, channels(flags.channels)
+		, hold_frames(static_cast<std::size_t>( flags.crossfade ) * flags.samplerate / 1000)
+		, held(flags.channels)
+		, tail(flags.channels)
+		, tail_pos(0)
+		, input(flags.channels)
+	{
+		return;
+	}
+	virtual ~crossfade_audio_stream() {
+		return;
+	}
+	void next_file() {
+		std::size_t tail_frames = tail[0].size() - tail_pos;
+		std::size_t held_frames = held[0].size();
+		std::size_t total = held_frames + tail_frames;
+		for ( std::size_t channel = 0; channel < channels; ++channel ) {
+			std::vector<float> new_tail( held[channel] );
+			new_tail.insert( new_tail.end(), tail[channel].begin() + tail_pos, tail[channel].end() );
+			for ( std::size_t frame = 0; frame < held_frames; ++frame ) {
+				new_tail[frame] *= 1.0f - static_cast<float>( frame ) / static_cast<float>( total );
+			}
+			tail[channel].swap( new_tail );
+			held[channel].clear();
+		}
+		tail_pos = 0;
+	}
+	template < typename Tsample >
+	void flush() {
+		std::size_t held_frames = held[0].size();
+		write_held<Tsample>( held_frames );
+		for ( std::size_t channel = 0; channel < channels; ++channel ) {
+			held[channel].assign( tail[channel].begin() + tail_pos, tail[channel].end() );
+			tail[channel].clear();
+		}
+		tail_pos = 0;
+		write_held<Tsample>( held[0].size() );
+	}
+private:
+	static float to_float( float val ) {
+		return val;
+	}
+	static float to_float( std::int16_t val ) {
+		return val * (1.0f/32768.0f);
+	}
+	template < typename Tsample >
+	void write_held( std::size_t frames ) {
+		if ( frames == 0 ) {
+			return;
+		}
+		std::vector<std::vector<Tsample> > out( channels, std::vector<Tsample>( frames ) );
+		std::vector<Tsample*> buffers( channels );
+		for ( std::size_t channel = 0; channel < channels; ++channel ) {
+			for ( std::size_t frame = 0; frame < frames; ++frame ) {
+				out[channel][frame] = convert_sample_to<Tsample>( held[channel][frame] );
+			}
+			held[channel].erase( held[channel].begin(), held[channel].begin() + frames );
+			buffers[channel] = out[channel].data();
+		}
+		impl.write( buffers, frames );
+	}
+	template < typename Tsample >
+	void write_crossfaded( const std::vector<Tsample*> & buffers, std::size_t frames ) {
+		const std::size_t tail_frames = tail[0].size();
+		for ( std::size_t channel = 0; channel < channels; ++channel ) {
+			input[channel].resize( frames );
+			for ( std::size_t frame = 0; frame < frames; ++frame ) {
+				input[channel][frame] = to_float( buffers[channel][frame] );
+			}
+			for ( std::size_t frame = 0; frame < frames && tail_pos + frame < tail_frames; ++frame ) {
+				float fade_in = static_cast<float>( tail_pos + frame ) / static_cast<float>( tail_frames );
+				input[channel][frame] = input[channel][frame] * fade_in + tail[channel][tail_pos + frame];
+			}
+			held[channel].insert( held[channel].end(), input[channel].begin(), input[channel].end() );
+		}
+		tail_pos = std::min( tail_pos + frames, tail_frames );
+		if ( held[0].size() > hold_frames ) {
+			write_held<Tsample>( held[0].size() - hold_frames );
 		}
+	}
+public:
+	void write_metadata( std::map<std::string,std::string> metadata ) override {
+		impl.write_metadata( metadata );
+	}
+	void write_updated_metadata( std::map<std::string,std::string> metadata ) override {
+		impl.write_updated_metadata( metadata );
+	}
+	void write( const std::vector<float*> buffers, std::size_t frames ) override {
+		write_crossfaded( buffers, frames );
+	}
+	void write( const std::vector<std::int16_t*> buffers, std::size_t frames ) override {
+		write_crossfaded( buffers, frames );
+	}
+	bool pause() override {
+		return impl.pause();
+	}
+	bool unpause() override {
+		return impl.unpause();
+	}
+	bool sleep( int ms ) override {
+		return impl.sleep( ms );
+	}
+	bool is_dummy() const override {
+		return impl.is_dummy();
+	}
+};
+
+static void render_file( commandlineflags & flags, const std::string & filename, textout & log, write_buffers_interface & audio_stream, module_prefetcher * prefetcher = nullptr, const std::string & next_filename = std::string() ) {
+
+	log.writeout();
+
+	std::ostringstream silentlog;
+
+	try {
+
+		std::unique_ptr<loaded_module> loaded;
+		if ( prefetcher ) {
+			loaded = prefetcher->take( filename, silentlog );
+		}
+		if ( !loaded ) {
+			loaded = load_module( flags, filename, silentlog );
+		}
+		silentlog.str( std::string() ); // clear, loader messages get stored to get_metadata( "warnings" ) by libopenmpt internally
+
+		if ( prefetcher && !next_filename.empty() ) {
+			prefetcher->start( flags, next_filename );
+		}
+
+		render_mod_file( flags, filename, loaded->filesize, *loaded->mod, log, audio_stream );
 
 	} catch ( prev_file & ) {
 		throw;
@@ -1772,6 +2190,736 @@ static void render_file( commandlineflags & flags, const std::string & filename,
 }
 
 
+#if !defined(__DJGPP__)
+
+// Render each file to its own output file, using up to flags.jobs threads.
+// The output of every file is shown in playlist order once the file has been rendered.
+static void render_files_concurrently( commandlineflags & flags, textout & log ) {
+	struct file_result {
+		bool done = false;
+		std::string log;
+		std::exception_ptr error;
+	};
+	flags.apply_default_buffer_sizes();
+	const std::size_t num_files = flags.filenames.size();
+	std::vector<file_result> results( num_files );
+	std::mutex mutex;
+	std::condition_variable file_done;
+	std::size_t next_file = 0;
+	std::size_t running = 0;
+	std::size_t finished = 0;
+	auto worker = [&]() {
+		while ( true ) {
+			std::size_t index = 0;
+			{
+				std::lock_guard<std::mutex> lock( mutex );
+				if ( next_file >= num_files ) {
+					return;
+				}
+				index = next_file++;
+				running++;
+			}
+			commandlineflags file_flags = flags;
+			file_flags.playlist_index = index;
+			file_flags.show_progress = false; // the progress of all files is shown combined
+			const std::string & filename = flags.filenames[index];
+			textout_buffer file_log;
+			std::exception_ptr error;
+			try {
+				file_audio_stream_raii file_audio_stream( file_flags, filename + std::string(".") + file_flags.output_extension, file_log );
+				render_file( file_flags, filename, file_log, file_audio_stream );
+			} catch ( ... ) {
+				error = std::current_exception();
+			}
+			{
+				std::lock_guard<std::mutex> lock( mutex );
+				results[index].log = file_log.get();
+				results[index].error = error;
+				results[index].done = true;
+				running--;
+				finished++;
+			}
+			file_done.notify_one();
+		}
+	};
+	std::vector<std::thread> threads;
+	const std::size_t num_threads = std::min( static_cast<std::size_t>( flags.jobs ), num_files );
+	for ( std::size_t thread = 0; thread < num_threads; ++thread ) {
+		threads.emplace_back( worker );
+	}
+	// Errors that would have stopped rendering without --jobs (e.g. an output file that already exists) are rethrown once all files have been processed.
+	std::exception_ptr first_error;
+	std::size_t shown = 0;
+	{
+		std::unique_lock<std::mutex> lock( mutex );
+		while ( shown < num_files ) {
+			file_done.wait_for( lock, std::chrono::milliseconds( flags.ui_redraw_interval ) );
+			std::string output;
+			while ( shown < num_files && results[shown].done ) {
+				output += results[shown].log;
+				if ( results[shown].error ) {
+					if ( !first_error ) {
+						first_error = results[shown].error;
+					}
+					try {
+						std::rethrow_exception( results[shown].error );
+					} catch ( std::exception & e ) {
+						output += "error rendering '" + flags.filenames[shown] + "': " + e.what() + "\n\n";
+					} catch ( ... ) {
+						output += "unknown error rendering '" + flags.filenames[shown] + "'\n\n";
+					}
+				}
+				results[shown].log.clear();
+				shown++;
+			}
+			const std::size_t files_running = running;
+			const std::size_t files_finished = finished;
+			lock.unlock();
+			if ( flags.show_progress && !output.empty() ) {
+				log << std::string( std::max( flags.terminal_width - 1, 0 ), ' ' ) << "\r";
+			}
+			log << output;
+			if ( flags.show_progress && shown < num_files ) {
+				log << " Files: " << files_finished << "/" << num_files << " rendered, " << files_running << " in progress" << "   " << "\r";
+			}
+			log.writeout();
+			lock.lock();
+		}
+	}
+	for ( auto & thread : threads ) {
+		thread.join();
+	}
+	flags.playlist_index = num_files;
+	if ( first_error ) {
+		std::rethrow_exception( first_error );
+	}
+}
+
+#endif // !__DJGPP__
+
+struct benchmark_result {
+	std::string filename;
+	std::string error;
+	double duration;
+	double load_seconds;
+	double scan_seconds;
+	double render_seconds;
+	double rendered_seconds;
+	std::int32_t peak_voices;
+	benchmark_result()
+		: duration(0.0)
+		, load_seconds(0.0)
+		, scan_seconds(0.0)
+		, render_seconds(0.0)
+		, rendered_seconds(0.0)
+		, peak_voices(0)
+	{
+		return;
+	}
+	double realtime_factor() const {
+		return render_seconds > 0.0 ? rendered_seconds / render_seconds : 0.0;
+	}
+};
+
+// Peak resident set size of the whole process so far in bytes, or 0 if the platform does not provide it.
+// As this includes all files that have been benchmarked before, it is only reported once for the whole run.
+static std::uint64_t get_peak_rss() {
+#if defined(__DJGPP__) || defined(WIN32)
+	return 0;
+#else
+	struct rusage usage;
+	std::memset( &usage, 0, sizeof( struct rusage ) );
+	if ( getrusage( RUSAGE_SELF, &usage ) != 0 ) {
+		return 0;
+	}
+#if defined(__APPLE__)
+	return static_cast<std::uint64_t>( usage.ru_maxrss );
+#else
+	return static_cast<std::uint64_t>( usage.ru_maxrss ) * 1024;
+#endif
+#endif
+}
+
+static double seconds_since( std::chrono::steady_clock::time_point start ) {
+	return std::chrono::duration<double>( std::chrono::steady_clock::now() - start ).count();
+}
+
+static std::string seconds_to_benchmark_string( double seconds ) {
+	std::ostringstream str;
+	str.imbue( std::locale::classic() );
+	str << std::fixed << std::setprecision( 3 ) << seconds * 1000.0 << "ms";
+	return str.str();
+}
+
+static std::string json_string( const std::string & str ) {
+	std::ostringstream result;
+	result << "\"";
+	for ( const auto c : str ) {
+		switch ( c ) {
+			case '"': result << "\\\""; break;
+			case '\\': result << "\\\\"; break;
+			case '\b': result << "\\b"; break;
+			case '\f': result << "\\f"; break;
+			case '\n': result << "\\n"; break;
+			case '\r': result << "\\r"; break;
+			case '\t': result << "\\t"; break;
+			default:
+				if ( static_cast<unsigned char>( c ) < 0x20 ) {
+					result << "\\u" << std::hex << std::setw( 4 ) << std::setfill( '0' ) << static_cast<int>( c ) << std::dec;
+				} else {
+					result << c;
+				}
+				break;
+		}
+	}
+	result << "\"";
+	return result.str();
+}
+
+template < typename Tsample >
+static void benchmark_render( commandlineflags & flags, openmpt::module & mod, benchmark_result & result ) {
+	const std::size_t bufsize = 1024;
+	std::vector<Tsample> left( bufsize );
+	std::vector<Tsample> right( bufsize );
+	std::vector<Tsample> rear_left( bufsize );
+	std::vector<Tsample> rear_right( bufsize );
+	std::int64_t rendered_frames = 0;
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	while ( true ) {
+		std::size_t count = 0;
+		switch ( flags.channels ) {
+			case 1: count = mod.read( flags.samplerate, bufsize, left.data() ); break;
+			case 2: count = mod.read( flags.samplerate, bufsize, left.data(), right.data() ); break;
+			case 4: count = mod.read( flags.samplerate, bufsize, left.data(), right.data(), rear_left.data(), rear_right.data() ); break;
+		}
+		if ( count == 0 ) {
+			break;
+		}
+		rendered_frames += count;
+		result.peak_voices = std::max( result.peak_voices, mod.get_current_playing_channels() );
+		if ( flags.end_time > 0 && mod.get_position_seconds() >= flags.end_time ) {
+			break;
+		}
+	}
+	result.render_seconds = seconds_since( start );
+	result.rendered_seconds = static_cast<double>( rendered_frames ) / static_cast<double>( flags.samplerate );
+}
+
+static std::vector<char> read_file_data( const std::string & filename ) {
+	std::vector<char> data;
+	if ( filename == "-" ) {
+		data.assign( std::istreambuf_iterator<char>( std::cin ), std::istreambuf_iterator<char>() );
+		return data;
+	}
+#if defined(WIN32) && defined(UNICODE)
+	FILE * f = _wfopen( utf8_to_wstring( filename ).c_str(), L"rb" );
+#else
+	FILE * f = std::fopen( filename.c_str(), "rb" );
+#endif
+	if ( !f ) {
+		throw exception( "file open error" );
+	}
+	while ( !std::feof( f ) && !std::ferror( f ) ) {
+		static const std::size_t BUFFER_SIZE = 65536;
+		char buffer[BUFFER_SIZE];
+		std::size_t data_read = std::fread( buffer, 1, BUFFER_SIZE, f );
+		data.insert( data.end(), buffer, buffer + data_read );
+	}
+	std::fclose( f );
+	f = NULL;
+	return data;
+}
+
+// The file is read into memory up front so that disk access is not part of the load time.
+// The subsong scan is skipped while loading and timed separately.
+static benchmark_result benchmark_file( commandlineflags & flags, const std::string & filename, textout & log ) {
+
+	benchmark_result result;
+	result.filename = filename;
+
+	std::ostringstream silentlog;
+
+	try {
+
+		const std::vector<char> data = read_file_data( filename );
+
+		std::map<std::string, std::string> ctls = flags.ctls;
+		ctls["load.skip_subsongs_init"] = "1";
+
+		std::chrono::steady_clock::time_point load_start = std::chrono::steady_clock::now();
+		openmpt::module mod( data, silentlog, ctls );
+		result.load_seconds = seconds_since( load_start );
+		silentlog.str( std::string() ); // clear, loader messages get stored to get_metadata( "warnings" ) by libopenmpt internally
+
+		std::chrono::steady_clock::time_point scan_start = std::chrono::steady_clock::now();
+		mod.get_duration_seconds();
+		result.scan_seconds = seconds_since( scan_start );
+
+		mod.select_subsong( flags.subsong );
+		result.duration = mod.get_duration_seconds();
+		mod.set_repeat_count( flags.repeatcount );
+		apply_mod_settings( flags, mod );
+		if ( flags.seek_target > 0.0 ) {
+			mod.set_position_seconds( flags.seek_target );
+		}
+
+		if ( flags.use_float ) {
+			benchmark_render<float>( flags, mod, result );
+		} else {
+			benchmark_render<std::int16_t>( flags, mod, result );
+		}
+
+	} catch ( silent_exit_exception & ) {
+		throw;
+	} catch ( std::exception & e ) {
+		if ( !silentlog.str().empty() ) {
+			log << "errors loading '" << filename << "': " << silentlog.str() << std::endl;
+		}
+		log << "error benchmarking '" << filename << "': " << e.what() << std::endl;
+		result.error = e.what();
+	} catch ( ... ) {
+		log << "unknown error benchmarking '" << filename << "'" << std::endl;
+		result.error = "unknown error";
+	}
+
+	return result;
+
+}
+
+static void show_benchmark_result( textout & log, const benchmark_result & result ) {
+	std::vector<field> fields;
+	set_field( fields, "Filename" ).ostream() << get_filename( result.filename );
+	if ( result.error.empty() ) {
+		set_field( fields, "Duration" ).ostream() << seconds_to_string( result.duration );
+		set_field( fields, "Load" ).ostream() << seconds_to_benchmark_string( result.load_seconds );
+		set_field( fields, "Scan" ).ostream() << seconds_to_benchmark_string( result.scan_seconds );
+		set_field( fields, "Render" ).ostream() << seconds_to_benchmark_string( result.render_seconds ) << " for " << seconds_to_string( result.rendered_seconds );
+		set_field( fields, "Realtime" ).ostream() << std::fixed << std::setprecision( 1 ) << result.realtime_factor() << "x";
+		set_field( fields, "Voices" ).ostream() << result.peak_voices;
+	}
+	show_fields( log, fields );
+	log << std::endl;
+	log.writeout();
+}
+
+static void write_benchmark_json( textout & out, const commandlineflags & flags, const std::vector<benchmark_result> & results, const benchmark_result & total, std::size_t failed, std::uint64_t peak_rss ) {
+	std::ostringstream json;
+	json.imbue( std::locale::classic() );
+	json << std::setprecision( 9 );
+	const auto write_values = [&]( const benchmark_result & result ) {
+		json << "\"load_seconds\": " << result.load_seconds << ", ";
+		json << "\"scan_seconds\": " << result.scan_seconds << ", ";
+		json << "\"render_seconds\": " << result.render_seconds << ", ";
+		json << "\"rendered_seconds\": " << result.rendered_seconds << ", ";
+		json << "\"realtime_factor\": " << result.realtime_factor() << ", ";
+		json << "\"peak_voices\": " << result.peak_voices;
+	};
+	json << "{" << std::endl;
+	json << "\t\"openmpt123\": " << json_string( OPENMPT123_VERSION_STRING ) << "," << std::endl;
+	json << "\t\"libopenmpt\": " << json_string( openmpt::string::get( "library_version" ) ) << "," << std::endl;
+	json << "\t\"settings\": { ";
+	json << "\"samplerate\": " << flags.samplerate << ", ";
+	json << "\"channels\": " << flags.channels << ", ";
+	json << "\"float\": " << ( flags.use_float ? "true" : "false" ) << ", ";
+	json << "\"filtertaps\": " << flags.filtertaps << ", ";
+	json << "\"ramping\": " << flags.ramping << ", ";
+	json << "\"repeatcount\": " << flags.repeatcount << ", ";
+	json << "\"end_time\": " << flags.end_time << ", ";
+	json << "\"ctls\": {";
+	bool first = true;
+	for ( const auto & ctl : flags.ctls ) {
+		json << ( first ? " " : ", " ) << json_string( ctl.first ) << ": " << json_string( ctl.second );
+		first = false;
+	}
+	json << ( first ? "}" : " }" ) << " }," << std::endl;
+	json << "\t\"files\": [" << std::endl;
+	for ( std::size_t i = 0; i < results.size(); ++i ) {
+		const benchmark_result & result = results[i];
+		json << "\t\t{ ";
+		json << "\"filename\": " << json_string( result.filename ) << ", ";
+		if ( !result.error.empty() ) {
+			json << "\"error\": " << json_string( result.error ) << ", ";
+		}
+		json << "\"duration\": " << result.duration << ", ";
+		write_values( result );
+		json << " }" << ( i + 1 < results.size() ? "," : "" ) << std::endl;
+	}
+	json << "\t]," << std::endl;
+	json << "\t\"summary\": { ";
+	json << "\"files\": " << results.size() << ", ";
+	json << "\"failed\": " << failed << ", ";
+	write_values( total );
+	if ( peak_rss > 0 ) {
+		json << ", \"process_peak_rss_bytes\": " << peak_rss;
+	}
+	json << " }" << std::endl;
+	json << "}" << std::endl;
+	out << json.str();
+	out.writeout();
+}
+
+static void benchmark_files( commandlineflags & flags, textout & log, textout & json_out ) {
+	std::vector<benchmark_result> results;
+	benchmark_result total;
+	std::size_t failed = 0;
+	for ( const auto & filename : flags.filenames ) {
+		benchmark_result result = benchmark_file( flags, filename, log );
+		if ( result.error.empty() ) {
+			total.load_seconds += result.load_seconds;
+			total.scan_seconds += result.scan_seconds;
+			total.render_seconds += result.render_seconds;
+			total.rendered_seconds += result.rendered_seconds;
+			total.peak_voices = std::max( total.peak_voices, result.peak_voices );
+		} else {
+			failed++;
+		}
+		show_benchmark_result( log, result );
+		results.push_back( result );
+		flags.playlist_index++;
+	}
+	const std::uint64_t peak_rss = get_peak_rss();
+	std::vector<field> fields;
+	if ( results.size() > 1 ) {
+		set_field( fields, "Files" ).ostream() << ( results.size() - failed ) << "/" << results.size();
+		set_field( fields, "Load" ).ostream() << seconds_to_benchmark_string( total.load_seconds );
+		set_field( fields, "Scan" ).ostream() << seconds_to_benchmark_string( total.scan_seconds );
+		set_field( fields, "Render" ).ostream() << seconds_to_benchmark_string( total.render_seconds ) << " for " << seconds_to_string( total.rendered_seconds );
+		set_field( fields, "Realtime" ).ostream() << std::fixed << std::setprecision( 1 ) << total.realtime_factor() << "x";
+		set_field( fields, "Voices" ).ostream() << total.peak_voices;
+	}
+	if ( peak_rss > 0 ) {
+		set_field( fields, "Peak RSS" ).ostream() << bytes_to_string( peak_rss ) << " (whole process)";
+	}
+	if ( !fields.empty() ) {
+		show_fields( log, fields );
+		log << std::endl;
+		log.writeout();
+	}
+	if ( flags.benchmark_json ) {
+		write_benchmark_json( json_out, flags, results, total, failed, peak_rss );
+	}
+}
+
+// Streaming 64bit FNV-1a hash.
+class fnv1a64 {
+private:
+	std::uint64_t state;
+public:
+	fnv1a64() : state(14695981039346656037ull) { }
+	void process( std::uint32_t value ) {
+		for ( int byte = 0; byte < 4; ++byte ) {
+			state ^= ( value >> ( byte * 8 ) ) & 0xffu;
+			state *= 1099511628211ull;
+		}
+	}
+	std::string str() const {
+		std::ostringstream result;
+		result << std::hex << std::setw( 16 ) << std::setfill( '0' ) << state;
+		return result.str();
+	}
+};
+
+// Hashes of one rendered subsong.
+// Besides the digest of the whole subsong, a digest is kept for every second of audio, which allows locating the first difference.
+struct render_hash_entry {
+	std::string filename;
+	std::int32_t subsong;
+	std::uint64_t frames;
+	std::string digest;
+	std::vector<std::string> chunks;
+	std::string error;
+	render_hash_entry() : subsong(0), frames(0) { }
+};
+
+static std::string render_hash_manifest_header( const commandlineflags & flags ) {
+	std::ostringstream header;
+	header.imbue( std::locale::classic() );
+	header << "openmpt123-render-hash 1";
+	header << " samplerate=" << flags.samplerate;
+	header << " channels=" << flags.channels;
+	header << " gain=" << flags.gain;
+	header << " separation=" << flags.separation;
+	header << " filtertaps=" << flags.filtertaps;
+	header << " ramping=" << flags.ramping;
+	header << " tempo=" << flags.tempo;
+	header << " pitch=" << flags.pitch;
+	header << " repeatcount=" << flags.repeatcount;
+	header << " end_time=" << flags.end_time;
+	header << " ctls=" << ctls_to_string( flags.ctls );
+	return header.str();
+}
+
+static std::string render_hash_entry_to_string( const render_hash_entry & entry ) {
+	std::ostringstream line;
+	if ( !entry.error.empty() ) {
+		line << entry.filename << "\t" << "error" << "\t" << entry.error;
+		return line.str();
+	}
+	line << entry.filename << "\t" << entry.subsong << "\t" << entry.frames << "\t" << entry.digest << "\t";
+	for ( std::size_t i = 0; i < entry.chunks.size(); ++i ) {
+		line << ( i > 0 ? " " : "" ) << entry.chunks[i];
+	}
+	return line.str();
+}
+
+static std::vector<std::string> split( const std::string & str, char separator ) {
+	std::vector<std::string> result;
+	std::string::size_type pos = 0;
+	while ( true ) {
+		std::string::size_type next = str.find( separator, pos );
+		result.push_back( str.substr( pos, next == std::string::npos ? std::string::npos : next - pos ) );
+		if ( next == std::string::npos ) {
+			break;
+		}
+		pos = next + 1;
+	}
+	return result;
+}
+
+static std::vector<render_hash_entry> read_render_hash_manifest( const std::string & filename, std::string & header ) {
+	std::ifstream file( filename, std::ios::binary );
+	if ( !file ) {
+		throw exception( "cannot open render hash manifest '" + filename + "'" );
+	}
+	std::vector<render_hash_entry> entries;
+	std::string line;
+	if ( !std::getline( file, line ) ) {
+		throw exception( "invalid render hash manifest '" + filename + "'" );
+	}
+	header = trim_eol( line );
+	while ( std::getline( file, line ) ) {
+		line = trim_eol( line );
+		if ( line.empty() ) {
+			continue;
+		}
+		std::vector<std::string> columns = split( line, '\t' );
+		render_hash_entry entry;
+		entry.filename = columns[0];
+		if ( columns.size() == 3 && columns[1] == "error" ) {
+			entry.error = columns[2];
+		} else if ( columns.size() == 5 ) {
+			std::istringstream subsong( columns[1] );
+			subsong >> entry.subsong;
+			std::istringstream frames( columns[2] );
+			frames >> entry.frames;
+			entry.digest = columns[3];
+			if ( !columns[4].empty() ) {
+				entry.chunks = split( columns[4], ' ' );
+			}
+		} else {
+			throw exception( "invalid render hash manifest '" + filename + "'" );
+		}
+		entries.push_back( entry );
+	}
+	return entries;
+}
+
+// Renders every subsong of a file to 32bit float, which involves neither dithering nor clipping, and hashes the sample bits.
+static std::vector<render_hash_entry> render_hash_file( const commandlineflags & flags, const std::string & filename, textout & log ) {
+	std::vector<render_hash_entry> entries;
+	std::ostringstream silentlog;
+	try {
+		std::unique_ptr<loaded_module> loaded = load_module( flags, filename, silentlog );
+		openmpt::module & mod = *loaded->mod;
+		std::vector<std::int32_t> subsongs;
+		if ( flags.subsong == -1 ) {
+			for ( std::int32_t subsong = 0; subsong < mod.get_num_subsongs(); ++subsong ) {
+				subsongs.push_back( subsong );
+			}
+		} else {
+			subsongs.push_back( flags.subsong );
+		}
+		const std::size_t bufsize = 1024;
+		const std::uint64_t chunk_frames = flags.samplerate;
+		std::vector<std::vector<float> > buffers( 4, std::vector<float>( bufsize ) );
+		for ( const auto subsong : subsongs ) {
+			mod.select_subsong( subsong );
+			mod.set_repeat_count( flags.repeatcount );
+			commandlineflags mod_flags = flags;
+			apply_mod_settings( mod_flags, mod );
+			render_hash_entry entry;
+			entry.filename = filename;
+			entry.subsong = subsong;
+			fnv1a64 digest;
+			fnv1a64 chunk;
+			std::uint64_t chunk_pos = 0;
+			while ( true ) {
+				std::size_t count = 0;
+				switch ( flags.channels ) {
+					case 1: count = mod.read( flags.samplerate, bufsize, buffers[0].data() ); break;
+					case 2: count = mod.read( flags.samplerate, bufsize, buffers[0].data(), buffers[1].data() ); break;
+					case 4: count = mod.read( flags.samplerate, bufsize, buffers[0].data(), buffers[1].data(), buffers[2].data(), buffers[3].data() ); break;
+				}
+				if ( count == 0 ) {
+					break;
+				}
+				for ( std::size_t frame = 0; frame < count; ++frame ) {
+					for ( std::int32_t channel = 0; channel < flags.channels; ++channel ) {
+						std::uint32_t bits = 0;
+						std::memcpy( &bits, &buffers[channel][frame], sizeof( float ) );
+						digest.process( bits );
+						chunk.process( bits );
+					}
+					chunk_pos++;
+					if ( chunk_pos == chunk_frames ) {
+						entry.chunks.push_back( chunk.str() );
+						chunk = fnv1a64();
+						chunk_pos = 0;
+					}
+				}
+				entry.frames += count;
+				if ( flags.end_time > 0 && mod.get_position_seconds() >= flags.end_time ) {
+					break;
+				}
+			}
+			if ( chunk_pos > 0 ) {
+				entry.chunks.push_back( chunk.str() );
+			}
+			entry.digest = digest.str();
+			entries.push_back( entry );
+		}
+	} catch ( silent_exit_exception & ) {
+		throw;
+	} catch ( std::exception & e ) {
+		if ( !silentlog.str().empty() ) {
+			log << "errors loading '" << filename << "': " << silentlog.str() << std::endl;
+		}
+		log << "error hashing '" << filename << "': " << e.what() << std::endl;
+		entries.clear();
+		render_hash_entry entry;
+		entry.filename = filename;
+		entry.error = e.what();
+		entries.push_back( entry );
+	}
+	return entries;
+}
+
+// Returns an empty string if both subsongs rendered identically, or a description of the first difference otherwise.
+static std::string compare_render_hash_entries( const render_hash_entry & reference, const render_hash_entry & entry, std::int32_t samplerate ) {
+	if ( reference.frames == entry.frames && reference.digest == entry.digest ) {
+		return std::string();
+	}
+	std::uint64_t chunk = 0;
+	while ( chunk < reference.chunks.size() && chunk < entry.chunks.size() && reference.chunks[chunk] == entry.chunks[chunk] ) {
+		chunk++;
+	}
+	std::uint64_t position = std::min( chunk * samplerate, std::min( reference.frames, entry.frames ) );
+	std::ostringstream result;
+	result << "first difference at " << seconds_to_string( static_cast<double>( position ) / samplerate );
+	if ( reference.frames != entry.frames ) {
+		result << ", duration changed from " << seconds_to_string( static_cast<double>( reference.frames ) / samplerate ) << " to " << seconds_to_string( static_cast<double>( entry.frames ) / samplerate );
+	}
+	return result.str();
+}
+
+// Compares the entries of one file with the manifest and returns a description of every difference.
+static std::vector<std::string> compare_render_hashes( const std::vector<render_hash_entry> & reference, const std::string & filename, const std::vector<render_hash_entry> & entries, std::int32_t samplerate ) {
+	std::vector<std::string> differences;
+	std::vector<const render_hash_entry *> file_reference;
+	for ( const auto & ref : reference ) {
+		if ( ref.filename == filename ) {
+			file_reference.push_back( &ref );
+		}
+	}
+	if ( file_reference.empty() ) {
+		differences.push_back( "not in manifest" );
+		return differences;
+	}
+	const std::string reference_error = file_reference[0]->error;
+	const std::string error = entries[0].error;
+	if ( !reference_error.empty() || !error.empty() ) {
+		if ( reference_error.empty() ) {
+			differences.push_back( "error: " + error );
+		} else if ( error.empty() ) {
+			differences.push_back( "no longer fails with: " + reference_error );
+		} else if ( error != reference_error ) {
+			differences.push_back( "error changed from '" + reference_error + "' to '" + error + "'" );
+		}
+		return differences;
+	}
+	for ( const auto & entry : entries ) {
+		const render_hash_entry * match = nullptr;
+		for ( const auto ref : file_reference ) {
+			if ( ref->subsong == entry.subsong ) {
+				match = ref;
+			}
+		}
+		if ( !match ) {
+			differences.push_back( "subsong " + std::to_string( entry.subsong ) + ": not in manifest" );
+			continue;
+		}
+		std::string difference = compare_render_hash_entries( *match, entry, samplerate );
+		if ( !difference.empty() ) {
+			differences.push_back( "subsong " + std::to_string( entry.subsong ) + ": " + difference );
+		}
+	}
+	for ( const auto ref : file_reference ) {
+		bool found = false;
+		for ( const auto & entry : entries ) {
+			found = found || ( entry.subsong == ref->subsong );
+		}
+		if ( !found ) {
+			differences.push_back( "subsong " + std::to_string( ref->subsong ) + ": missing" );
+		}
+	}
+	return differences;
+}
+
+static void render_hash_files( commandlineflags & flags, textout & log, textout & manifest_out ) {
+	const std::string header = render_hash_manifest_header( flags );
+	const bool compare = !flags.hash_reference.empty();
+	std::vector<render_hash_entry> reference;
+	if ( compare ) {
+		std::string reference_header;
+		reference = read_render_hash_manifest( flags.hash_reference, reference_header );
+		if ( reference_header != header ) {
+			throw exception( "render settings differ from manifest '" + flags.hash_reference + "': " + reference_header );
+		}
+	} else {
+		manifest_out << header << std::endl;
+		manifest_out.writeout();
+	}
+	std::size_t changed_files = 0;
+	for ( const auto & filename : flags.filenames ) {
+		std::vector<render_hash_entry> entries = render_hash_file( flags, filename, log );
+		std::vector<field> fields;
+		set_field( fields, "Filename" ).ostream() << get_filename( filename );
+		for ( const auto & entry : entries ) {
+			if ( entry.error.empty() ) {
+				set_field( fields, "Subsong " + std::to_string( entry.subsong ) ).ostream() << entry.digest << " " << seconds_to_string( static_cast<double>( entry.frames ) / flags.samplerate );
+			}
+			if ( !compare ) {
+				manifest_out << render_hash_entry_to_string( entry ) << std::endl;
+			}
+		}
+		if ( compare ) {
+			std::vector<std::string> differences = compare_render_hashes( reference, filename, entries, flags.samplerate );
+			for ( const auto & difference : differences ) {
+				set_field( fields, "Changed" ).ostream() << difference;
+			}
+			if ( !differences.empty() ) {
+				changed_files++;
+			}
+		}
+		show_fields( log, fields );
+		log << std::endl;
+		log.writeout();
+		manifest_out.writeout();
+		flags.playlist_index++;
+	}
+	if ( compare ) {
+		std::vector<field> fields;
+		set_field( fields, "Files" ).ostream() << flags.filenames.size();
+		set_field( fields, "Changed" ).ostream() << changed_files;
+		show_fields( log, fields );
+		log << std::endl;
+		log.writeout();
+		if ( changed_files > 0 ) {
+			throw exception( "render hashes differ from manifest '" + flags.hash_reference + "'" );
+		}
+	}
+}
+
 static std::string get_random_filename( std::set<std::string> & filenames, std::default_random_engine & prng ) {
 	std::size_t index = std::uniform_int_distribution<std::size_t>( 0, filenames.size() - 1 )( prng );
 	std::set<std::string>::iterator it = filenames.begin();
@@ -1780,24 +2928,48 @@ static std::string get_random_filename( std::set<std::string> & filenames, std::
 }
 
 
+static std::string get_random_filename( std::set<std::string> filenames, const std::string & exclude, std::default_random_engine & prng ) {
+	filenames.erase( exclude );
+	if ( filenames.empty() ) {
+		return std::string();
+	}
+	return get_random_filename( filenames, prng );
+}
+
 static void render_files( commandlineflags & flags, textout & log, write_buffers_interface & audio_stream, std::default_random_engine & prng ) {
 	if ( flags.randomize ) {
 		std::shuffle( flags.filenames.begin(), flags.filenames.end(), prng );
 	}
+	const bool playback = ( flags.mode == ModeUI || flags.mode == ModeBatch );
+	std::unique_ptr<module_prefetcher> prefetcher;
+	if ( playback && flags.prefetch ) {
+		prefetcher.reset( new module_prefetcher() );
+	}
+	std::unique_ptr<crossfade_audio_stream> crossfade_stream;
+	if ( playback && flags.crossfade > 0 ) {
+		crossfade_stream.reset( new crossfade_audio_stream( audio_stream, flags ) );
+	}
+	write_buffers_interface & output_stream = crossfade_stream ? *crossfade_stream : audio_stream;
 	try {
 		while ( true ) {
 			if ( flags.shuffle ) {
 				// TODO: improve prev/next logic
 				std::set<std::string> shuffle_set;
 				shuffle_set.insert( flags.filenames.begin(), flags.filenames.end() );
+				std::string next_filename;
 				while ( true ) {
 					if ( shuffle_set.empty() ) {
 						break;
 					}
-					std::string filename = get_random_filename( shuffle_set, prng );
+					// The next file is chosen in advance, so that it can be prefetched.
+					std::string filename = ( shuffle_set.count( next_filename ) > 0 ) ? next_filename : get_random_filename( shuffle_set, prng );
+					next_filename = get_random_filename( shuffle_set, filename, prng );
 					try {
 						flags.playlist_index = std::find( flags.filenames.begin(), flags.filenames.end(), filename ) - flags.filenames.begin();
-						render_file( flags, filename, log, audio_stream );
+						if ( crossfade_stream ) {
+							crossfade_stream->next_file();
+						}
+						render_file( flags, filename, log, output_stream, prefetcher.get(), next_filename );
 						shuffle_set.erase( filename );
 						continue;
 					} catch ( prev_file & ) {
@@ -1818,7 +2990,16 @@ static void render_files( commandlineflags & flags, textout & log, write_buffers
 					}
 					try {
 						flags.playlist_index = filename - flags.filenames.begin();
-						render_file( flags, *filename, log, audio_stream );
+						std::string next_filename;
+						if ( filename + 1 != flags.filenames.end() ) {
+							next_filename = *( filename + 1 );
+						} else if ( flags.restart ) {
+							next_filename = flags.filenames.front();
+						}
+						if ( crossfade_stream ) {
+							crossfade_stream->next_file();
+						}
+						render_file( flags, *filename, log, output_stream, prefetcher.get(), next_filename );
 						filename++;
 						continue;
 					} catch ( prev_file & e ) {
@@ -1842,6 +3023,13 @@ static void render_files( commandlineflags & flags, textout & log, write_buffers
 				break;
 			}
 		}
+		if ( crossfade_stream ) {
+			if ( flags.use_float ) {
+				crossfade_stream->flush<float>();
+			} else {
+				crossfade_stream->flush<std::int16_t>();
+			}
+		}
 	} catch ( ... ) {
 		throw;
 	}
@@ -2027,6 +3215,10 @@ static commandlineflags parse_openmpt123( const std::vector<std::string> & args,
 				flags.mode = ModeBatch;
 			} else if ( arg == "--render" ) {
 				flags.mode = ModeRender;
+			} else if ( arg == "--benchmark" ) {
+				flags.mode = ModeBenchmark;
+			} else if ( arg == "--render-hash" ) {
+				flags.mode = ModeRenderHash;
 			} else if ( arg == "--terminal-width" && nextarg != "" ) {
 				std::istringstream istr( nextarg );
 				istr >> flags.terminal_width;
@@ -2139,6 +3331,19 @@ static commandlineflags parse_openmpt123( const std::vector<std::string> & args,
 				++i;
 			} else if ( arg == "--force" ) {
 				flags.force_overwrite = true;
+			} else if ( arg == "--jobs" && nextarg != "" ) {
+				std::istringstream istr( nextarg );
+				istr >> flags.jobs;
+				++i;
+			} else if ( arg == "--output-queue" && nextarg != "" ) {
+				std::istringstream istr( nextarg );
+				istr >> flags.output_queue;
+				++i;
+			} else if ( arg == "--json" ) {
+				flags.benchmark_json = true;
+			} else if ( arg == "--hash-compare" && nextarg != "" ) {
+				flags.hash_reference = nextarg;
+				++i;
 			} else if ( arg == "--output-type" && nextarg != "" ) {
 				flags.output_extension = nextarg;
 				++i;
@@ -2203,6 +3408,14 @@ static commandlineflags parse_openmpt123( const std::vector<std::string> & args,
 				flags.restart = true;
 			} else if ( arg == "--no-restart" ) {
 				flags.restart = false;
+			} else if ( arg == "--prefetch" ) {
+				flags.prefetch = true;
+			} else if ( arg == "--no-prefetch" ) {
+				flags.prefetch = false;
+			} else if ( arg == "--crossfade" && nextarg != "" ) {
+				std::istringstream istr( nextarg );
+				istr >> flags.crossfade;
+				++i;
 			} else if ( arg == "--subsong" && nextarg != "" ) {
 				std::istringstream istr( nextarg );
 				istr >> flags.subsong;
@@ -2381,7 +3594,7 @@ static int main( int argc, char * argv [] ) {
 		}
 
 		bool stdout_can_ui = true;
-		if ( flags.use_stdout ) {
+		if ( flags.use_stdout || flags.benchmark_json || flags.mode == ModeRenderHash ) {
 			stdout_can_ui = false;
 		}
 
@@ -2483,6 +3696,12 @@ static int main( int argc, char * argv [] ) {
 				}
 			} break;
 			case ModeRender: {
+#if !defined(__DJGPP__)
+				if ( flags.jobs > 1 && flags.filenames.size() > 1 ) {
+					render_files_concurrently( flags, log );
+					break;
+				}
+#endif // !__DJGPP__
 				for ( const auto & filename : flags.filenames ) {
 					flags.apply_default_buffer_sizes();
 					file_audio_stream_raii file_audio_stream( flags, filename + std::string(".") + flags.output_extension, log );
@@ -2490,6 +3709,12 @@ static int main( int argc, char * argv [] ) {
 					flags.playlist_index++;
 				}
 			} break;
+			case ModeBenchmark: {
+				benchmark_files( flags, log, std_out );
+			} break;
+			case ModeRenderHash: {
+				render_hash_files( flags, log, std_out );
+			} break;
 			case ModeNone:
 			break;
 		}
@@ -172,6 +172,26 @@ public:
 	}
 };
 
+class textout_buffer : public textout {
+private:
+	std::string buffer;
+public:
+	textout_buffer() {
+		return;
+	}
+	virtual ~textout_buffer() {
+		return;
+	}
+public:
+	void write( const std::string & text ) override {
+		buffer += text;
+	}
+	std::string get() {
+		writeout();
+		return buffer;
+	}
+};
+
 #if defined(WIN32)
 
 class textout_console : public textout {
@@ -240,7 +260,9 @@ enum Mode {
 	ModeInfo,
 	ModeUI,
 	ModeBatch,
-	ModeRender
+	ModeRender,
+	ModeBenchmark,
+	ModeRenderHash
 };
 
 static inline std::string mode_to_string( Mode mode ) {
@@ -251,6 +273,8 @@ static inline std::string mode_to_string( Mode mode ) {
 		case ModeUI:     return "ui"; break;
 		case ModeBatch:  return "batch"; break;
 		case ModeRender: return "render"; break;
+		case ModeBenchmark: return "benchmark"; break;
+		case ModeRenderHash: return "render-hash"; break;
 	}
 	return "";
 }
@@ -297,11 +321,17 @@ struct commandlineflags {
 	bool randomize;
 	bool shuffle;
 	bool restart;
+	bool prefetch;
+	std::int32_t crossfade;
 	std::size_t playlist_index;
 	std::vector<std::string> filenames;
 	std::string output_filename;
 	std::string output_extension;
 	bool force_overwrite;
+	std::int32_t jobs;
+	std::int32_t output_queue;
+	bool benchmark_json;
+	std::string hash_reference;
 	bool paused;
 	std::string warnings;
 	void apply_default_buffer_sizes() {
@@ -414,9 +444,18 @@ struct commandlineflags {
 		randomize = false;
 		shuffle = false;
 		restart = false;
+#if defined(__DJGPP__)
+		prefetch = false;
+#else
+		prefetch = true;
+#endif
+		crossfade = 0;
 		playlist_index = 0;
 		output_extension = "auto";
 		force_overwrite = false;
+		jobs = 1;
+		output_queue = 0;
+		benchmark_json = false;
 		paused = false;
 	}
 	void check_and_sanitize() {
@@ -479,6 +518,14 @@ struct commandlineflags {
 				show_pattern = false;
 				show_ui = false;
 			break;
+			case ModeBenchmark:
+			case ModeRenderHash:
+				show_progress = false;
+				show_meters = false;
+				show_channel_meters = false;
+				show_pattern = false;
+				show_ui = false;
+			break;
 		}
 		if ( quiet ) {
 			verbose = false;
@@ -505,6 +552,32 @@ struct commandlineflags {
 		if ( mode == ModeRender && !output_filename.empty() ) {
 			throw args_error_exception();
 		}
+		if ( jobs < 1 || ( mode != ModeRender && jobs != 1 ) ) {
+			throw args_error_exception();
+		}
+#if defined(__DJGPP__)
+		if ( output_queue != 0 || prefetch ) {
+			throw args_error_exception();
+		}
+#endif
+		if ( crossfade < 0 || ( crossfade > 0 && mode != ModeUI && mode != ModeBatch ) ) {
+			throw args_error_exception();
+		}
+		if ( output_queue < 0 ) {
+			throw args_error_exception();
+		}
+		if ( benchmark_json && mode != ModeBenchmark ) {
+			throw args_error_exception();
+		}
+		if ( !hash_reference.empty() && mode != ModeRenderHash ) {
+			throw args_error_exception();
+		}
+		if ( ( mode == ModeBenchmark || mode == ModeRenderHash ) && ( use_stdout || !output_filename.empty() ) ) {
+			throw args_error_exception();
+		}
+		if ( ( mode == ModeBenchmark || mode == ModeRenderHash ) && repeatcount < 0 && end_time <= 0.0 ) {
+			throw args_error_exception();
+		}
 		if ( mode != ModeRender && !output_filename.empty() ) {
 			output_extension = get_extension( output_filename );
 		}
@@ -555,11 +628,109 @@ public:
 	}
 };
 
+// Wait-free single-producer/single-consumer ring buffer of interleaved float frames.
+// The producer only advances write_pos and the consumer only advances read_pos.
+// Both positions are free-running frame counters, the capacity is a power of 2.
+class frame_ring_buffer {
+private:
+	std::size_t channels;
+	std::size_t capacity;
+	std::vector<float> buffer;
+	std::atomic<std::size_t> read_pos;
+	std::atomic<std::size_t> write_pos;
+public:
+	frame_ring_buffer()
+		: channels(0)
+		, capacity(0)
+		, read_pos(0)
+		, write_pos(0)
+	{
+		return;
+	}
+	// Not thread-safe, must be called before the producer and the consumer start.
+	void resize( std::size_t channels_, std::size_t frames ) {
+		std::size_t frames_power2 = 1;
+		while ( frames_power2 < frames ) {
+			frames_power2 *= 2;
+		}
+		channels = channels_;
+		capacity = frames_power2;
+		buffer.assign( capacity * channels, 0.0f );
+		read_pos.store( 0 );
+		write_pos.store( 0 );
+	}
+	std::size_t frames_readable() const {
+		return write_pos.load( std::memory_order_acquire ) - read_pos.load( std::memory_order_acquire );
+	}
+	std::size_t frames_writable() const {
+		return capacity - frames_readable();
+	}
+	// Producer side. Writes at most frames frames starting at offset and returns the number of frames written.
+	template < typename Tsample >
+	std::size_t write( const std::vector<Tsample*> & buffers, std::size_t offset, std::size_t frames ) {
+		const std::size_t w = write_pos.load( std::memory_order_relaxed );
+		const std::size_t r = read_pos.load( std::memory_order_acquire );
+		frames = std::min( frames, capacity - ( w - r ) );
+		std::size_t done = 0;
+		while ( done < frames ) {
+			const std::size_t pos = ( w + done ) & ( capacity - 1 );
+			const std::size_t count = std::min( frames - done, capacity - pos );
+			for ( std::size_t channel = 0; channel < channels; ++channel ) {
+				const Tsample * src = buffers[channel] + offset + done;
+				float * dst = &buffer[pos * channels + channel];
+				for ( std::size_t frame = 0; frame < count; ++frame ) {
+					dst[frame * channels] = convert_sample_from( src[frame] );
+				}
+			}
+			done += count;
+		}
+		write_pos.store( w + frames, std::memory_order_release );
+		return frames;
+	}
+	// Consumer side. Reads at most frames interleaved frames into dst and returns the number of frames read.
+	template < typename Tsample >
+	std::size_t read( Tsample * dst, std::size_t frames ) {
+		const std::size_t r = read_pos.load( std::memory_order_relaxed );
+		const std::size_t w = write_pos.load( std::memory_order_acquire );
+		frames = std::min( frames, w - r );
+		std::size_t done = 0;
+		while ( done < frames ) {
+			const std::size_t pos = ( r + done ) & ( capacity - 1 );
+			const std::size_t count = std::min( frames - done, capacity - pos );
+			copy_samples( dst + done * channels, &buffer[pos * channels], count * channels );
+			done += count;
+		}
+		read_pos.store( r + frames, std::memory_order_release );
+		return frames;
+	}
+private:
+	static float convert_sample_from( float val ) {
+		return val;
+	}
+	static float convert_sample_from( std::int16_t val ) {
+		return val * (1.0f/32768.0f);
+	}
+	static void copy_samples( float * dst, const float * src, std::size_t count ) {
+		std::memcpy( dst, src, count * sizeof( float ) );
+	}
+	static void copy_samples( std::int16_t * dst, const float * src, std::size_t count ) {
+		for ( std::size_t i = 0; i < count; ++i ) {
+			dst[i] = convert_sample_to<std::int16_t>( src[i] );
+		}
+	}
+};
+
+#if !defined(__DJGPP__)
+
+// Adapts the blocking write interface to callback-driven backends.
+// The audio callback never blocks: it drains the ring buffer and pads underruns with silence.
+// The writer blocks on a condition variable until the callback has freed space.
 class write_buffers_blocking_wrapper : public write_buffers_interface {
 protected:
 	std::size_t channels;
-	std::size_t sampleQueueMaxFrames;
-	std::deque<float> sampleQueue;
+	frame_ring_buffer queue;
+	std::mutex queue_space_mutex;
+	std::condition_variable queue_space_available;
 protected:
 	virtual ~write_buffers_blocking_wrapper() {
 		return;
@@ -567,65 +738,50 @@ protected:
 protected:
 	write_buffers_blocking_wrapper( const commandlineflags & flags )
 		: channels(flags.channels)
-		, sampleQueueMaxFrames(0)
 	{
 		return;
 	}
 	void set_queue_size_frames( std::size_t frames ) {
-		sampleQueueMaxFrames = frames;
-	}
-	template < typename Tsample >
-	Tsample pop_queue() {
-		float val = 0.0f;
-		if ( !sampleQueue.empty() ) {
-			val = sampleQueue.front();
-			sampleQueue.pop_front();
-		}
-		return convert_sample_to<Tsample>( val );
+		queue.resize( channels, frames );
 	}
 	template < typename Tsample >
 	void fill_buffer( Tsample * buf, std::size_t framesToRender ) {
-		for ( std::size_t frame = 0; frame < framesToRender; ++frame ) {
-			for ( std::size_t channel = 0; channel < channels; ++channel ) {
-				*buf = pop_queue<Tsample>();
-				buf++;
-			}
+		std::size_t framesRead = queue.read( buf, framesToRender );
+		std::fill( buf + framesRead * channels, buf + framesToRender * channels, Tsample() );
+		if ( framesRead > 0 ) {
+			queue_space_available.notify_one();
 		}
 	}
 private:
 	void wait_for_queue_space() {
-		while ( sampleQueue.size() >= sampleQueueMaxFrames * channels ) {
-			unlock();
-			sleep( 1 );
-			lock();
-		}
+		std::unique_lock<std::mutex> guard( queue_space_mutex );
+		// The callback notifies without holding the mutex in order to never block.
+		// The timeout recovers from a notification that raced with going to sleep, and keeps polling while paused.
+		queue_space_available.wait_for( guard, std::chrono::milliseconds( 10 ), [&]() { return queue.frames_writable() > 0; } );
 	}
-public:
-	void write( const std::vector<float*> buffers, std::size_t frames ) override {
-		lock();
-		for ( std::size_t frame = 0; frame < frames; ++frame ) {
-			for ( std::size_t channel = 0; channel < channels; ++channel ) {
+	template < typename Tsample >
+	void write_blocking( const std::vector<Tsample*> & buffers, std::size_t frames ) {
+		std::size_t offset = 0;
+		while ( offset < frames ) {
+			std::size_t written = queue.write( buffers, offset, frames - offset );
+			offset += written;
+			if ( offset < frames ) {
 				wait_for_queue_space();
-				sampleQueue.push_back( buffers[channel][frame] );
 			}
 		}
-		unlock();
+	}
+public:
+	void write( const std::vector<float*> buffers, std::size_t frames ) override {
+		write_blocking( buffers, frames );
 	}
 	void write( const std::vector<std::int16_t*> buffers, std::size_t frames ) override {
-		lock();
-		for ( std::size_t frame = 0; frame < frames; ++frame ) {
-			for ( std::size_t channel = 0; channel < channels; ++channel ) {
-				wait_for_queue_space();
-				sampleQueue.push_back( buffers[channel][frame] * (1.0f/32768.0f) );
-			}
-		}
-		unlock();
+		write_blocking( buffers, frames );
 	}
-	virtual void lock() = 0;
-	virtual void unlock() = 0;
 	bool sleep( int ms ) override = 0;
 };
 
+#endif // !__DJGPP__
+
 class write_buffers_polling_wrapper : public write_buffers_interface {
 protected:
 	std::size_t channels;
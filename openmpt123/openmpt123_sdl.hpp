@@ -96,13 +96,7 @@ private:
 	}
 	void sdl_callback( Uint8 * stream, int len ) {
 		std::size_t framesToRender = len / sizeof( std::int16_t ) / channels;
-		for ( std::size_t frame = 0; frame < framesToRender; ++frame ) {
-			for ( std::size_t channel = 0; channel < channels; ++channel ) {
-				std::int16_t sample = pop_queue<std::int16_t>();
-				std::memcpy( stream, &sample, sizeof( std::int16_t ) );
-				stream += sizeof( std::int16_t );
-			}
-		}		
+		fill_buffer( reinterpret_cast<std::int16_t*>( stream ), framesToRender );
 	}
 public:
 	bool pause() override {
@@ -113,12 +107,6 @@ public:
 		SDL_PauseAudio( 0 );
 		return true;
 	}
-	void lock() override {
-		SDL_LockAudio();
-	}
-	void unlock() override {
-		SDL_UnlockAudio();
-	}
 	bool sleep( int ms ) override {
 		SDL_Delay( ms );
 		return true;
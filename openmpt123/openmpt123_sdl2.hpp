@@ -123,13 +123,7 @@ private:
 	template < typename Tsample >
 	void sdl2_callback_impl( Uint8 * stream, int len ) {
 		std::size_t framesToRender = len / sizeof( Tsample ) / channels;
-		for ( std::size_t frame = 0; frame < framesToRender; ++frame ) {
-			for ( std::size_t channel = 0; channel < channels; ++channel ) {
-				Tsample sample = pop_queue<Tsample>();
-				std::memcpy( stream, &sample, sizeof( Tsample ) );
-				stream += sizeof( Tsample );
-			}
-		}
+		fill_buffer( reinterpret_cast<Tsample*>( stream ), framesToRender );
 	}
 public:
 	bool pause() override {
@@ -140,12 +134,6 @@ public:
 		SDL_PauseAudioDevice( dev, 0 );
 		return true;
 	}
-	void lock() override {
-		SDL_LockAudioDevice( dev );
-	}
-	void unlock() override {
-		SDL_UnlockAudioDevice( dev );
-	}
 	bool sleep( int ms ) override {
 		SDL_Delay( ms );
 		return true;
@@ -915,6 +915,26 @@ struct ConvertFixedPoint<float32, int32, fractionalBits, clipOutput>
 	}
 };
 
+// Fixed point to float conversion with an additional gain factor.
+// The gain is applied after conversion so we do not suffer underflow or clipping.
+template <int fractionalBits>
+struct ConvertFixedPointToFloatWithGain
+{
+	typedef int32 input_t;
+	typedef float32 output_t;
+	ConvertFixedPoint<float32, int32, fractionalBits, false> conv;
+	const float gain;
+	MPT_FORCEINLINE explicit ConvertFixedPointToFloatWithGain(float gain_)
+		: gain(gain_)
+	{
+		return;
+	}
+	MPT_FORCEINLINE output_t operator() (input_t val)
+	{
+		return conv(val) * gain;
+	}
+};
+
 
 template <typename Tdst, typename Tsrc, int fractionalBits>
 struct ConvertToFixedPoint;
@@ -78,32 +78,78 @@ void CopyInterleavedSampleStreams(typename SampleConversion::output_t * MPT_REST
 
 
 
-template<int fractionalBits, bool clipOutput, typename Tsample, typename Tfixed>
-void ConvertInterleavedFixedPointToInterleaved(Tsample * MPT_RESTRICT p, const Tfixed * MPT_RESTRICT mixbuffer, std::size_t channels, std::size_t count)
+// Convert an interleaved buffer of #channels into another interleaved buffer.
+template <typename SampleConversion>
+void ConvertInterleavedToInterleaved(typename SampleConversion::output_t * MPT_RESTRICT dst, const typename SampleConversion::input_t * MPT_RESTRICT src, std::size_t channels, std::size_t count, SampleConversion conv = SampleConversion())
 {
-	SC::ConvertFixedPoint<Tsample, int32, fractionalBits, clipOutput> conv;
+	SampleConversion sampleConv(conv);
 	count *= channels;
 	for(std::size_t i = 0; i < count; ++i)
 	{
-		p[i] = conv(mixbuffer[i]);
+		dst[i] = sampleConv(src[i]);
 	}
 }
 
-template<int fractionalBits, bool clipOutput, typename Tsample, typename Tfixed>
-void ConvertInterleavedFixedPointToNonInterleaved(Tsample * const * const MPT_RESTRICT buffers, const Tfixed * MPT_RESTRICT mixbuffer, std::size_t channels, std::size_t count)
+
+// Convert an interleaved buffer of a compile-time number of channels into one buffer per channel.
+// Each channel is written in a separate pass with a constant stride, which allows the compiler to vectorize the inner loop.
+template <std::size_t channels, typename SampleConversion>
+void ConvertInterleavedToNonInterleaved(typename SampleConversion::output_t * const * const MPT_RESTRICT buffers, const typename SampleConversion::input_t * MPT_RESTRICT src, std::size_t count, SampleConversion conv = SampleConversion())
 {
-	SC::ConvertFixedPoint<Tsample, int32, fractionalBits, clipOutput> conv;
-	for(std::size_t i = 0; i < count; ++i)
+	for(std::size_t channel = 0; channel < channels; ++channel)
+	{
+		SampleConversion sampleConv(conv);
+		typename SampleConversion::output_t * MPT_RESTRICT dst = buffers[channel];
+		for(std::size_t i = 0; i < count; ++i)
+		{
+			dst[i] = sampleConv(src[i * channels + channel]);
+		}
+	}
+}
+
+
+// Convert an interleaved buffer of #channels into one buffer per channel.
+template <typename SampleConversion>
+void ConvertInterleavedToNonInterleaved(typename SampleConversion::output_t * const * const MPT_RESTRICT buffers, const typename SampleConversion::input_t * MPT_RESTRICT src, std::size_t channels, std::size_t count, SampleConversion conv = SampleConversion())
+{
+	switch(channels)
 	{
+	case 1:
+		ConvertInterleavedToInterleaved(buffers[0], src, 1, count, conv);
+		break;
+	case 2:
+		ConvertInterleavedToNonInterleaved<2>(buffers, src, count, conv);
+		break;
+	case 4:
+		ConvertInterleavedToNonInterleaved<4>(buffers, src, count, conv);
+		break;
+	default:
 		for(std::size_t channel = 0; channel < channels; ++channel)
 		{
-			buffers[channel][i] = conv(*mixbuffer);
-			mixbuffer++;
+			SampleConversion sampleConv(conv);
+			for(std::size_t i = 0; i < count; ++i)
+			{
+				buffers[channel][i] = sampleConv(src[i * channels + channel]);
+			}
 		}
+		break;
 	}
 }
 
 
+template<int fractionalBits, bool clipOutput, typename Tsample, typename Tfixed>
+void ConvertInterleavedFixedPointToInterleaved(Tsample * MPT_RESTRICT p, const Tfixed * MPT_RESTRICT mixbuffer, std::size_t channels, std::size_t count)
+{
+	ConvertInterleavedToInterleaved(p, mixbuffer, channels, count, SC::ConvertFixedPoint<Tsample, int32, fractionalBits, clipOutput>());
+}
+
+template<int fractionalBits, bool clipOutput, typename Tsample, typename Tfixed>
+void ConvertInterleavedFixedPointToNonInterleaved(Tsample * const * const MPT_RESTRICT buffers, const Tfixed * MPT_RESTRICT mixbuffer, std::size_t channels, std::size_t count)
+{
+	ConvertInterleavedToNonInterleaved(buffers, mixbuffer, channels, count, SC::ConvertFixedPoint<Tsample, int32, fractionalBits, clipOutput>());
+}
+
+
 // Copy from an interleaed buffer of #channels.
 template <typename SampleConversion>
 void CopyInterleavedToChannel(typename SampleConversion::output_t * MPT_RESTRICT dst, const typename SampleConversion::input_t * MPT_RESTRICT src, std::size_t channels, std::size_t countChunk, std::size_t channel, SampleConversion conv = SampleConversion())
@@ -59,7 +59,7 @@ static MPT_FORCEINLINE void Store64SSE(LR16 *dst, __m128i src) { return _mm_stor
 CReverb::CReverb()
 {
 	// Shared reverb state
-	InitMixBuffer(MixReverbBuffer, static_cast<uint32>(mpt::size(MixReverbBuffer)));
+	SetBufferSize(MIXBUFFERSIZE);
 
 	// Reverb mix buffers
 	MemsetZero(g_RefDelay);
@@ -406,14 +406,21 @@ void CReverb::Initialize(bool bReset, uint32 MixingFreq)
 }
 
 
+void CReverb::SetBufferSize(uint32 nSamples)
+{
+	MixReverbBuffer.assign(nSamples * 2, 0);
+}
+
+
 mixsample_t *CReverb::GetReverbSendBuffer(uint32 nSamples)
 {
+	MPT_ASSERT(nSamples * 2 <= MixReverbBuffer.size());
 	if(!gnReverbSend)
 	{ // and we did not clear the buffer yet, do it now because we will get new data
-		StereoFill(MixReverbBuffer, nSamples, gnRvbROfsVol, gnRvbLOfsVol);
+		StereoFill(MixReverbBuffer.data(), nSamples, gnRvbROfsVol, gnRvbLOfsVol);
 	}
 	gnReverbSend = 1; // we will have to process reverb
-	return MixReverbBuffer;
+	return MixReverbBuffer.data();
 }
 
 
@@ -426,7 +433,7 @@ void CReverb::Process(mixsample_t *MixSoundBuffer, uint32 nSamples)
 	}
 	if(!gnReverbSend)
 	{ // no input data in MixReverbBuffer, so the buffer got not cleared in GetReverbSendBuffer(), do it now for decay
-		StereoFill(MixReverbBuffer, nSamples, gnRvbROfsVol, gnRvbLOfsVol);
+		StereoFill(MixReverbBuffer.data(), nSamples, gnRvbROfsVol, gnRvbLOfsVol);
 	}
 
 	uint32 nIn, nOut;
@@ -449,15 +456,15 @@ void CReverb::Process(mixsample_t *MixSoundBuffer, uint32 nSamples)
 	if (lDryVol < 8) lDryVol = 8;
 	if (lDryVol > 16) lDryVol = 16;
 	lDryVol = 16 - (((16-lDryVol) * lMaxRvbGain) >> 15);
-	ReverbDryMix(MixSoundBuffer, MixReverbBuffer, lDryVol, nSamples);
+	ReverbDryMix(MixSoundBuffer, MixReverbBuffer.data(), lDryVol, nSamples);
 	// Downsample 2x + 1st stage of lowpass filter
-	nIn = ReverbProcessPreFiltering1x(MixReverbBuffer, nSamples);
+	nIn = ReverbProcessPreFiltering1x(MixReverbBuffer.data(), nSamples);
 	nOut = nIn;
 	// Main reverb processing: split into small chunks (needed for short reverb delays)
 	// Reverb Input + Low-Pass stage #2 + Pre-diffusion
-	if (nIn > 0) ProcessPreDelay(&g_RefDelay, MixReverbBuffer, nIn);
+	if (nIn > 0) ProcessPreDelay(&g_RefDelay, MixReverbBuffer.data(), nIn);
 	// Process Reverb Reflections and Late Reverberation
-	int32 *pRvbOut = MixReverbBuffer;
+	int32 *pRvbOut = MixReverbBuffer.data();
 	uint32 nRvbSamples = nOut, nCount = 0;
 	while (nRvbSamples > 0)
 	{
@@ -483,7 +490,7 @@ void CReverb::Process(mixsample_t *MixSoundBuffer, uint32 nSamples)
 	// Adjust nDelayPos, in case nIn != nOut
 	g_RefDelay.nDelayPos = (g_RefDelay.nDelayPos - nOut + nIn) & SNDMIX_REFLECTIONS_DELAY_MASK;
 	// Upsample 2x
-	ReverbProcessPostFiltering1x(MixReverbBuffer, MixSoundBuffer, nSamples);
+	ReverbProcessPostFiltering1x(MixReverbBuffer.data(), MixSoundBuffer, nSamples);
 	// Automatically shut down if needed
 	if(gnReverbSend) gnReverbSamples = gnReverbDecaySamples; // reset decay counter
 	else if(gnReverbSamples > nSamples) gnReverbSamples -= nSamples; // decay
@@ -16,6 +16,8 @@
 
 #include "../soundlib/Mixer.h"	// For MIXBUFFERSIZE
 
+#include <vector>
+
 OPENMPT_NAMESPACE_BEGIN
 
 ////////////////////////////////////////////////////////////////////////
@@ -142,7 +144,7 @@ public:
 
 	// Shared reverb state
 private:
-	mixsample_t MixReverbBuffer[MIXBUFFERSIZE * 2];
+	std::vector<mixsample_t> MixReverbBuffer;
 public:
 	mixsample_t gnRvbROfsVol = 0, gnRvbLOfsVol = 0;
 
@@ -174,6 +176,8 @@ public:
 	CReverb();
 public:
 	void Initialize(bool bReset, uint32 MixingFreq);
+	// Set the maximum number of frames that are processed at once
+	void SetBufferSize(uint32 nSamples);
 
 	// can be called multiple times or never (if no data is sent to reverb)
 	mixsample_t *GetReverbSendBuffer(uint32 nSamples);
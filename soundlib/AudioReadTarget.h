@@ -43,21 +43,14 @@ public:
 		MPT_ASSERT(SampleFormat(SampleFormatTraits<Tsample>::sampleFormat).IsValid());
 	}
 	std::size_t GetRenderedCount() const { return countRendered; }
-public:
-	void DataCallback(int32 *MixSoundBuffer, std::size_t channels, std::size_t countChunk) override
+protected:
+	// Write the mixed chunk directly into the output buffer(s), applying the given conversion.
+	template<typename SampleConversion>
+	void Convert(const int32 *MixSoundBuffer, std::size_t channels, std::size_t countChunk, SampleConversion conv)
 	{
-		// Convert to output sample format and optionally perform dithering and clipping if needed
-
-		const SampleFormat sampleFormat = SampleFormatTraits<Tsample>::sampleFormat;
-
-		if(sampleFormat.IsInt())
-		{
-			dither.Process(MixSoundBuffer, countChunk, channels, sampleFormat.GetBitsPerSample());
-		}
-
 		if(outputBuffer)
 		{
-			ConvertInterleavedFixedPointToInterleaved<MIXING_FRACTIONAL_BITS, clipOutput>(outputBuffer + (channels * countRendered), MixSoundBuffer, channels, countChunk);
+			ConvertInterleavedToInterleaved(outputBuffer + (channels * countRendered), MixSoundBuffer, channels, countChunk, conv);
 		}
 		if(outputBuffers)
 		{
@@ -66,11 +59,24 @@ public:
 			{
 				buffers[channel] = outputBuffers[channel] + countRendered;
 			}
-			ConvertInterleavedFixedPointToNonInterleaved<MIXING_FRACTIONAL_BITS, clipOutput>(buffers, MixSoundBuffer, channels, countChunk);
+			ConvertInterleavedToNonInterleaved(buffers, MixSoundBuffer, channels, countChunk, conv);
 		}
-
 		countRendered += countChunk;
 	}
+public:
+	void DataCallback(int32 *MixSoundBuffer, std::size_t channels, std::size_t countChunk) override
+	{
+		// Convert to output sample format and optionally perform dithering and clipping if needed
+
+		const SampleFormat sampleFormat = SampleFormatTraits<Tsample>::sampleFormat;
+
+		if(sampleFormat.IsInt())
+		{
+			dither.Process(MixSoundBuffer, countChunk, channels, sampleFormat.GetBitsPerSample());
+		}
+
+		Convert(MixSoundBuffer, channels, countChunk, SC::ConvertFixedPoint<Tsample, int32, MIXING_FRACTIONAL_BITS, clipOutput>());
+	}
 };
 
 
@@ -233,18 +239,6 @@ void ApplyGainBeforeConversionIfAppropriate<float>(int32 * /*MixSoundBuffer*/, s
 	// nothing
 }
 
-template<typename Tsample>
-void ApplyGainAfterConversionIfAppropriate(Tsample * /*buffer*/, Tsample * const * /*buffers*/, std::size_t /*countRendered*/, std::size_t /*channels*/, std::size_t /*countChunk*/, float /*gainFactor*/)
-{
-	// nothing
-}
-template<>
-void ApplyGainAfterConversionIfAppropriate<float>(float *buffer, float * const *buffers, std::size_t countRendered, std::size_t channels, std::size_t countChunk, float gainFactor)
-{
-	// Apply final output gain for floating point output after conversion so we do not suffer underflow or clipping
-	ApplyGain(buffer, buffers, countRendered, channels, countChunk, gainFactor);
-}
-
 template<typename Tsample>
 class AudioReadTargetGainBuffer
 	: public AudioReadTargetBuffer<Tsample>
@@ -263,17 +257,25 @@ public:
 public:
 	void DataCallback(int32 *MixSoundBuffer, std::size_t channels, std::size_t countChunk) override
 	{
-		const std::size_t countRendered_ = Tbase::GetRenderedCount();
-
 		ApplyGainBeforeConversionIfAppropriate<Tsample>(MixSoundBuffer, channels, countChunk, gainFactor);
 
 		Tbase::DataCallback(MixSoundBuffer, channels, countChunk);
-
-		ApplyGainAfterConversionIfAppropriate<Tsample>(Tbase::outputBuffer, Tbase::outputBuffers, countRendered_, channels, countChunk, gainFactor);
-
 	}
 };
 
+template<>
+inline void AudioReadTargetGainBuffer<float>::DataCallback(int32 *MixSoundBuffer, std::size_t channels, std::size_t countChunk)
+{
+	if(gainFactor == 1.0f)
+	{
+		Tbase::DataCallback(MixSoundBuffer, channels, countChunk);
+		return;
+	}
+	// Apply final output gain for floating point output during conversion so we do not suffer underflow or clipping,
+	// and do not have to make a second pass over the output buffer.
+	Convert(MixSoundBuffer, channels, countChunk, SC::ConvertFixedPointToFloatWithGain<MIXING_FRACTIONAL_BITS>(gainFactor));
+}
+
 
 #endif // MODPLUG_TRACKER
 
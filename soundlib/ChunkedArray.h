@@ -0,0 +1,138 @@
+/*
+ * ChunkedArray.h
+ * --------------
+ * Purpose: Fixed-size array whose elements are only allocated once they are written to.
+ * Notes  : Used for the big per-module tables (sample headers, sample names) of which most modules only use a few entries.
+ *          Writing to an element may allocate memory, so elements that are accessed from several threads at the same time
+ *          must have been written to before. Code that must not allocate memory (such as the render path) reads elements through Get().
+ * Authors: OpenMPT Devs
+ * The OpenMPT source code is released under the BSD license. Read LICENSE for more details.
+ */
+
+
+#pragma once
+
+#include "BuildSettings.h"
+
+#include <array>
+#include <functional>
+#include <memory>
+
+
+OPENMPT_NAMESPACE_BEGIN
+
+
+template <typename T, size_t numElements, size_t chunkSize = 64>
+class ChunkedArray
+{
+protected:
+	struct Chunk
+	{
+		std::array<T, chunkSize> elements{};
+	};
+
+	static constexpr size_t numChunks = (numElements + chunkSize - 1) / chunkSize;
+
+	std::array<std::unique_ptr<Chunk>, numChunks> m_chunks;
+
+	// Returned for elements that have never been written to
+	static const T &DefaultElement()
+	{
+		static const T element{};
+		return element;
+	}
+
+public:
+	ChunkedArray() = default;
+	ChunkedArray(ChunkedArray &&) noexcept = default;
+	ChunkedArray &operator=(ChunkedArray &&) noexcept = default;
+
+	ChunkedArray(const ChunkedArray &other)
+	{
+		*this = other;
+	}
+
+	ChunkedArray &operator=(const ChunkedArray &other)
+	{
+		if(this == &other)
+			return *this;
+		for(size_t chunk = 0; chunk < numChunks; chunk++)
+		{
+			if(other.m_chunks[chunk])
+				m_chunks[chunk] = mpt::make_unique<Chunk>(*other.m_chunks[chunk]);
+			else
+				m_chunks[chunk].reset();
+		}
+		return *this;
+	}
+
+	static constexpr size_t size() { return numElements; }
+
+	T &operator[](size_t index)
+	{
+		MPT_ASSERT(index < numElements);
+		std::unique_ptr<Chunk> &chunk = m_chunks[index / chunkSize];
+		if(!chunk)
+			chunk = mpt::make_unique<Chunk>();
+		return chunk->elements[index % chunkSize];
+	}
+
+	const T &operator[](size_t index) const
+	{
+		MPT_ASSERT(index < numElements);
+		const std::unique_ptr<Chunk> &chunk = m_chunks[index / chunkSize];
+		if(!chunk)
+			return DefaultElement();
+		return chunk->elements[index % chunkSize];
+	}
+
+	// Read-only access that never allocates, for code that must not allocate memory (e.g. the render path).
+	// Elements that have never been written to read as a default element.
+	const T &Get(size_t index) const
+	{
+		return (*this)[index];
+	}
+
+	bool IsAllocated(size_t index) const
+	{
+		MPT_ASSERT(index < numElements);
+		return m_chunks[index / chunkSize] != nullptr;
+	}
+
+	// Index of an element of this array, or size() if the pointer does not point to any allocated element.
+	size_t IndexOf(const T *element) const
+	{
+		for(size_t chunk = 0; chunk < numChunks; chunk++)
+		{
+			if(!m_chunks[chunk])
+				continue;
+			const T *first = m_chunks[chunk]->elements.data();
+			if(!std::less<const T *>()(element, first) && std::less<const T *>()(element, first + chunkSize))
+				return chunk * chunkSize + static_cast<size_t>(element - first);
+		}
+		return numElements;
+	}
+
+	// Call a function for every element that has been allocated so far (and possibly a few more in the same chunk)
+	template <typename Func>
+	void ForEachAllocated(Func func)
+	{
+		for(auto &chunk : m_chunks)
+		{
+			if(!chunk)
+				continue;
+			for(auto &element : chunk->elements)
+				func(element);
+		}
+	}
+
+	// Reset all elements to their default value and free the memory
+	void clear()
+	{
+		for(auto &chunk : m_chunks)
+			chunk.reset();
+	}
+};
+
+
+OPENMPT_NAMESPACE_END
@@ -0,0 +1,77 @@
+/*
+ * DeferredSamples.h
+ * -----------------
+ * Purpose: Bookkeeping for sample data that is decoded after loading a module instead of while loading it.
+ * Notes  : The file data referenced by the entries must stay valid for as long as the entries exist.
+ *          See CSoundFile::deferSampleData.
+ * Authors: OpenMPT Devs
+ * The OpenMPT source code is released under the BSD license. Read LICENSE for more details.
+ */
+
+
+#pragma once
+
+#include "BuildSettings.h"
+
+#include "Snd_defs.h"
+#include "SampleIO.h"
+#include "../common/FileReader.h"
+
+#include <map>
+#include <utility>
+#include <vector>
+
+
+OPENMPT_NAMESPACE_BEGIN
+
+
+class DeferredSamples
+{
+public:
+	struct Entry
+	{
+		SampleIO format;
+		FileReader file;	// Starts at the encoded sample data
+	};
+
+protected:
+	std::map<SAMPLEINDEX, Entry> m_entries;
+
+public:
+	bool empty() const { return m_entries.empty(); }
+	size_t size() const { return m_entries.size(); }
+
+	void Add(SAMPLEINDEX smp, SampleIO format, const FileReader &file) { m_entries[smp] = Entry{format, file}; }
+	bool Contains(SAMPLEINDEX smp) const { return m_entries.count(smp) != 0; }
+	void Remove(SAMPLEINDEX smp) { m_entries.erase(smp); }
+
+	// Remove the entry for a sample and return it. Returns false if the sample's data has not been deferred.
+	bool Take(SAMPLEINDEX smp, Entry &entry)
+	{
+		auto it = m_entries.find(smp);
+		if(it == m_entries.end())
+			return false;
+		entry = std::move(it->second);
+		m_entries.erase(it);
+		return true;
+	}
+
+	// Remove all entries and return them, ordered by sample index.
+	std::vector<std::pair<SAMPLEINDEX, Entry>> TakeAll()
+	{
+		std::vector<std::pair<SAMPLEINDEX, Entry>> entries;
+		entries.reserve(m_entries.size());
+		for(auto &entry : m_entries)
+		{
+			entries.emplace_back(entry.first, std::move(entry.second));
+		}
+		m_entries.clear();
+		return entries;
+	}
+
+	// Sample index of the first remaining entry, or 0 if there are none.
+	SAMPLEINDEX First() const { return m_entries.empty() ? 0 : m_entries.begin()->first; }
+};
+
+
+OPENMPT_NAMESPACE_END
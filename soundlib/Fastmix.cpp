@@ -20,8 +20,10 @@
 #include "Sndfile.h"
 #include "MixerLoops.h"
 #include "MixFuncTable.h"
+#include "ResampleCache.h"
 #include <cfloat>	// For FLT_EPSILON
 #include "plugins/PlugInterface.h"
+#include "../common/mptThreadPool.h"
 #include <algorithm>
 
 
@@ -271,6 +273,126 @@ struct MixLoopState
 };
 
 
+// Check if rendering the next numSamples frames of a voice would only read silent sampling points.
+// In that case, mixing would not change the output buffer and can be skipped.
+static bool IsSilentSpan(const ModChannel &chn, int32 numSamples)
+{
+	// Volume ramps, the Amiga resampler and filters keep state that must be updated even if the input is silent.
+	if(chn.nRampLength || chn.resamplingMode == SRCMODE_AMIGA)
+		return false;
+	// Loop wrap-around buffers are not covered by the peak map
+	if(chn.pModSample == nullptr || chn.pCurrentSample != chn.pModSample->samplev())
+		return false;
+#ifndef NO_FILTER
+	if(chn.dwFlags[CHN_FILTER] && (chn.nFilter_Y[0][0] | chn.nFilter_Y[0][1] | chn.nFilter_Y[1][0] | chn.nFilter_Y[1][1]))
+		return false;
+#endif // NO_FILTER
+
+	const SamplePosition endPos = chn.position + chn.increment * (numSamples - 1);
+	const int32 first = std::min(chn.position.GetInt(), endPos.GetInt()) - static_cast<int32>(InterpolationMaxLookahead);
+	const int32 last = std::max(chn.position.GetInt(), endPos.GetInt()) + static_cast<int32>(InterpolationMaxLookahead);
+	return chn.pModSample->IsSilent(static_cast<SmpLength>(std::max(first, int32(0))), static_cast<SmpLength>(std::max(last, int32(0))));
+}
+
+
+// Volume that makes the mix functions output the unscaled interpolated sampling points
+#ifdef MPT_INTMIXER
+static constexpr int32 ResampleCacheUnityVolume = 1;
+#else
+static constexpr int32 ResampleCacheUnityVolume = 4096;
+#endif // MPT_INTMIXER
+
+
+// Mix numSamples frames of a voice using previously interpolated sampling points from the resample cache.
+// If the requested frames directly follow the cached frames, they are interpolated with mixFunc and added to the cache first.
+// Returns false if the cache cannot be used for this voice, in which case the caller has to mix the voice as usual.
+static bool MixFromResampleCache(ResampleCache &cache, ModChannel &chn, uint32 functionNdx, const MixFuncInterface mixFunc, const CResampler &resampler, mixsample_t *pbuffer, uint32 numSamples)
+{
+	// Only cache the expensive interpolation modes, and only if nothing but the volume is applied after interpolation.
+	if(chn.resamplingMode != SRCMODE_CUBIC && chn.resamplingMode != SRCMODE_SINC8 && chn.resamplingMode != SRCMODE_SINC8LP && chn.resamplingMode != SRCMODE_SINC16 && chn.resamplingMode != SRCMODE_SINC32)
+		return false;
+	if(chn.dwFlags[CHN_FILTER] || !chn.increment.IsPositive())
+		return false;
+	// Loop wrap-around buffers depend on the voice's loop state and are not cached
+	if(chn.pModSample == nullptr || chn.pCurrentSample != chn.pModSample->samplev())
+		return false;
+
+	const int64 increment = chn.increment.GetRaw();
+	const int64 position = chn.position.GetRaw();
+	const ResampleCache::Key key = { chn.pCurrentSample, chn.pModSample->nLength, increment, position % increment, functionNdx };
+	const size_t firstFrame = static_cast<size_t>(position / increment);
+
+	ResampleCache::Entry *entry = cache.Find(key);
+	if(entry == nullptr && firstFrame == 0)
+	{
+		// Voice has just started at this phase, so cache all sampling points from here to the end of the sample
+		const SamplePosition sampleEnd(chn.pModSample->nLength, 0);
+		if(chn.position < sampleEnd)
+			entry = cache.Create(key, static_cast<size_t>((sampleEnd - chn.position - SamplePosition(1)).GetRaw() / increment) + 1);
+	}
+	if(entry == nullptr || firstFrame + numSamples > entry->maxFrames || firstFrame > entry->frames.size() / 2)
+	{
+		cache.misses += numSamples;
+		return false;
+	}
+
+	const size_t numCached = entry->frames.size() / 2;
+	if(firstFrame + numSamples > numCached)
+	{
+		// Extend the cache by interpolating the missing frames at unity volume
+		const uint32 numMissing = static_cast<uint32>(firstFrame + numSamples - numCached);
+		const int32 leftVol = chn.leftVol, rightVol = chn.rightVol;
+		chn.leftVol = chn.rightVol = ResampleCacheUnityVolume;
+		chn.position += chn.increment * static_cast<int32>(numCached - firstFrame);
+		entry->frames.resize((firstFrame + numSamples) * 2, 0);
+		mixFunc(chn, resampler, entry->frames.data() + numCached * 2, numMissing);
+		chn.leftVol = leftVol;
+		chn.rightVol = rightVol;
+		chn.position = SamplePosition(position);
+		cache.hits += numSamples - numMissing;
+		cache.misses += numMissing;
+	} else
+	{
+		cache.hits += numSamples;
+	}
+
+	// Apply volume in the same way as the Ramp / NoRamp mix functions
+	const mixsample_t *cached = entry->frames.data() + firstFrame * 2;
+	if(chn.nRampLength)
+	{
+		int32 lRamp = chn.rampLeftVol, rRamp = chn.rampRightVol;
+		for(uint32 i = 0; i < numSamples; i++)
+		{
+			lRamp += chn.leftRamp;
+			rRamp += chn.rightRamp;
+#ifdef MPT_INTMIXER
+			pbuffer[i * 2] += cached[i * 2] * (lRamp >> VOLUMERAMPPRECISION);
+			pbuffer[i * 2 + 1] += cached[i * 2 + 1] * (rRamp >> VOLUMERAMPPRECISION);
+#else
+			pbuffer[i * 2] += cached[i * 2] * (lRamp >> VOLUMERAMPPRECISION) * (1.0f / 4096.0f);
+			pbuffer[i * 2 + 1] += cached[i * 2 + 1] * (rRamp >> VOLUMERAMPPRECISION) * (1.0f / 4096.0f);
+#endif // MPT_INTMIXER
+		}
+		chn.rampLeftVol = lRamp; chn.leftVol = lRamp >> VOLUMERAMPPRECISION;
+		chn.rampRightVol = rRamp; chn.rightVol = rRamp >> VOLUMERAMPPRECISION;
+	} else
+	{
+#ifdef MPT_INTMIXER
+		const mixsample_t lVol = chn.leftVol, rVol = chn.rightVol;
+#else
+		const mixsample_t lVol = static_cast<mixsample_t>(chn.leftVol) * (1.0f / 4096.0f), rVol = static_cast<mixsample_t>(chn.rightVol) * (1.0f / 4096.0f);
+#endif // MPT_INTMIXER
+		for(uint32 i = 0; i < numSamples; i++)
+		{
+			pbuffer[i * 2] += cached[i * 2] * lVol;
+			pbuffer[i * 2 + 1] += cached[i * 2 + 1] * rVol;
+		}
+	}
+	chn.position += chn.increment * static_cast<int32>(numSamples);
+	return true;
+}
+
+
 // Render count * number of channels samples
 void CSoundFile::CreateStereoMix(int count)
 {
@@ -283,8 +405,26 @@ void CSoundFile::CreateStereoMix(int count)
 	if(m_MixerSettings.gnChannels > 2) InitMixBuffer(MixRearBuffer, count*2);
 
 	CHANNELINDEX nchmixed = 0;
+	uint32 skippedFrames = 0;
 
-	const bool ITPingPongMode = m_playBehaviour[kITPingPongMode];
+#ifdef MPT_ENABLE_THREAD
+	// Voices can only be mixed in parallel if the mix channel limit cannot be reached, as it depends on the order in which voices are mixed.
+	bool useMixJobs = m_mixThreadPool && m_nMixChannels <= m_MixerSettings.m_nMaxMixChannels;
+#ifdef MODPLUG_TRACKER
+	useMixJobs = useMixJobs && (m_SamplePlayLengths == nullptr);
+#endif // MODPLUG_TRACKER
+	std::size_t numJobVoices = 0;
+	if(useMixJobs)
+	{
+		for(auto &job : m_mixJobs)
+		{
+			job.voices.clear();
+			job.useRear = job.useReverb = false;
+			job.numMixed = 0;
+			job.skippedFrames = 0;
+		}
+	}
+#endif // MPT_ENABLE_THREAD
 
 	for(uint32 nChn = 0; nChn < m_nMixChannels; nChn++)
 	{
@@ -294,17 +434,12 @@ void CSoundFile::CreateStereoMix(int count)
 		pOfsR = &gnDryROfsVol;
 		pOfsL = &gnDryLOfsVol;
 
-		uint32 functionNdx = MixFuncTable::ResamplingModeToMixFlags(static_cast<ResamplingMode>(chn.resamplingMode));
-		if(chn.dwFlags[CHN_16BIT]) functionNdx |= MixFuncTable::ndx16Bit;
-		if(chn.dwFlags[CHN_STEREO]) functionNdx |= MixFuncTable::ndxStereo;
-#ifndef NO_FILTER
-		if(chn.dwFlags[CHN_FILTER]) functionNdx |= MixFuncTable::ndxFilter;
-#endif
-
 		mixsample_t *pbuffer = MixSoundBuffer;
+		bool mixToReverb = false, mixToPlugin = false;
 #ifndef NO_REVERB
 		if(((m_MixerSettings.DSPMask & SNDDSP_REVERB) && !chn.dwFlags[CHN_NOREVERB]) || chn.dwFlags[CHN_REVERB])
 		{
+			mixToReverb = true;
 			pbuffer = m_Reverb.GetReverbSendBuffer(count);
 			pOfsR = &m_Reverb.gnRvbROfsVol;
 			pOfsL = &m_Reverb.gnRvbLOfsVol;
@@ -324,6 +459,7 @@ void CSoundFile::CreateStereoMix(int count)
 			if (mixState.pMixBuffer)
 			{
 				pbuffer = mixState.pMixBuffer;
+				mixToPlugin = true;
 				pOfsR = &mixState.nVolDecayR;
 				pOfsL = &mixState.nVolDecayL;
 				if (!(mixState.dwFlags & SNDMIXPLUGINSTATE::psfMixReady))
@@ -335,142 +471,312 @@ void CSoundFile::CreateStereoMix(int count)
 		}
 #endif // NO_PLUGINS
 
-		MixLoopState mixLoopState(chn);
+#ifdef MPT_ENABLE_THREAD
+		// Voices that are not routed to a plugin are mixed by the worker threads later
+		if(useMixJobs && !mixToPlugin)
+		{
+			MixJob &job = m_mixJobs[numJobVoices++ % m_mixJobs.size()];
+			MixJob::Target target = MixJob::targetDry;
+			if(pbuffer == MixRearBuffer)
+				target = mixToReverb ? MixJob::targetRearReverbOfs : MixJob::targetRear;
+			else if(mixToReverb)
+				target = MixJob::targetReverb;
+			job.voices.push_back({ m_PlayState.ChnMix[nChn], target });
+			job.useRear = job.useRear || (pbuffer == MixRearBuffer);
+			job.useReverb = job.useReverb || mixToReverb;
+			continue;
+		}
+#else
+		MPT_UNUSED_VARIABLE(mixToReverb);
+		MPT_UNUSED_VARIABLE(mixToPlugin);
+#endif // MPT_ENABLE_THREAD
 
-		////////////////////////////////////////////////////
-		CHANNELINDEX naddmix = 0;
-		int nsamples = count;
-		// Keep mixing this sample until the buffer is filled.
-		do
+		const CHANNELINDEX naddmix = MixVoice(chn, pbuffer, *pOfsR, *pOfsL, count, nchmixed >= m_MixerSettings.m_nMaxMixChannels, skippedFrames, m_ResampleCache.IsEnabled() ? &m_ResampleCache : nullptr);
+		nchmixed += naddmix;
+	
+#ifndef NO_PLUGINS
+		if(naddmix && nMixPlugin > 0 && nMixPlugin <= MAX_MIXPLUGINS && m_MixPlugins[nMixPlugin - 1].pMixPlugin)
 		{
-			uint32 nrampsamples = nsamples;
-			int32 nSmpCount;
-			if(chn.nRampLength > 0)
-			{
-				if (nrampsamples > chn.nRampLength) nrampsamples = chn.nRampLength;
-			}
+			m_MixPlugins[nMixPlugin - 1].pMixPlugin->ResetSilence();
+		}
+#endif // NO_PLUGINS
+	}
 
-			if((nSmpCount = mixLoopState.GetSampleCount(chn, nrampsamples, ITPingPongMode)) <= 0)
-			{
-				// Stopping the channel
-				chn.pCurrentSample = nullptr;
-				chn.nLength = 0;
-				chn.position.Set(0);
-				chn.nRampLength = 0;
-				EndChannelOfs(chn, pbuffer, nsamples);
-				*pOfsR += chn.nROfs;
-				*pOfsL += chn.nLOfs;
-				chn.nROfs = chn.nLOfs = 0;
-				chn.dwFlags.reset(CHN_PINGPONGFLAG);
-				break;
-			}
+#ifdef MPT_ENABLE_THREAD
+	if(numJobVoices > 0)
+	{
+		RunMixJobs(count);
+		for(const auto &job : m_mixJobs)
+		{
+			nchmixed += job.numMixed;
+			skippedFrames += job.skippedFrames;
+		}
+	}
+#endif // MPT_ENABLE_THREAD
 
-			// Should we mix this channel ?
-			if((nchmixed >= m_MixerSettings.m_nMaxMixChannels)				// Too many channels
-				|| (!chn.nRampLength && !(chn.leftVol | chn.rightVol)))		// Channel is completely silent
-			{
-				chn.position += chn.increment * nSmpCount;
-				chn.nROfs = chn.nLOfs = 0;
-				pbuffer += nSmpCount * 2;
-				naddmix = 0;
-			}
+	m_nMixStat = std::max<CHANNELINDEX>(m_nMixStat, nchmixed);
+	m_silentFramesSkipped += skippedFrames;
+	m_renderProfile.voicesMixed += nchmixed;
+}
+
+
+// Mix count samples of a single voice into pbuffer, adding the remaining click removal offsets to ofsR / ofsL if the voice stops.
+// The number of frames that were not rendered because only silent sampling points would have been read is added to skippedFrames.
+// If resampleCache is not null, interpolated sampling points are taken from and added to the given cache where possible.
+// Returns 1 if the voice was audible, 0 otherwise.
+// This function only modifies chn and the given buffers, so different voices can be mixed on different threads.
+CHANNELINDEX CSoundFile::MixVoice(ModChannel &chn, mixsample_t *pbuffer, mixsample_t &ofsR, mixsample_t &ofsL, int count, bool mixLimitReached, uint32 &skippedFrames, ResampleCache *resampleCache) const
+{
+	const bool ITPingPongMode = m_playBehaviour[kITPingPongMode];
+
+	uint32 functionNdx = MixFuncTable::ResamplingModeToMixFlags(static_cast<ResamplingMode>(chn.resamplingMode));
+	if(chn.dwFlags[CHN_16BIT]) functionNdx |= MixFuncTable::ndx16Bit;
+	if(chn.dwFlags[CHN_STEREO]) functionNdx |= MixFuncTable::ndxStereo;
+#ifndef NO_FILTER
+	if(chn.dwFlags[CHN_FILTER]) functionNdx |= MixFuncTable::ndxFilter;
+#endif
+	const MixFuncInterface *mixFunctions = MixFuncTable::GetFunctions();
+
+	MixLoopState mixLoopState(chn);
+
+	////////////////////////////////////////////////////
+	CHANNELINDEX naddmix = 0;
+	int nsamples = count;
+	// Keep mixing this sample until the buffer is filled.
+	do
+	{
+		uint32 nrampsamples = nsamples;
+		int32 nSmpCount;
+		if(chn.nRampLength > 0)
+		{
+			if (nrampsamples > chn.nRampLength) nrampsamples = chn.nRampLength;
+		}
+
+		if((nSmpCount = mixLoopState.GetSampleCount(chn, nrampsamples, ITPingPongMode)) <= 0)
+		{
+			// Stopping the channel
+			chn.pCurrentSample = nullptr;
+			chn.nLength = 0;
+			chn.position.Set(0);
+			chn.nRampLength = 0;
+			EndChannelOfs(chn, pbuffer, nsamples);
+			ofsR += chn.nROfs;
+			ofsL += chn.nLOfs;
+			chn.nROfs = chn.nLOfs = 0;
+			chn.dwFlags.reset(CHN_PINGPONGFLAG);
+			break;
+		}
+
+		// Should we mix this channel ?
+		if(mixLimitReached												// Too many channels
+			|| (!chn.nRampLength && !(chn.leftVol | chn.rightVol)))		// Channel is completely silent
+		{
+			chn.position += chn.increment * nSmpCount;
+			chn.nROfs = chn.nLOfs = 0;
+			pbuffer += nSmpCount * 2;
+			naddmix = 0;
+		}
 #ifdef MODPLUG_TRACKER
-			else if(m_SamplePlayLengths != nullptr)
+		else if(m_SamplePlayLengths != nullptr)
+		{
+			// Detecting the longest play time for each sample for optimization
+			chn.position += chn.increment * nSmpCount;
+			size_t smp = std::distance<const ModSample *>(Samples, chn.pModSample);
+			if(smp < m_SamplePlayLengths->size())
 			{
-				// Detecting the longest play time for each sample for optimization
-				chn.position += chn.increment * nSmpCount;
-				size_t smp = std::distance<const ModSample *>(Samples, chn.pModSample);
-				if(smp < m_SamplePlayLengths->size())
-				{
-					m_SamplePlayLengths->at(smp) = std::max(m_SamplePlayLengths->at(smp), chn.position.GetUInt());
-				}
+				m_SamplePlayLengths->at(smp) = std::max(m_SamplePlayLengths->at(smp), chn.position.GetUInt());
 			}
+		}
 #endif
-			else
-			{
-				// Do mixing
-				mixsample_t *pbufmax = pbuffer + (nSmpCount * 2);
-				chn.nROfs = -*(pbufmax - 2);
-				chn.nLOfs = -*(pbufmax - 1);
+		else if(IsSilentSpan(chn, nSmpCount))
+		{
+			// Skip silent part of the sample
+			chn.position += chn.increment * nSmpCount;
+			chn.nROfs = chn.nLOfs = 0;
+			pbuffer += nSmpCount * 2;
+			skippedFrames += nSmpCount;
+			naddmix = 1;
+		}
+		else
+		{
+			// Do mixing
+			mixsample_t *pbufmax = pbuffer + (nSmpCount * 2);
+			chn.nROfs = -*(pbufmax - 2);
+			chn.nLOfs = -*(pbufmax - 1);
 
 #ifdef MPT_BUILD_DEBUG
-				SamplePosition targetpos = chn.position + chn.increment * nSmpCount;
+			SamplePosition targetpos = chn.position + chn.increment * nSmpCount;
 #endif
-				MixFuncTable::Functions[functionNdx | (chn.nRampLength ? MixFuncTable::ndxRamp : 0)](chn, m_Resampler, pbuffer, nSmpCount);
+			if(resampleCache == nullptr || !MixFromResampleCache(*resampleCache, chn, functionNdx, mixFunctions[functionNdx], m_Resampler, pbuffer, nSmpCount))
+			{
+				mixFunctions[functionNdx | (chn.nRampLength ? MixFuncTable::ndxRamp : 0)](chn, m_Resampler, pbuffer, nSmpCount);
+			}
 #ifdef MPT_BUILD_DEBUG
-				MPT_ASSERT(chn.position.GetUInt() == targetpos.GetUInt());
+			MPT_ASSERT(chn.position.GetUInt() == targetpos.GetUInt());
 #endif
 
-				chn.nROfs += *(pbufmax - 2);
-				chn.nLOfs += *(pbufmax - 1);
-				pbuffer = pbufmax;
-				naddmix = 1;
-			}
+			chn.nROfs += *(pbufmax - 2);
+			chn.nLOfs += *(pbufmax - 1);
+			pbuffer = pbufmax;
+			naddmix = 1;
+		}
 
-			nsamples -= nSmpCount;
-			if (chn.nRampLength)
+		nsamples -= nSmpCount;
+		if (chn.nRampLength)
+		{
+			if (chn.nRampLength <= static_cast<uint32>(nSmpCount))
 			{
-				if (chn.nRampLength <= static_cast<uint32>(nSmpCount))
-				{
-					// Ramping is done
-					chn.nRampLength = 0;
-					chn.leftVol = chn.newLeftVol;
-					chn.rightVol = chn.newRightVol;
-					chn.rightRamp = chn.leftRamp = 0;
-					if(chn.dwFlags[CHN_NOTEFADE] && !chn.nFadeOutVol)
-					{
-						chn.nLength = 0;
-						chn.pCurrentSample = nullptr;
-					}
-				} else
+				// Ramping is done
+				chn.nRampLength = 0;
+				chn.leftVol = chn.newLeftVol;
+				chn.rightVol = chn.newRightVol;
+				chn.rightRamp = chn.leftRamp = 0;
+				if(chn.dwFlags[CHN_NOTEFADE] && !chn.nFadeOutVol)
 				{
-					chn.nRampLength -= nSmpCount;
+					chn.nLength = 0;
+					chn.pCurrentSample = nullptr;
 				}
+			} else
+			{
+				chn.nRampLength -= nSmpCount;
 			}
+		}
 
-			if(chn.position.GetUInt() >= chn.nLoopEnd && chn.dwFlags[CHN_LOOP])
+		if(chn.position.GetUInt() >= chn.nLoopEnd && chn.dwFlags[CHN_LOOP])
+		{
+			if(m_playBehaviour[kMODSampleSwap] && chn.nNewIns && chn.nNewIns <= GetNumSamples() && chn.pModSample != &Samples.Get(chn.nNewIns))
 			{
-				if(m_playBehaviour[kMODSampleSwap] && chn.nNewIns && chn.nNewIns <= GetNumSamples() && chn.pModSample != &Samples[chn.nNewIns])
-				{
-					// ProTracker compatibility: Instrument changes without a note do not happen instantly, but rather when the sample loop has finished playing.
-					// Test case: PTInstrSwap.mod
-					const ModSample &smp = Samples[chn.nNewIns];
-					chn.pModSample = &smp;
-					chn.pCurrentSample = smp.samplev();
-					chn.dwFlags = (chn.dwFlags & CHN_CHANNELFLAGS) | smp.uFlags;
-					chn.nLength = smp.uFlags[CHN_LOOP] ? smp.nLoopEnd : smp.nLength;
-					chn.nLoopStart = smp.nLoopStart;
-					chn.nLoopEnd = smp.nLoopEnd;
-					chn.position.SetInt(chn.nLoopStart);
-					mixLoopState.UpdateLookaheadPointers(chn);
-					if(!chn.pCurrentSample)
-					{
-						break;
-					}
-				} else if(m_playBehaviour[kMODOneShotLoops] && chn.nLoopStart == 0)
+				// ProTracker compatibility: Instrument changes without a note do not happen instantly, but rather when the sample loop has finished playing.
+				// Test case: PTInstrSwap.mod
+				const ModSample &smp = Samples.Get(chn.nNewIns);
+				chn.pModSample = &smp;
+				chn.pCurrentSample = smp.samplev();
+				chn.dwFlags = (chn.dwFlags & CHN_CHANNELFLAGS) | smp.uFlags;
+				chn.nLength = smp.uFlags[CHN_LOOP] ? smp.nLoopEnd : smp.nLength;
+				chn.nLoopStart = smp.nLoopStart;
+				chn.nLoopEnd = smp.nLoopEnd;
+				chn.position.SetInt(chn.nLoopStart);
+				mixLoopState.UpdateLookaheadPointers(chn);
+				if(!chn.pCurrentSample)
 				{
-					// ProTracker "oneshot" loops (if loop start is 0, play the whole sample once and then repeat until loop end)
-					chn.position.SetInt(0);
-					chn.nLoopEnd = chn.nLength = chn.pModSample->nLoopEnd;
+					break;
 				}
+			} else if(m_playBehaviour[kMODOneShotLoops] && chn.nLoopStart == 0)
+			{
+				// ProTracker "oneshot" loops (if loop start is 0, play the whole sample once and then repeat until loop end)
+				chn.position.SetInt(0);
+				chn.nLoopEnd = chn.nLength = chn.pModSample->nLoopEnd;
 			}
-		} while(nsamples > 0);
+		}
+	} while(nsamples > 0);
 
-		// Restore sample pointer in case it got changed through loop wrap-around
-		chn.pCurrentSample = mixLoopState.samplePointer;
-		nchmixed += naddmix;
-	
-#ifndef NO_PLUGINS
-		if(naddmix && nMixPlugin > 0 && nMixPlugin <= MAX_MIXPLUGINS && m_MixPlugins[nMixPlugin - 1].pMixPlugin)
+	// Restore sample pointer in case it got changed through loop wrap-around
+	chn.pCurrentSample = mixLoopState.samplePointer;
+
+	return naddmix;
+}
+
+
+#ifdef MPT_ENABLE_THREAD
+
+// Create or destroy mixer worker threads according to the current mixer settings
+void CSoundFile::UpdateMixThreads()
+{
+	const uint32 numThreads = m_MixerSettings.NumMixThreads;
+	if(numThreads <= 1)
+	{
+		m_mixThreadPool.reset();
+		m_mixJobs.clear();
+	} else if(!m_mixThreadPool || m_mixThreadPool->GetNumThreads() != numThreads)
+	{
+		m_mixThreadPool.reset();
+		m_mixThreadPool = mpt::make_unique<mpt::ThreadPool>(numThreads);
+		m_mixJobs.resize(numThreads);
+		for(auto &job : m_mixJobs)
 		{
-			m_MixPlugins[nMixPlugin - 1].pMixPlugin->ResetSilence();
+			job.voices.reserve(MAX_CHANNELS / numThreads + 1);
 		}
-#endif // NO_PLUGINS
 	}
-	m_nMixStat = std::max<CHANNELINDEX>(m_nMixStat, nchmixed);
 }
 
 
+// Mix all voices that have been assigned to mix jobs in CreateStereoMix and add the partial mixes to the output buffers
+void CSoundFile::RunMixJobs(int count)
+{
+	const std::size_t numJobs = std::count_if(m_mixJobs.begin(), m_mixJobs.end(), [](const MixJob &job) { return !job.voices.empty(); });
+	m_mixThreadPool->Run(numJobs, [this, count](std::size_t jobIndex)
+	{
+		MixJob &job = m_mixJobs[jobIndex];
+		InitMixBuffer(job.dryBuffer.data(), count * 2);
+		if(job.useRear)
+			InitMixBuffer(job.rearBuffer.data(), count * 2);
+		if(job.useReverb)
+			InitMixBuffer(job.reverbBuffer.data(), count * 2);
+		job.dryOfsR = job.dryOfsL = job.reverbOfsR = job.reverbOfsL = 0;
+		job.numMixed = 0;
+		job.skippedFrames = 0;
+		for(const auto &voice : job.voices)
+		{
+			mixsample_t *pbuffer = job.dryBuffer.data();
+			mixsample_t *pOfsR = &job.dryOfsR, *pOfsL = &job.dryOfsL;
+			switch(voice.target)
+			{
+			case MixJob::targetDry:
+				break;
+			case MixJob::targetReverb:
+				pbuffer = job.reverbBuffer.data();
+				pOfsR = &job.reverbOfsR;
+				pOfsL = &job.reverbOfsL;
+				break;
+			case MixJob::targetRear:
+				pbuffer = job.rearBuffer.data();
+				break;
+			case MixJob::targetRearReverbOfs:
+				pbuffer = job.rearBuffer.data();
+				pOfsR = &job.reverbOfsR;
+				pOfsL = &job.reverbOfsL;
+				break;
+			}
+			job.numMixed += MixVoice(m_PlayState.Chn[voice.channel], pbuffer, *pOfsR, *pOfsL, count, false, job.skippedFrames, nullptr);
+		}
+	});
+
+	// Reduce partial mixes in a fixed order. As the mixer uses integer arithmetic, the result is identical to mixing all voices on a single thread.
+	for(std::size_t i = 0; i < numJobs; i++)
+	{
+		const MixJob &job = m_mixJobs[i];
+		for(int j = 0; j < count * 2; j++)
+		{
+			MixSoundBuffer[j] += job.dryBuffer[j];
+		}
+		gnDryROfsVol += job.dryOfsR;
+		gnDryLOfsVol += job.dryOfsL;
+		if(job.useRear)
+		{
+			for(int j = 0; j < count * 2; j++)
+			{
+				MixRearBuffer[j] += job.rearBuffer[j];
+			}
+		}
+#ifndef NO_REVERB
+		if(job.useReverb)
+		{
+			// The reverb send buffer has already been initialized when the voices were assigned to the jobs
+			mixsample_t *reverbBuffer = m_Reverb.GetReverbSendBuffer(count);
+			for(int j = 0; j < count * 2; j++)
+			{
+				reverbBuffer[j] += job.reverbBuffer[j];
+			}
+			m_Reverb.gnRvbROfsVol += job.reverbOfsR;
+			m_Reverb.gnRvbLOfsVol += job.reverbOfsL;
+		}
+#endif // NO_REVERB
+	}
+}
+
+#endif // MPT_ENABLE_THREAD
+
+
 void CSoundFile::ProcessPlugins(uint32 nCount)
 {
 #ifndef NO_PLUGINS
@@ -125,7 +125,7 @@ struct FIRFilterInterpolation
 
 	MPT_FORCEINLINE void Start(const ModChannel &, const CResampler &resampler)
 	{
-		WFIRlut = resampler.m_WindowedFIR.lut;
+		WFIRlut = resampler.m_WindowedFIR->lut;
 	}
 
 	MPT_FORCEINLINE void End(const ModChannel &) { }
@@ -151,6 +151,42 @@ struct FIRFilterInterpolation
 };
 
 
+template<class Traits, int width>
+struct HighOrderPolyphaseInterpolation
+{
+	const float *sinc;
+
+	MPT_FORCEINLINE void Start(const ModChannel &chn, const CResampler &resampler)
+	{
+		const HighOrderSincTables &tables = *((width == 16) ? resampler.gSinc16 : resampler.gSinc32);
+		sinc = (((chn.increment > SamplePosition(0x130000000ll)) || (chn.increment < SamplePosition(-0x130000000ll))) ?
+			(((chn.increment > SamplePosition(0x180000000ll)) || (chn.increment < SamplePosition(-0x180000000ll))) ? tables.downsample2x.data() : tables.downsample13x.data()) : tables.kaiserSinc.data());
+	}
+
+	MPT_FORCEINLINE void End(const ModChannel &) { }
+
+	MPT_FORCEINLINE void operator() (typename Traits::outbuf_t &outSample, const typename Traits::input_t * const inBuffer, const uint32 posLo)
+	{
+		static_assert(Traits::numChannelsIn <= Traits::numChannelsOut, "Too many input channels");
+		const float *lut = sinc + ((posLo >> (32 - SINC_PHASES_BITS)) & SINC_MASK) * width;
+		const typename Traits::input_t *in = inBuffer - (width / 2 - 1) * Traits::numChannelsIn;
+
+		for(int i = 0; i < Traits::numChannelsIn; i++)
+		{
+			typename Traits::output_t sum = 0;
+			for(int tap = 0; tap < width; tap++)
+			{
+				sum += lut[tap] * Traits::Convert(in[i + tap * Traits::numChannelsIn]);
+			}
+			outSample[i] = sum;
+		}
+	}
+};
+
+template<class Traits> using Polyphase16Interpolation = HighOrderPolyphaseInterpolation<Traits, 16>;
+template<class Traits> using Polyphase32Interpolation = HighOrderPolyphaseInterpolation<Traits, 32>;
+
+
 //////////////////////////////////////////////////////////////////////////
 // Mixing templates (add sample to stereo mix)
 
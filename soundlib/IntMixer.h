@@ -17,6 +17,10 @@
 #include "MixerInterface.h"
 #include "Paula.h"
 
+#ifdef ENABLE_SSE4
+#include <smmintrin.h>
+#endif
+
 OPENMPT_NAMESPACE_BEGIN
 
 template<int channelsOut, int channelsIn, typename out, typename in, size_t mixPrecision>
@@ -194,7 +198,7 @@ struct FIRFilterInterpolation
 
 	MPT_FORCEINLINE void Start(const ModChannel &, const CResampler &resampler)
 	{
-		WFIRlut = resampler.m_WindowedFIR.lut;
+		WFIRlut = resampler.m_WindowedFIR->lut;
 	}
 
 	MPT_FORCEINLINE void End(const ModChannel &) { }
@@ -222,6 +226,208 @@ struct FIRFilterInterpolation
 };
 
 
+// High-order polyphase interpolation with float coefficients (16 or 32 taps).
+// Each channel is accumulated in four partial sums (tap n goes to sum n % 4), which are combined as (sum0 + sum2) + (sum1 + sum3).
+// The SSE4.1 version below (only built with MSVC, see ENABLE_SSE4) uses the same order of operations, but the output of the two versions
+// is not bit-identical: the compiler is free to reorder and contract the float operations, and the default GCC / Clang flags include -ffast-math.
+// After rounding to the integer output type, the results may differ by one step.
+template<class Traits, int width>
+struct HighOrderPolyphaseInterpolation
+{
+	static_assert(width % 4 == 0 && width / 2 <= InterpolationMaxLookahead, "Unsupported filter width");
+
+	const float *sinc;
+
+	MPT_FORCEINLINE void Start(const ModChannel &chn, const CResampler &resampler)
+	{
+		const HighOrderSincTables &tables = *((width == 16) ? resampler.gSinc16 : resampler.gSinc32);
+		sinc = (((chn.increment > SamplePosition(0x130000000ll)) || (chn.increment < SamplePosition(-0x130000000ll))) ?
+			(((chn.increment > SamplePosition(0x180000000ll)) || (chn.increment < SamplePosition(-0x180000000ll))) ? tables.downsample2x.data() : tables.downsample13x.data()) : tables.kaiserSinc.data());
+	}
+
+	MPT_FORCEINLINE void End(const ModChannel &) { }
+
+	MPT_FORCEINLINE void operator() (typename Traits::outbuf_t &outSample, const typename Traits::input_t * const MPT_RESTRICT inBuffer, const uint32 posLo)
+	{
+		static_assert(Traits::numChannelsIn <= Traits::numChannelsOut, "Too many input channels");
+		const float *lut = sinc + ((posLo >> (32 - SINC_PHASES_BITS)) & SINC_MASK) * width;
+		const typename Traits::input_t *in = inBuffer - (width / 2 - 1) * Traits::numChannelsIn;
+
+		for(int i = 0; i < Traits::numChannelsIn; i++)
+		{
+			float sum[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+			for(int tap = 0; tap < width; tap++)
+			{
+				sum[tap % 4] += lut[tap] * static_cast<float>(Traits::Convert(in[i + tap * Traits::numChannelsIn]));
+			}
+			outSample[i] = static_cast<typename Traits::output_t>((sum[0] + sum[2]) + (sum[1] + sum[3]));
+		}
+	}
+};
+
+template<class Traits> using Polyphase16Interpolation = HighOrderPolyphaseInterpolation<Traits, 16>;
+template<class Traits> using Polyphase32Interpolation = HighOrderPolyphaseInterpolation<Traits, 32>;
+
+
+//////////////////////////////////////////////////////////////////////////
+// SSE4.1 interpolation templates (only built with MSVC, see ENABLE_SSE4)
+// The windowed FIR and Kaiser versions compute exactly the same integer sums as the scalar versions above
+// (the 16x16-bit products are exact and 32-bit addition is associative), so their output is bit-identical.
+// The high-order versions work on float and may differ by one step, see HighOrderPolyphaseInterpolation.
+
+#ifdef ENABLE_SSE4
+
+// Load eight sample values and convert them to 16-bit mix precision, i.e. apply IntToIntTraits<..., 16>::Convert
+static MPT_FORCEINLINE __m128i LoadSamplesSSE4(const int16 * const MPT_RESTRICT inBuffer)
+{
+	return _mm_loadu_si128(reinterpret_cast<const __m128i *>(inBuffer));
+}
+
+static MPT_FORCEINLINE __m128i LoadSamplesSSE4(const int8 * const MPT_RESTRICT inBuffer)
+{
+	return _mm_slli_epi16(_mm_cvtepi8_epi16(_mm_loadl_epi64(reinterpret_cast<const __m128i *>(inBuffer))), 8);
+}
+
+
+// Apply an 8-tap filter kernel to the samples surrounding inBuffer[0].
+// Lane n of sum1 receives the sum of the first four taps of channel n, lane n of sum2 the sum of the last four taps.
+template<typename input_t>
+static MPT_FORCEINLINE void FilterTapsSSE4(const int16 * const MPT_RESTRICT lut, const input_t * const MPT_RESTRICT inBuffer, std::integral_constant<int, 1>, __m128i &sum1, __m128i &sum2)
+{
+	const __m128i products = _mm_madd_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i *>(lut)), LoadSamplesSSE4(inBuffer - 3));	// 01 23 45 67
+	sum1 = _mm_add_epi32(products, _mm_shuffle_epi32(products, _MM_SHUFFLE(2, 3, 0, 1)));	// 0123 0123 4567 4567
+	sum2 = _mm_shuffle_epi32(sum1, _MM_SHUFFLE(3, 2, 3, 2));
+}
+
+template<typename input_t>
+static MPT_FORCEINLINE void FilterTapsSSE4(const int16 * const MPT_RESTRICT lut, const input_t * const MPT_RESTRICT inBuffer, std::integral_constant<int, 2>, __m128i &sum1, __m128i &sum2)
+{
+	// Reorder LRLRLRLR to LLRRLLRR so that each 32-bit product sum belongs to a single channel
+	const __m128i deinterleave = _mm_setr_epi8(0, 1, 4, 5, 2, 3, 6, 7, 8, 9, 12, 13, 10, 11, 14, 15);
+	const __m128i coeffs = _mm_loadu_si128(reinterpret_cast<const __m128i *>(lut));
+	const __m128i products1 = _mm_madd_epi16(_mm_shuffle_epi32(coeffs, _MM_SHUFFLE(1, 1, 0, 0)), _mm_shuffle_epi8(LoadSamplesSSE4(inBuffer - 6), deinterleave));	// L01 R01 L23 R23
+	const __m128i products2 = _mm_madd_epi16(_mm_shuffle_epi32(coeffs, _MM_SHUFFLE(3, 3, 2, 2)), _mm_shuffle_epi8(LoadSamplesSSE4(inBuffer + 2), deinterleave));	// L45 R45 L67 R67
+	sum1 = _mm_add_epi32(products1, _mm_shuffle_epi32(products1, _MM_SHUFFLE(1, 0, 3, 2)));
+	sum2 = _mm_add_epi32(products2, _mm_shuffle_epi32(products2, _MM_SHUFFLE(1, 0, 3, 2)));
+}
+
+
+template<class Traits>
+struct PolyphaseInterpolationSSE4 : public PolyphaseInterpolation<Traits>
+{
+	MPT_FORCEINLINE void operator() (typename Traits::outbuf_t &outSample, const typename Traits::input_t * const MPT_RESTRICT inBuffer, const uint32 posLo)
+	{
+		static_assert(Traits::numChannelsIn <= Traits::numChannelsOut, "Too many input channels");
+		static_assert(Traits::Convert(1) == (1 << (16 - sizeof(typename Traits::input_t) * 8)), "Samples must be converted to 16-bit precision");
+		const SINC_TYPE *lut = this->sinc + ((posLo >> (32 - SINC_PHASES_BITS)) & SINC_MASK) * SINC_WIDTH;
+
+		__m128i sum1, sum2;
+		FilterTapsSSE4(lut, inBuffer, std::integral_constant<int, Traits::numChannelsIn>(), sum1, sum2);
+		int32 vol[4];
+		_mm_storeu_si128(reinterpret_cast<__m128i *>(vol), _mm_add_epi32(sum1, sum2));
+
+		for(int i = 0; i < Traits::numChannelsIn; i++)
+		{
+			outSample[i] = vol[i] / (1 << SINC_QUANTSHIFT);
+		}
+	}
+};
+
+
+template<class Traits>
+struct FIRFilterInterpolationSSE4 : public FIRFilterInterpolation<Traits>
+{
+	MPT_FORCEINLINE void operator() (typename Traits::outbuf_t &outSample, const typename Traits::input_t * const MPT_RESTRICT inBuffer, const uint32 posLo)
+	{
+		static_assert(Traits::numChannelsIn <= Traits::numChannelsOut, "Too many input channels");
+		static_assert(Traits::Convert(1) == (1 << (16 - sizeof(typename Traits::input_t) * 8)), "Samples must be converted to 16-bit precision");
+		const int16 * const lut = this->WFIRlut + ((((posLo >> 16) + WFIR_FRACHALVE) >> WFIR_FRACSHIFT) & WFIR_FRACMASK);
+
+		__m128i sum1, sum2;
+		FilterTapsSSE4(lut, inBuffer, std::integral_constant<int, Traits::numChannelsIn>(), sum1, sum2);
+		int32 vol1[4], vol2[4];
+		_mm_storeu_si128(reinterpret_cast<__m128i *>(vol1), sum1);
+		_mm_storeu_si128(reinterpret_cast<__m128i *>(vol2), sum2);
+
+		for(int i = 0; i < Traits::numChannelsIn; i++)
+		{
+			outSample[i] = ((vol1[i] / 2) + (vol2[i] / 2)) / (1 << (WFIR_16BITSHIFT - 1));
+		}
+	}
+};
+
+// Load four consecutive mono sampling points as float, in 16-bit mix precision
+static MPT_FORCEINLINE __m128 LoadFloatSamplesSSE4(const int16 * const MPT_RESTRICT inBuffer)
+{
+	return _mm_cvtepi32_ps(_mm_cvtepi16_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i *>(inBuffer))));
+}
+
+static MPT_FORCEINLINE __m128 LoadFloatSamplesSSE4(const int8 * const MPT_RESTRICT inBuffer)
+{
+	int32 samples;
+	std::memcpy(&samples, inBuffer, sizeof(samples));
+	return _mm_cvtepi32_ps(_mm_slli_epi32(_mm_cvtepi8_epi32(_mm_cvtsi32_si128(samples)), 8));
+}
+
+// Load four consecutive stereo sampling points as float, in 16-bit mix precision, split into left and right channel
+template<typename input_t>
+static MPT_FORCEINLINE void LoadFloatSamplesSSE4(const input_t * const MPT_RESTRICT inBuffer, __m128 &left, __m128 &right)
+{
+	const __m128i deinterleave = _mm_setr_epi8(0, 1, 4, 5, 8, 9, 12, 13, 2, 3, 6, 7, 10, 11, 14, 15);
+	const __m128i samples = _mm_shuffle_epi8(LoadSamplesSSE4(inBuffer), deinterleave);	// LLLL RRRR
+	left = _mm_cvtepi32_ps(_mm_cvtepi16_epi32(samples));
+	right = _mm_cvtepi32_ps(_mm_cvtepi16_epi32(_mm_srli_si128(samples, 8)));
+}
+
+// Combine four partial sums in the same order as HighOrderPolyphaseInterpolation: (v0 + v2) + (v1 + v3)
+static MPT_FORCEINLINE float HorizontalSumSSE4(const __m128 v)
+{
+	const __m128 pairs = _mm_add_ps(v, _mm_movehl_ps(v, v));
+	return _mm_cvtss_f32(_mm_add_ss(pairs, _mm_shuffle_ps(pairs, pairs, _MM_SHUFFLE(1, 1, 1, 1))));
+}
+
+
+template<class Traits, int width>
+struct HighOrderPolyphaseInterpolationSSE4 : public HighOrderPolyphaseInterpolation<Traits, width>
+{
+	MPT_FORCEINLINE void operator() (typename Traits::outbuf_t &outSample, const typename Traits::input_t * const MPT_RESTRICT inBuffer, const uint32 posLo)
+	{
+		static_assert(Traits::numChannelsIn <= Traits::numChannelsOut, "Too many input channels");
+		static_assert(Traits::Convert(1) == (1 << (16 - sizeof(typename Traits::input_t) * 8)), "Samples must be converted to 16-bit precision");
+		const float *lut = this->sinc + ((posLo >> (32 - SINC_PHASES_BITS)) & SINC_MASK) * width;
+		const typename Traits::input_t *in = inBuffer - (width / 2 - 1) * Traits::numChannelsIn;
+
+		MPT_CONSTANT_IF(Traits::numChannelsIn == 1)
+		{
+			__m128 sum = _mm_setzero_ps();
+			for(int tap = 0; tap < width; tap += 4)
+			{
+				sum = _mm_add_ps(sum, _mm_mul_ps(_mm_loadu_ps(lut + tap), LoadFloatSamplesSSE4(in + tap)));
+			}
+			outSample[0] = static_cast<typename Traits::output_t>(HorizontalSumSSE4(sum));
+		} else
+		{
+			__m128 sumL = _mm_setzero_ps(), sumR = _mm_setzero_ps();
+			for(int tap = 0; tap < width; tap += 4)
+			{
+				const __m128 coeffs = _mm_loadu_ps(lut + tap);
+				__m128 left, right;
+				LoadFloatSamplesSSE4(in + tap * 2, left, right);
+				sumL = _mm_add_ps(sumL, _mm_mul_ps(coeffs, left));
+				sumR = _mm_add_ps(sumR, _mm_mul_ps(coeffs, right));
+			}
+			outSample[0] = static_cast<typename Traits::output_t>(HorizontalSumSSE4(sumL));
+			outSample[1] = static_cast<typename Traits::output_t>(HorizontalSumSSE4(sumR));
+		}
+	}
+};
+
+template<class Traits> using Polyphase16InterpolationSSE4 = HighOrderPolyphaseInterpolationSSE4<Traits, 16>;
+template<class Traits> using Polyphase32InterpolationSSE4 = HighOrderPolyphaseInterpolationSSE4<Traits, 32>;
+
+#endif // ENABLE_SSE4
+
+
 //////////////////////////////////////////////////////////////////////////
 // Mixing templates (add sample to stereo mix)
 
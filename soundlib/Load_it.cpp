@@ -806,11 +806,13 @@ bool CSoundFile::ReadIT(FileReader &file, ModLoadingFlags loadFlags)
 			} else if(!sample.uFlags[SMP_KEEPONDISK])
 			{
 				SampleIO sampleIO = sampleHeader.GetSampleFormat(fileHeader.cwtv);
-				if(loadFlags & loadSampleData)
+				if((loadFlags & loadSampleData) && !(loadFlags & deferSampleData))
 				{
 					sampleIO.ReadSample(sample, file);
 				} else
 				{
+					if(loadFlags & loadSampleData)
+						DeferSampleData(i + 1, sampleIO, file);
 					if(sampleIO.IsVariableLengthEncoded())
 						lastSampleCompressed = true;
 					else
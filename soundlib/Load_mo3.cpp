@@ -1411,12 +1411,27 @@ bool CSoundFile::ReadMO3(FileReader &file, ModLoadingFlags loadFlags)
 	// Now we can load Ogg samples with shared headers.
 	if(loadFlags & loadSampleData)
 	{
+		std::vector<SAMPLEINDEX> oggSamples;
 		for(SAMPLEINDEX smp = 1; smp <= m_nSamples; smp++)
 		{
-			MO3SampleChunk &sampleChunk = sampleChunks[smp - 1];
 			// Is this an Ogg sample?
-			if(!sampleChunk.chunk.IsValid())
-				continue;
+			if(sampleChunks[smp - 1].chunk.IsValid())
+				oggSamples.push_back(smp);
+		}
+
+		// The Ogg samples only read from each other's chunks, so they can be decoded in parallel.
+		// Each job works on its own copies of the file readers, and messages are only logged after all jobs have finished.
+		struct OggDecodeResult
+		{
+			std::vector<std::pair<LogLevel, mpt::ustring>> messages;
+			bool unsupported = false;
+		};
+		std::vector<OggDecodeResult> oggResults(oggSamples.size());
+		RunSampleDecodeJobs(oggSamples.size(), [&](std::size_t job)
+		{
+			const SAMPLEINDEX smp = oggSamples[job];
+			OggDecodeResult &result = oggResults[job];
+			MO3SampleChunk sampleChunk = sampleChunks[smp - 1];
 
 			SAMPLEINDEX sharedOggHeader = smp + sampleChunk.sharedHeader;
 			// Which chunk are we going to read the header from?
@@ -1450,9 +1465,9 @@ bool CSoundFile::ReadMO3(FileReader &file, ModLoadingFlags loadFlags)
 				mpt::ostringstream mergedStream(std::ios::binary);
 				mergedStream.imbue(std::locale::classic());
 
-				sampleChunks[sharedOggHeader - 1].chunk.Rewind();
-				FileReader sharedChunk = sampleChunks[sharedOggHeader - 1].chunk.ReadChunk(sampleChunk.headerSize);
+				FileReader sharedChunk = sampleChunks[sharedOggHeader - 1].chunk;
 				sharedChunk.Rewind();
+				sharedChunk = sharedChunk.ReadChunk(sampleChunk.headerSize);
 
 				std::vector<uint32> streamSerials;
 				Ogg::PageInfo oggPageInfo;
@@ -1499,9 +1514,9 @@ bool CSoundFile::ReadMO3(FileReader &file, ModLoadingFlags loadFlags)
 				mpt::ostringstream mergedStream(std::ios::binary);
 				mergedStream.imbue(std::locale::classic());
 
-				sampleChunks[sharedOggHeader - 1].chunk.Rewind();
-				FileReader sharedChunk = sampleChunks[sharedOggHeader - 1].chunk.ReadChunk(sampleChunk.headerSize);
+				FileReader sharedChunk = sampleChunks[sharedOggHeader - 1].chunk;
 				sharedChunk.Rewind();
+				sharedChunk = sharedChunk.ReadChunk(sampleChunk.headerSize);
 
 				std::vector<uint32> dataStreamSerials;
 				std::vector<uint32> headStreamSerials;
@@ -1558,13 +1573,13 @@ bool CSoundFile::ReadMO3(FileReader &file, ModLoadingFlags loadFlags)
 
 				if(headStreamSerials.size() > 1)
 				{
-					AddToLog(LogWarning, mpt::format(U_("Sample %1: Ogg Vorbis data with shared header and multiple logical bitstreams in header chunk found. This may be handled incorrectly."))(smp));
+					result.messages.emplace_back(LogWarning, mpt::format(U_("Sample %1: Ogg Vorbis data with shared header and multiple logical bitstreams in header chunk found. This may be handled incorrectly."))(smp));
 				} else if(dataStreamSerials.size() > 1)
 				{
-					AddToLog(LogWarning, mpt::format(U_("Sample %1: Ogg Vorbis sample with shared header and multiple logical bitstreams found. This may be handled incorrectly."))(smp));
+					result.messages.emplace_back(LogWarning, mpt::format(U_("Sample %1: Ogg Vorbis sample with shared header and multiple logical bitstreams found. This may be handled incorrectly."))(smp));
 				} else if((dataStreamSerials.size() == 1) && (headStreamSerials.size() == 1) && (dataStreamSerials[0] != headStreamSerials[0]))
 				{
-					AddToLog(LogInformation, mpt::format(U_("Sample %1: Ogg Vorbis data with shared header and different logical bitstream serials found."))(smp));
+					result.messages.emplace_back(LogInformation, mpt::format(U_("Sample %1: Ogg Vorbis data with shared header and different logical bitstream serials found."))(smp));
 				}
 
 				std::string mergedStreamData = mergedStream.str();
@@ -1585,7 +1600,8 @@ bool CSoundFile::ReadMO3(FileReader &file, ModLoadingFlags loadFlags)
 #else // !(MPT_WITH_VORBIS && MPT_WITH_VORBISFILE)
 
 			FileReader &sampleData = sampleChunk.chunk;
-			FileReader &headerChunk = sharedHeader ? sampleChunks[sharedOggHeader - 1].chunk : sampleData;
+			FileReader sharedHeaderChunk = sharedHeader ? sampleChunks[sharedOggHeader - 1].chunk : FileReader();
+			FileReader &headerChunk = sharedHeader ? sharedHeaderChunk : sampleData;
 #if defined(MPT_WITH_STBVORBIS)
 			std::size_t initialRead = sharedHeader ? sampleChunk.headerSize : headerChunk.GetLength();
 #endif // MPT_WITH_STBVORBIS
@@ -1594,7 +1610,7 @@ bool CSoundFile::ReadMO3(FileReader &file, ModLoadingFlags loadFlags)
 
 			headerChunk.Rewind();
 			if(sharedHeader && !headerChunk.CanRead(sampleChunk.headerSize))
-				continue;
+				return;
 
 #if defined(MPT_WITH_VORBIS) && defined(MPT_WITH_VORBISFILE)
 
@@ -1652,17 +1668,17 @@ bool CSoundFile::ReadMO3(FileReader &file, ModLoadingFlags loadFlags)
 						}
 					} else
 					{
-						unsupportedSamples = true;
+						result.unsupported = true;
 					}
 				} else
 				{
-					AddToLog(LogWarning, mpt::format(U_("Sample %1: Unsupported Ogg Vorbis chained stream found."))(smp));
-					unsupportedSamples = true;
+					result.messages.emplace_back(LogWarning, mpt::format(U_("Sample %1: Unsupported Ogg Vorbis chained stream found."))(smp));
+					result.unsupported = true;
 				}
 				ov_clear(&vf);
 			} else
 			{
-				unsupportedSamples = true;
+				result.unsupported = true;
 			}
 
 #elif defined(MPT_WITH_STBVORBIS)
@@ -1725,14 +1741,24 @@ bool CSoundFile::ReadMO3(FileReader &file, ModLoadingFlags loadFlags)
 				stb_vorbis_close(vorb);
 			} else
 			{
-				unsupportedSamples = true;
+				result.unsupported = true;
 			}
 
 #else // !VORBIS
 
-			unsupportedSamples = true;
+			result.unsupported = true;
 
 #endif // VORBIS
+		});
+
+		for(const auto &result : oggResults)
+		{
+			for(const auto &message : result.messages)
+			{
+				AddToLog(message.first, message.second);
+			}
+			if(result.unsupported)
+				unsupportedSamples = true;
 		}
 	}
 
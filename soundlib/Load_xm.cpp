@@ -42,7 +42,7 @@ static std::vector<SAMPLEINDEX> AllocateXMSamples(CSoundFile &sndFile, SAMPLEIND
 			// If too many sample slots are needed, try to fill some empty slots first.
 			for(SAMPLEINDEX j = 1; j <= sndFile.GetNumSamples(); j++)
 			{
-				if(sndFile.GetSample(j).HasSampleData())
+				if(sndFile.GetSample(j).HasSampleData() || sndFile.IsSampleDataDeferred(j))
 				{
 					continue;
 				}
@@ -552,7 +552,10 @@ bool CSoundFile::ReadXM(FileReader &file, ModLoadingFlags loadFlags)
 					FileReader sampleChunk = file.ReadChunk(sampleFlags[sample].GetEncoding() != SampleIO::ADPCM ? sampleSize[sample] : (16 + (sampleSize[sample] + 1) / 2));
 					if(sample < sampleSlots.size() && (loadFlags & loadSampleData))
 					{
-						sampleFlags[sample].ReadSample(Samples[sampleSlots[sample]], sampleChunk);
+						if(loadFlags & deferSampleData)
+							DeferSampleData(sampleSlots[sample], sampleFlags[sample], sampleChunk);
+						else
+							sampleFlags[sample].ReadSample(Samples[sampleSlots[sample]], sampleChunk);
 					}
 				}
 			}
@@ -17,6 +17,7 @@
 #include "Snd_defs.h"
 #include "ModChannel.h"
 #include "MixFuncTable.h"
+#include "../common/mptCPU.h"
 
 #ifdef MPT_INTMIXER
 #include "IntMixer.h"
@@ -57,7 +58,7 @@ namespace MixFuncTable
 	BuildMixFuncTableFilter(resampling, NoFilter), \
 	BuildMixFuncTableFilter(resampling, ResonantFilter)
 
-const MixFuncInterface Functions[6 * 16] =
+const MixFuncInterface Functions[8 * 16] =
 {
 	BuildMixFuncTable(NoInterpolation),			// No SRC
 	BuildMixFuncTable(LinearInterpolation),		// Linear SRC
@@ -65,14 +66,42 @@ const MixFuncInterface Functions[6 * 16] =
 	BuildMixFuncTable(PolyphaseInterpolation),	// Kaiser SRC
 	BuildMixFuncTable(FIRFilterInterpolation),	// FIR SRC
 	BuildMixFuncTable(AmigaBlepInterpolation),	// Amiga emulation
+	BuildMixFuncTable(Polyphase16Interpolation),	// 16-tap Kaiser SRC
+	BuildMixFuncTable(Polyphase32Interpolation),	// 32-tap Kaiser SRC
 };
 
+#if defined(MPT_INTMIXER) && defined(ENABLE_SSE4)
+const MixFuncInterface FunctionsSSE4[8 * 16] =
+{
+	BuildMixFuncTable(NoInterpolation),				// No SRC
+	BuildMixFuncTable(LinearInterpolation),			// Linear SRC
+	BuildMixFuncTable(FastSincInterpolation),		// Fast Sinc (Cubic Spline) SRC
+	BuildMixFuncTable(PolyphaseInterpolationSSE4),	// Kaiser SRC
+	BuildMixFuncTable(FIRFilterInterpolationSSE4),	// FIR SRC
+	BuildMixFuncTable(AmigaBlepInterpolation),		// Amiga emulation
+	BuildMixFuncTable(Polyphase16InterpolationSSE4),	// 16-tap Kaiser SRC
+	BuildMixFuncTable(Polyphase32InterpolationSSE4),	// 32-tap Kaiser SRC
+};
+#endif // MPT_INTMIXER && ENABLE_SSE4
+
 
 #undef BuildMixFuncTableRamp
 #undef BuildMixFuncTableFilter
 #undef BuildMixFuncTable
 
 
+const MixFuncInterface *GetFunctions()
+{
+#if defined(MPT_INTMIXER) && defined(ENABLE_SSE4)
+	if(GetProcSupport() & PROCSUPPORT_SSE4_1)
+	{
+		return FunctionsSSE4;
+	}
+#endif // MPT_INTMIXER && ENABLE_SSE4
+	return Functions;
+}
+
+
 ResamplingIndex ResamplingModeToMixFlags(ResamplingMode resamplingMode)
 {
 	switch(resamplingMode)
@@ -83,6 +112,8 @@ ResamplingIndex ResamplingModeToMixFlags(ResamplingMode resamplingMode)
 	case SRCMODE_SINC8LP:   return ndxKaiser;
 	case SRCMODE_SINC8:     return ndxFIRFilter;
 	case SRCMODE_AMIGA:     return ndxAmigaBlep;
+	case SRCMODE_SINC16:    return ndxSinc16;
+	case SRCMODE_SINC32:    return ndxSinc32;
 	default:                MPT_ASSERT_NOTREACHED();
 	}
 	return ndxNoInterpolation;
@@ -42,9 +42,22 @@ namespace MixFuncTable
 		ndxKaiser			= 0x30,
 		ndxFIRFilter		= 0x40,
 		ndxAmigaBlep		= 0x50,
+		ndxSinc16			= 0x60,
+		ndxSinc32			= 0x70,
 	};
 
-	extern const MixFuncInterface Functions[6 * 16];
+	extern const MixFuncInterface Functions[8 * 16];
+
+#if defined(MPT_INTMIXER) && defined(ENABLE_SSE4)
+	// SSE4.1 implementations. These may only be used if the processor supports SSE4.1.
+	// ENABLE_SSE4 is currently only defined for MSVC builds, so GCC and Clang builds always use the generic table.
+	extern const MixFuncInterface FunctionsSSE4[8 * 16];
+#endif // MPT_INTMIXER && ENABLE_SSE4
+
+	// Returns a table with the same layout as Functions, using the fastest implementations supported by the processor.
+	// The output of all implementations is identical, except for the float-based high-order polyphase resamplers,
+	// where the compiler's floating point optimizations may cause rounding differences.
+	const MixFuncInterface *GetFunctions();
 
 	ResamplingIndex ResamplingModeToMixFlags(ResamplingMode resamplingMode);
 }
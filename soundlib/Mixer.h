@@ -23,7 +23,8 @@ enum { MIXING_FILTER_PRECISION = 24 };	// Fixed point resonant filter bits
 typedef float mixsample_t;
 #endif
 
-#define MIXBUFFERSIZE 512
+#define MIXBUFFERSIZE 512	// Default render block size (in frames), and the maximum block size when plugins or the EQ are active
+#define MIXBUFFERSIZE_MAX 16384	// Maximum configurable render block size (in frames)
 #define NUMMIXINPUTBUFFERS 4
 
 #define VOLUMERAMPPRECISION 12	// Fractional bits in volume ramp variables
@@ -40,9 +41,8 @@ enum
 const float MIXING_SCALEF = static_cast<float>(1 << MIXING_FRACTIONAL_BITS);
 
 // The absolute maximum number of sampling points any interpolation algorithm is going to look at in any direction from the current sampling point
-// Currently, the maximum is 4 sampling points forwards and 3 sampling points backwards (Polyphase / FIR algorithms).
-// Hence, this value must be at least 4.
-// Note that choosing a higher value (e.g. 16) will reduce CPU usage when using many extremely short (length < 16) samples.
+// Currently, the maximum is 16 sampling points forwards and 15 sampling points backwards (32-tap Polyphase algorithm).
+// Hence, this value must be at least 16.
 #define InterpolationMaxLookahead	16u
 
 // Maximum size of a sampling point of a sample, in bytes.
@@ -25,7 +25,6 @@ void FloatToMonoMix(const float *pIn, int32 *pOut, uint32 uint32, const float _f
 
 #ifndef MODPLUG_TRACKER
 void ApplyGain(int32 *soundBuffer, std::size_t channels, std::size_t countChunk, int32 gainFactor16_16);
-void ApplyGain(float *outputBuffer, float * const *outputBuffers, std::size_t offset, std::size_t channels, std::size_t countChunk, float gainFactor);
 #endif // !MODPLUG_TRACKER
 
 void InitMixBuffer(mixsample_t *pBuffer, uint32 nSamples);
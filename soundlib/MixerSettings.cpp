@@ -10,6 +10,7 @@
 #include "stdafx.h"
 #include "MixerSettings.h"
 #include "Snd_defs.h"
+#include "Mixer.h"
 #include "../common/misc_util.h"
 
 OPENMPT_NAMESPACE_BEGIN
@@ -35,6 +36,13 @@ MixerSettings::MixerSettings()
 
 	NumInputChannels = 0;
 
+	NumMixThreads = 1;
+	RenderBlockSize = MIXBUFFERSIZE;
+	RenderTimeBudgetMicroseconds = 0;
+
+	// The cache only pays off for modules that play the same sample at the same pitch on several voices at once
+	ResampleCacheSize = 0;
+
 }
 
 int32 MixerSettings::GetVolumeRampUpSamples() const
@@ -28,6 +28,10 @@ struct MixerSettings
 	uint32 gnChannels;
 	uint32 m_nPreAmp;
 	std::size_t NumInputChannels;
+	uint32 NumMixThreads;	// Number of threads used for mixing sample voices (including the rendering thread), 1 = no worker threads
+	uint32 RenderBlockSize;	// Maximum number of frames that are rendered at once
+	uint32 ResampleCacheSize;	// Maximum size of the resample cache in bytes, 0 = disabled
+	uint32 RenderTimeBudgetMicroseconds;	// Time that a single Read() call may take before resampling quality is reduced, 0 = no limit
 
 	int32 VolumeRampUpMicroseconds;
 	int32 VolumeRampDownMicroseconds;
@@ -44,7 +48,7 @@ struct MixerSettings
 	
 	bool IsValid() const
 	{
-		return (gdwMixingFreq > 0) && (gnChannels == 1 || gnChannels == 2 || gnChannels == 4) && (NumInputChannels == 0 || NumInputChannels == 1 || NumInputChannels == 2 || NumInputChannels == 4);
+		return (gdwMixingFreq > 0) && (gnChannels == 1 || gnChannels == 2 || gnChannels == 4) && (NumInputChannels == 0 || NumInputChannels == 1 || NumInputChannels == 2 || NumInputChannels == 4) && (RenderBlockSize > 0);
 	}
 	
 	MixerSettings();
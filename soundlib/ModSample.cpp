@@ -14,6 +14,7 @@
 #include "modsmp_ctrl.h"
 
 #include <cmath>
+#include <cstdlib>
 
 
 OPENMPT_NAMESPACE_BEGIN
@@ -227,6 +228,7 @@ void ModSample::FreeSample()
 {
 	FreeSample(pData.pSample);
 	pData.pSample = nullptr;
+	InvalidatePeakMap();
 }
 
 
@@ -283,6 +285,73 @@ void ModSample::PrecomputeLoops(CSoundFile &sndFile, bool updateChannels)
 }
 
 
+template<typename T>
+static void ComputePeakMap(const T *sampleData, SmpLength numFrames, uint8 numChannels, std::vector<uint16> &peakMap, SmpLength firstBlock, SmpLength lastBlock)
+{
+	const int shift = (sizeof(T) == 1) ? 8 : 0;
+	for(SmpLength block = firstBlock; block <= lastBlock; block++)
+	{
+		const SmpLength start = block * ModSample::PeakMapBlockSize;
+		const SmpLength end = std::min(start + ModSample::PeakMapBlockSize, numFrames);
+		int peak = 0;
+		for(const T *s = sampleData + start * numChannels; s != sampleData + end * numChannels; s++)
+		{
+			peak = std::max(peak, std::abs(static_cast<int>(*s)));
+		}
+		peakMap[block] = static_cast<uint16>(peak << shift);
+	}
+}
+
+
+void ModSample::UpdatePeakMap()
+{
+	InvalidatePeakMap();
+	if(!HasSampleData())
+		return;
+	peakMap.resize((nLength + PeakMapBlockSize - 1) / PeakMapBlockSize);
+	if(peakMap.empty())
+		return;
+	if(GetElementarySampleSize() == 2)
+		ComputePeakMap(sample16(), nLength, GetNumChannels(), peakMap, 0, static_cast<SmpLength>(peakMap.size() - 1));
+	else
+		ComputePeakMap(sample8(), nLength, GetNumChannels(), peakMap, 0, static_cast<SmpLength>(peakMap.size() - 1));
+	peakMapData = samplev();
+}
+
+
+void ModSample::UpdatePeakMap(SmpLength first, SmpLength last)
+{
+	if(peakMapData == nullptr || peakMapData != samplev() || peakMap.size() != (nLength + PeakMapBlockSize - 1) / PeakMapBlockSize || !nLength)
+	{
+		UpdatePeakMap();
+		return;
+	}
+	LimitMax(first, nLength - 1);
+	LimitMax(last, nLength - 1);
+	if(first > last)
+		return;
+	if(GetElementarySampleSize() == 2)
+		ComputePeakMap(sample16(), nLength, GetNumChannels(), peakMap, first / PeakMapBlockSize, last / PeakMapBlockSize);
+	else
+		ComputePeakMap(sample8(), nLength, GetNumChannels(), peakMap, first / PeakMapBlockSize, last / PeakMapBlockSize);
+}
+
+
+bool ModSample::IsSilent(SmpLength first, SmpLength last) const
+{
+	if(peakMapData == nullptr || peakMapData != samplev() || peakMap.size() != (nLength + PeakMapBlockSize - 1) / PeakMapBlockSize || !nLength)
+		return false;
+	LimitMax(first, nLength - 1);
+	LimitMax(last, nLength - 1);
+	for(SmpLength block = first / PeakMapBlockSize; block <= last / PeakMapBlockSize; block++)
+	{
+		if(peakMap[block] != 0)
+			return false;
+	}
+	return true;
+}
+
+
 // Remove loop points if they're invalid.
 void ModSample::SanitizeLoops()
 {
@@ -12,6 +12,8 @@
 
 #include "BuildSettings.h"
 
+#include <vector>
+
 OPENMPT_NAMESPACE_BEGIN
 
 class CSoundFile;
@@ -49,6 +51,12 @@ struct ModSample
 		OPLPatch adlib;
 	};
 
+	// Peak amplitude of each block of PeakMapBlockSize frames (16-bit scale, maximum of all channels), computed in PrecomputeLoops.
+	// Used by the mixer to skip over silent parts of the sample.
+	static constexpr SmpLength PeakMapBlockSize = 64;
+	std::vector<uint16> peakMap;
+	const void *peakMapData = nullptr;	// Sample data that peakMap was computed for
+
 	ModSample(MODTYPE type = MOD_TYPE_NONE)
 	{
 		pData.pSample = nullptr;
@@ -131,6 +139,15 @@ struct ModSample
 	void FreeSample();
 	static void FreeSample(void *samplePtr);
 
+	// Recompute the block peak map from the current sample data
+	void UpdatePeakMap();
+	// Recompute only the peak map blocks covering the sampling points from first to last (inclusive), after they have been modified in place
+	void UpdatePeakMap(SmpLength first, SmpLength last);
+	// Discard the block peak map, e.g. because the sample data is about to be replaced
+	void InvalidatePeakMap() { peakMap.clear(); peakMapData = nullptr; }
+	// Returns true if all sampling points from first to last (inclusive) are known to be zero. Positions outside of the sample are clamped to the sample boundaries.
+	bool IsSilent(SmpLength first, SmpLength last) const;
+
 	// Set loop points and update loop wrap-around buffer
 	void SetLoop(SmpLength start, SmpLength end, bool enable, bool pingpong, CSoundFile &sndFile);
 	// Set sustain loop points and update loop wrap-around buffer
@@ -267,6 +267,20 @@ ModSequenceSet::ModSequenceSet(CSoundFile &sndFile)
 }
 
 
+ModSequenceSet& ModSequenceSet::operator=(const ModSequenceSet &other)
+{
+	if(&other == this)
+		return *this;
+	m_Sequences.assign(other.m_Sequences.size(), ModSequence(m_sndFile));
+	for(size_t seq = 0; seq < other.m_Sequences.size(); seq++)
+	{
+		m_Sequences[seq] = other.m_Sequences[seq];
+	}
+	m_currentSeq = other.m_currentSeq;
+	return *this;
+}
+
+
 void ModSequenceSet::Initialize()
 {
 	m_currentSeq = 0;
@@ -133,6 +133,8 @@ protected:
 public:
 	ModSequenceSet(CSoundFile &sndFile);
 	ModSequenceSet(ModSequenceSet &&) noexcept = default;
+	// Copy all sequences of another set. The copies belong to this set's CSoundFile.
+	ModSequenceSet& operator=(const ModSequenceSet &other);
 
 	// Remove all sequences and initialize default sequence
 	void Initialize();
@@ -0,0 +1,108 @@
+/*
+ * ResampleCache.cpp
+ * -----------------
+ * Purpose: Cache of resampled sample data that can be shared between voices playing the same sample at the same pitch.
+ * Notes  : (currently none)
+ * Authors: OpenMPT Devs
+ * The OpenMPT source code is released under the BSD license. Read LICENSE for more details.
+ */
+
+
+#include "stdafx.h"
+#include "ResampleCache.h"
+
+#include <limits>
+#include <tuple>
+
+
+OPENMPT_NAMESPACE_BEGIN
+
+
+bool ResampleCache::Key::operator<(const Key &other) const
+{
+	return std::tie(sampleData, sampleLength, increment, phase, mixFlags)
+		< std::tie(other.sampleData, other.sampleLength, other.increment, other.phase, other.mixFlags);
+}
+
+
+void ResampleCache::SetMaxSize(size_t maxSize)
+{
+	m_maxSize = maxSize;
+	EvictUntil(maxSize);
+}
+
+
+void ResampleCache::Clear()
+{
+	m_entries.clear();
+	m_lru.clear();
+	m_size = 0;
+}
+
+
+void ResampleCache::Invalidate(const void *sampleData)
+{
+	// Entries are ordered by sample data first, so all entries of this sample are next to each other
+	const Key first = { sampleData, 0, std::numeric_limits<int64>::min(), std::numeric_limits<int64>::min(), 0 };
+	auto entry = m_entries.lower_bound(first);
+	while(entry != m_entries.end() && entry->first.sampleData == sampleData)
+	{
+		m_size -= GetEntrySize(entry->second.maxFrames);
+		m_lru.erase(entry->second.lruPos);
+		entry = m_entries.erase(entry);
+	}
+}
+
+
+ResampleCache::Entry *ResampleCache::Find(const Key &key)
+{
+	auto entry = m_entries.find(key);
+	if(entry == m_entries.end())
+		return nullptr;
+	m_lru.splice(m_lru.begin(), m_lru, entry->second.lruPos);
+	return &entry->second;
+}
+
+
+ResampleCache::Entry *ResampleCache::Create(const Key &key, size_t maxFrames)
+{
+	// Don't let a single sample push out everything else
+	const size_t entrySize = GetEntrySize(maxFrames);
+	if(!maxFrames || entrySize > m_maxSize / 4)
+		return nullptr;
+
+	EvictUntil(m_maxSize - entrySize);
+
+	auto inserted = m_entries.emplace(key, Entry());
+	Entry &entry = inserted.first->second;
+	if(inserted.second)
+	{
+		m_lru.push_front(&inserted.first->first);
+		entry.lruPos = m_lru.begin();
+	} else
+	{
+		m_lru.splice(m_lru.begin(), m_lru, entry.lruPos);
+	}
+	m_size -= GetEntrySize(entry.maxFrames);
+	entry.frames.clear();
+	entry.frames.reserve(maxFrames * 2);
+	entry.maxFrames = maxFrames;
+	m_size += entrySize;
+	return &entry;
+}
+
+
+// Remove least recently used entries until the cache is not bigger than maxSize bytes
+void ResampleCache::EvictUntil(size_t maxSize)
+{
+	while(m_size > maxSize && !m_lru.empty())
+	{
+		auto oldest = m_entries.find(*m_lru.back());
+		m_lru.pop_back();
+		m_size -= GetEntrySize(oldest->second.maxFrames);
+		m_entries.erase(oldest);
+	}
+}
+
+
+OPENMPT_NAMESPACE_END
@@ -0,0 +1,87 @@
+/*
+ * ResampleCache.h
+ * ---------------
+ * Purpose: Cache of resampled sample data that can be shared between voices playing the same sample at the same pitch.
+ * Notes  : The cache stores the output of the interpolation functions before volume is applied,
+ *          so mixing from the cache gives exactly the same result as running the interpolation again.
+ * Authors: OpenMPT Devs
+ * The OpenMPT source code is released under the BSD license. Read LICENSE for more details.
+ */
+
+
+#pragma once
+
+#include "BuildSettings.h"
+
+#include "Snd_defs.h"
+#include "Mixer.h"
+
+#include <list>
+#include <map>
+#include <vector>
+
+
+OPENMPT_NAMESPACE_BEGIN
+
+
+class ResampleCache
+{
+public:
+	// A cache entry holds all sampling points of a sample that are read at a given increment, starting at position "phase".
+	// Only voices reading directly from the sample data (i.e. not from a loop wrap-around buffer) can use the cache,
+	// so a voice's loop state does not affect the cached data.
+	struct Key
+	{
+		const void *sampleData;
+		SmpLength sampleLength;
+		int64 increment;	// Raw SamplePosition value
+		int64 phase;	// Raw SamplePosition value of the first cached sampling point, always smaller than increment
+		uint32 mixFlags;	// MixFuncTable index (sample format and interpolation type)
+
+		bool operator<(const Key &other) const;
+	};
+
+	struct Entry
+	{
+		std::vector<mixsample_t> frames;	// Interpolated, unscaled stereo frames. Filled on demand, so this may be shorter than the reserved size.
+		size_t maxFrames = 0;
+		std::list<const Key *>::iterator lruPos;	// Position in the usage list
+	};
+
+	// Statistics (in frames)
+	uint64 hits = 0;	// Frames that were mixed from cached data
+	uint64 misses = 0;	// Frames of cacheable voices that had to be interpolated
+
+protected:
+	std::map<Key, Entry> m_entries;
+	std::list<const Key *> m_lru;	// Keys of all entries, most recently used first
+	size_t m_maxSize = 0;	// In bytes, 0 = cache disabled
+	size_t m_size = 0;
+
+public:
+	bool IsEnabled() const { return m_maxSize != 0; }
+	size_t GetMaxSize() const { return m_maxSize; }
+	size_t GetSize() const { return m_size; }
+	size_t GetNumEntries() const { return m_entries.size(); }
+
+	// Change the maximum cache size in bytes. Entries are evicted if necessary. 0 disables and clears the cache.
+	void SetMaxSize(size_t maxSize);
+	// Remove all cache entries, e.g. because sample data has been modified. Statistics are kept.
+	void Clear();
+	// Remove all cache entries of the given sample data, e.g. because it has been modified in place.
+	void Invalidate(const void *sampleData);
+	void ResetStatistics() { hits = misses = 0; }
+
+	// Return an existing entry and mark it as recently used, or nullptr if there is no such entry.
+	Entry *Find(const Key &key);
+	// Create a new entry that can hold up to maxFrames frames, evicting the least recently used entries if necessary.
+	// Returns nullptr if an entry of this size cannot be cached.
+	Entry *Create(const Key &key, size_t maxFrames);
+
+protected:
+	void EvictUntil(size_t maxSize);
+	static size_t GetEntrySize(size_t maxFrames) { return maxFrames * 2 * sizeof(mixsample_t); }
+};
+
+
+OPENMPT_NAMESPACE_END
@@ -16,6 +16,9 @@
 #include "Mixer.h"
 #include "MixerSettings.h"
 
+#include <memory>
+#include <vector>
+
 
 OPENMPT_NAMESPACE_BEGIN
 
@@ -53,6 +56,24 @@ typedef mixsample_t SINC_TYPE;
 STATIC_ASSERT((SINC_MASK & 0xffff) == SINC_MASK); // exceeding fractional freq
 
 
+// Coefficient tables for the high-order polyphase resamplers (SRCMODE_SINC16, SRCMODE_SINC32).
+// Coefficients are stored as float for both the integer and the floating point mixer.
+// The tables are big (width * SINC_PHASES floats each) and do not depend on any settings,
+// so they are only generated once they are needed for the first time and then shared by all resampler objects.
+struct HighOrderSincTables
+{
+	const int width;
+	std::vector<float> kaiserSinc;     // Upsampling
+	std::vector<float> downsample13x;  // Downsample 1.333x
+	std::vector<float> downsample2x;   // Downsample 2x
+
+	explicit HighOrderSincTables(int width);
+
+	// Returns the shared tables for the given filter width (16 or 32)
+	static const HighOrderSincTables &Get(int width);
+};
+
+
 class CResamplerSettings
 {
 public:
@@ -80,7 +101,9 @@ class CResampler
 {
 public:
 	CResamplerSettings m_Settings;
-	CWindowedFIR m_WindowedFIR;
+	// Windowed FIR table for the current settings.
+	// Resamplers using the same settings may share the table, so it must never be modified after it has been created.
+	std::shared_ptr<const CWindowedFIR> m_WindowedFIR;
 	static const int16 FastSincTable[256 * 4];
 
 #ifdef MODPLUG_TRACKER
@@ -91,9 +114,16 @@ public:
 	#define RESAMPLER_TABLE 
 #endif // MODPLUG_TRACKER
 
+#ifdef MPT_RESAMPLER_TABLES_CACHED
+	// Point into the cached tables, which are shared by all resampler objects
+	const SINC_TYPE *gKaiserSinc = nullptr;     // Upsampling
+	const SINC_TYPE *gDownsample13x = nullptr;  // Downsample 1.333x
+	const SINC_TYPE *gDownsample2x = nullptr;   // Downsample 2x
+#else
 	RESAMPLER_TABLE SINC_TYPE gKaiserSinc[SINC_PHASES * 8];     // Upsampling
 	RESAMPLER_TABLE SINC_TYPE gDownsample13x[SINC_PHASES * 8];  // Downsample 1.333x
 	RESAMPLER_TABLE SINC_TYPE gDownsample2x[SINC_PHASES * 8];   // Downsample 2x
+#endif
 
 #ifndef MPT_INTMIXER
 	RESAMPLER_TABLE mixsample_t FastSincTablef[256 * 4];	// Cubic spline LUT
@@ -102,6 +132,10 @@ public:
 
 #undef RESAMPLER_TABLE
 
+	// Tables for the high-order resamplers, nullptr until SRCMODE_SINC16 / SRCMODE_SINC32 has been selected for the first time
+	const HighOrderSincTables *gSinc16 = nullptr;
+	const HighOrderSincTables *gSinc32 = nullptr;
+
 private:
 	CResamplerSettings m_OldSettings;
 public:
@@ -129,6 +163,8 @@ public:
 	}
 private:
 	void InitFloatmixerTables();
+	// Called whenever the settings change, so that the tables are never created while rendering
+	void InitHighOrderTables();
 	void InitializeTablesFromScratch(bool force=false);
 #ifdef MPT_RESAMPLER_TABLES_CACHED
 	void InitializeTablesFromCache();
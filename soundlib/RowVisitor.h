@@ -34,6 +34,7 @@ protected:
 
 public:
 	RowVisitor(const CSoundFile &sf, SEQUENCEINDEX sequence = SEQUENCEINDEX_INVALID);
+	RowVisitor(const RowVisitor &other) = default;
 	RowVisitor& operator=(RowVisitor &&other);
 
 	// Resize / Clear the row vector.
@@ -56,6 +57,10 @@ public:
 	// If autoSet is true, the queried row will automatically be marked as visited.
 	// Use this parameter instead of consecutive IsRowVisited / SetRowVisited calls.
 	bool IsVisited(ORDERINDEX ord, ROWINDEX row, bool autoSet);
+	bool IsVisited(ORDERINDEX ord, ROWINDEX row) const
+	{
+		return ord < m_visitedRows.size() && row < m_visitedRows[ord].size() && m_visitedRows[ord][row];
+	}
 
 	// Get the needed vector size for a given pattern.
 	size_t GetVisitedRowsVectorSize(PATTERNINDEX pattern) const;
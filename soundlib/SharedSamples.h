@@ -0,0 +1,56 @@
+/*
+ * SharedSamples.h
+ * ---------------
+ * Purpose: Sample data that is shared between several CSoundFile instances playing the same module.
+ * Notes  : Shared sample data must not be modified. See CSoundFile::CreateSharedCopy and CSoundFile::MakeSampleDataPrivate.
+ * Authors: OpenMPT Devs
+ * The OpenMPT source code is released under the BSD license. Read LICENSE for more details.
+ */
+
+
+#pragma once
+
+#include "BuildSettings.h"
+
+#include "ModSample.h"
+
+#include <algorithm>
+#include <functional>
+#include <utility>
+#include <vector>
+
+
+OPENMPT_NAMESPACE_BEGIN
+
+
+class SharedSamples
+{
+protected:
+	std::vector<void *> m_data;	// Sorted, so that buffers can be looked up quickly
+
+public:
+	// Takes ownership of the sample buffers, which must have been allocated with ModSample::AllocateSample.
+	explicit SharedSamples(std::vector<void *> data)
+		: m_data(std::move(data))
+	{
+		std::sort(m_data.begin(), m_data.end(), std::less<const void *>());
+	}
+
+	~SharedSamples()
+	{
+		for(void *data : m_data)
+		{
+			ModSample::FreeSample(data);
+		}
+	}
+
+	SharedSamples(const SharedSamples &) = delete;
+	SharedSamples &operator=(const SharedSamples &) = delete;
+
+	size_t size() const { return m_data.size(); }
+
+	bool Contains(const void *data) const { return data != nullptr && std::binary_search(m_data.begin(), m_data.end(), data, std::less<const void *>()); }
+};
+
+
+OPENMPT_NAMESPACE_END
@@ -304,6 +304,9 @@ enum ResamplingMode : uint8
 
 	SRCMODE_DEFAULT   = 5,  // Only used for instrument settings, not used inside the mixer
 
+	SRCMODE_SINC16    = 6,  // 16 tap, with AA (Polyphase, float coefficients), only available as global mixer setting
+	SRCMODE_SINC32    = 7,  // 32 tap, with AA (Polyphase, float coefficients), only available as global mixer setting
+
 	SRCMODE_AMIGA  = 0xFF,  // Not explicitely user-selectable
 };
 
@@ -316,6 +319,7 @@ static inline std::array<ResamplingMode, 6> AllModesWithDefault() noexcept { ret
 
 static MPT_CONSTEXPR11_FUN ResamplingMode Default() noexcept { return SRCMODE_SINC8LP; }
 
+// Modes that may be stored in files as song or instrument resampling mode. The high-order modes are not part of the file format.
 static MPT_CONSTEXPR11_FUN bool IsKnownMode(int mode) noexcept { return (mode >= 0) && (mode < SRCMODE_DEFAULT); }
 
 static MPT_CONSTEXPR11_FUN ResamplingMode ToKnownMode(int mode) noexcept
@@ -332,10 +336,12 @@ static MPT_CONSTEXPR11_FUN int Length(ResamplingMode mode) noexcept
 		: mode == SRCMODE_CUBIC ? 4
 		: mode == SRCMODE_SINC8 ? 8
 		: mode == SRCMODE_SINC8LP ? 8
+		: mode == SRCMODE_SINC16 ? 16
+		: mode == SRCMODE_SINC32 ? 32
 		: 0;
 }
 
-static MPT_CONSTEXPR11_FUN bool HasAA(ResamplingMode mode) noexcept { return (mode == SRCMODE_SINC8LP); }
+static MPT_CONSTEXPR11_FUN bool HasAA(ResamplingMode mode) noexcept { return (mode == SRCMODE_SINC8LP) || (mode == SRCMODE_SINC16) || (mode == SRCMODE_SINC32); }
 
 static MPT_CONSTEXPR11_FUN ResamplingMode AddAA(ResamplingMode mode) noexcept { return (mode == SRCMODE_SINC8) ? SRCMODE_SINC8LP : mode; }
 
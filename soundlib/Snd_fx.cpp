@@ -224,11 +224,190 @@ public:
 };
 
 
+// Snapshot of the GetLength() state at the start of a row
+struct GetLengthSeekIndex::Checkpoint
+{
+	// Scans in eNoAdjust and eAdjust mode only differ in how tempo memory is handled,
+	// so a snapshot can be shared between them unless such a difference was encountered before it was taken.
+	enum ValidModes : uint8
+	{
+		validNoAdjust = 0x01,
+		validAdjust   = 0x02,
+		validAll      = validNoAdjust | validAdjust,
+	};
+
+	// Start position of the scan this snapshot was taken in
+	SEQUENCEINDEX sequence;
+	ORDERINDEX startOrder;
+	ROWINDEX startRow;
+	uint8 validModes;
+
+	// Scan state
+	double elapsedTime;
+	uint32 oldTickDuration;
+	std::vector<GetLengthMemory::ChnSettings> chnSettings;
+#ifndef NO_PLUGINS
+	GetLengthMemory::PlugParamMap plugParams;
+#endif
+	RowVisitor visitedRows;
+
+	// Play state (only the parts which are modified by GetLength() are stored)
+	CSoundFile::samplecount_t totalSampleCount;
+	double bufferDiff;
+	uint32 musicSpeed;
+	TEMPO musicTempo;
+	int32 globalVolume;
+	ROWINDEX row, nextRow, nextPatStartRow, currentRowsPerBeat;
+	PATTERNINDEX pattern;
+	ORDERINDEX currentOrder, nextOrder;
+	std::vector<ModChannel> channels;
+
+	Checkpoint(const RowVisitor &visitedRows) : visitedRows(visitedRows) { }
+
+	bool IsValidFor(enmGetLengthResetMode adjustMode) const
+	{
+		return (validModes & ((adjustMode & eAdjust) ? validAdjust : validNoAdjust)) != 0;
+	}
+};
+
+
+GetLengthSeekIndex::GetLengthSeekIndex(double interval)
+	: m_interval(interval)
+{
+}
+
+
+GetLengthSeekIndex::~GetLengthSeekIndex()
+{
+}
+
+
+void GetLengthSeekIndex::Clear()
+{
+	m_checkpoints.clear();
+}
+
+
+void GetLengthSeekIndex::Append(GetLengthSeekIndex &other)
+{
+	if(other.m_mixingFreq != m_mixingFreq || other.m_tempoFactor != m_tempoFactor)
+	{
+		Clear();
+		m_mixingFreq = other.m_mixingFreq;
+		m_tempoFactor = other.m_tempoFactor;
+	}
+	m_checkpoints.reserve(m_checkpoints.size() + other.m_checkpoints.size());
+	for(auto &cp : other.m_checkpoints)
+	{
+		m_checkpoints.push_back(std::move(cp));
+	}
+	other.Clear();
+}
+
+
+// State at the end of a GetLength() scan that is applied to the CSoundFile object in eAdjust mode
+struct GetLengthAdjustState
+{
+	std::unique_ptr<CSoundFile::PlayState> playState;
+	std::vector<GetLengthMemory::ChnSettings> chnSettings;
+#ifndef NO_PLUGINS
+	GetLengthMemory::PlugParamMap plugParams;
+#endif
+	std::unique_ptr<RowVisitor> visitedRows;
+	SEQUENCEINDEX sequence = 0;
+};
+
+
 // Get mod length in various cases. Parameters:
 // [in]  adjustMode: See enmGetLengthResetMode for possible adjust modes.
 // [in]  target: Time or position target which should be reached, or no target to get length of the first sub song. Use GetLengthTarget::StartPos to also specify a position from where the seeking should begin.
+// [in]  seekIndex: Optional seek index that is used to speed up seeking and that is updated with new snapshots while scanning.
 // [out] See definition of type GetLengthType for the returned values.
-std::vector<GetLengthType> CSoundFile::GetLength(enmGetLengthResetMode adjustMode, GetLengthTarget target)
+std::vector<GetLengthType> CSoundFile::GetLength(enmGetLengthResetMode adjustMode, GetLengthTarget target, GetLengthSeekIndex *seekIndex)
+{
+	if(!(adjustMode & eAdjust))
+	{
+		return GetLengthScan(adjustMode, target, seekIndex, nullptr);
+	}
+
+	GetLengthAdjustState adjustState;
+	std::vector<GetLengthType> results = GetLengthScan(adjustMode, target, seekIndex, &adjustState);
+	const GetLengthType &retval = results.back();
+	const bool adjustSamplePos = (adjustMode & eAdjustSamplePositions) == eAdjustSamplePositions;
+	CSoundFile::PlayState &playState = *adjustState.playState;
+
+	// Store final variables
+	if(retval.targetReached || target.mode == GetLengthTarget::NoTarget)
+	{
+		// Target found, or there is no target (i.e. play whole song)...
+		m_PlayState = std::move(playState);
+		m_PlayState.m_nNextRow = m_PlayState.m_nRow;
+		m_PlayState.m_nFrameDelay = m_PlayState.m_nPatternDelay = 0;
+		m_PlayState.m_nTickCount = Util::MaxValueOfType(m_PlayState.m_nTickCount) - 1;
+		m_PlayState.m_bPositionChanged = true;
+		for(CHANNELINDEX n = 0; n < GetNumChannels(); n++)
+		{
+			if(m_PlayState.Chn[n].nLastNote != NOTE_NONE)
+			{
+				m_PlayState.Chn[n].nNewNote = m_PlayState.Chn[n].nLastNote;
+			}
+			if(adjustState.chnSettings[n].vol != 0xFF && !adjustSamplePos)
+			{
+				m_PlayState.Chn[n].nVolume = std::min(adjustState.chnSettings[n].vol, uint8(64)) * 4;
+			}
+		}
+		if(m_opl != nullptr) m_opl->Reset();
+
+#ifndef NO_PLUGINS
+		// If there were any PC events, update plugin parameters to their latest value.
+		std::bitset<MAX_MIXPLUGINS> plugSetProgram;
+		for(const auto &param : adjustState.plugParams)
+		{
+			PLUGINDEX plug = param.first.first - 1;
+			IMixPlugin *plugin = m_MixPlugins[plug].pMixPlugin;
+			if(plugin != nullptr)
+			{
+				if(!plugSetProgram[plug])
+				{
+					// Used for bridged plugins to avoid sending out individual messages for each parameter.
+					plugSetProgram.set(plug);
+					plugin->BeginSetProgram();
+				}
+				plugin->SetParameter(param.first.second, param.second / PlugParamValue(ModCommand::maxColumnValue));
+			}
+		}
+		if(plugSetProgram.any())
+		{
+			for(PLUGINDEX i = 0; i < MAX_MIXPLUGINS; i++)
+			{
+				if(plugSetProgram[i])
+				{
+					m_MixPlugins[i].pMixPlugin->EndSetProgram();
+				}
+			}
+		}
+#endif // NO_PLUGINS
+	} else if(adjustMode != eAdjustOnSuccess)
+	{
+		// Target not found (e.g. when jumping to a hidden sub song), reset global variables...
+		m_PlayState.m_nMusicSpeed = m_nDefaultSpeed;
+		m_PlayState.m_nMusicTempo = m_nDefaultTempo;
+		m_PlayState.m_nGlobalVolume = m_nDefaultGlobalVolume;
+	}
+	// When adjusting the playback status, we will also want to update the visited rows vector according to the current position.
+	if(adjustState.sequence != Order.GetCurrentSequenceIndex())
+	{
+		Order.SetSequence(adjustState.sequence);
+	}
+	visitedSongRows = std::move(*adjustState.visitedRows);
+
+	return results;
+}
+
+
+// The actual song simulation of GetLength(), which does not modify the CSoundFile object.
+// If adjustState is not nullptr, it receives the state that GetLength() needs for adjusting the play state in eAdjust mode.
+std::vector<GetLengthType> CSoundFile::GetLengthScan(enmGetLengthResetMode adjustMode, const GetLengthTarget &target, GetLengthSeekIndex *seekIndex, GetLengthAdjustState *adjustState) const
 {
 	std::vector<GetLengthType> results;
 	GetLengthType retval;
@@ -243,14 +422,82 @@ std::vector<GetLengthType> CSoundFile::GetLength(enmGetLengthResetMode adjustMod
 	if(sequence >= Order.GetNumSequences()) sequence = Order.GetCurrentSequenceIndex();
 	const ModSequence &orderList = Order(sequence);
 
+	// Snapshots cannot be taken in sample position adjust mode, as the sample positions are only synced lazily.
+	// When snapshotting, channel state is always updated, as the snapshots may be used for adjusting later.
+	const bool useSeekIndex = (seekIndex != nullptr) && !adjustSamplePos;
+	const bool updateChannelState = (adjustMode & eAdjust) || useSeekIndex;
+	const GetLengthSeekIndex::Checkpoint *checkpoint = nullptr;
+	double nextCheckpointTime = 0.0;
+	uint8 checkpointModes = GetLengthSeekIndex::Checkpoint::validAll;
+	if(useSeekIndex)
+	{
+#ifndef MODPLUG_TRACKER
+		const uint32 tempoFactor = m_nTempoFactor;
+#else
+		const uint32 tempoFactor = 65536;
+#endif // !MODPLUG_TRACKER
+		if(seekIndex->m_mixingFreq != m_MixerSettings.gdwMixingFreq || seekIndex->m_tempoFactor != tempoFactor)
+		{
+			seekIndex->Clear();
+			seekIndex->m_mixingFreq = m_MixerSettings.gdwMixingFreq;
+			seekIndex->m_tempoFactor = tempoFactor;
+		}
+		double lastCheckpointTime = 0.0;
+		for(const auto &cp : seekIndex->m_checkpoints)
+		{
+			if(cp->sequence != sequence || cp->startOrder != target.startOrder || cp->startRow != target.startRow || !cp->IsValidFor(adjustMode))
+				continue;
+			lastCheckpointTime = std::max(lastCheckpointTime, cp->elapsedTime);
+			bool precedesTarget = false;
+			if(target.mode == GetLengthTarget::SeekSeconds)
+				precedesTarget = cp->elapsedTime < target.time;
+			else if(target.mode == GetLengthTarget::SeekPosition)
+				precedesTarget = !cp->visitedRows.IsVisited(target.pos.order, target.pos.row);
+			if(precedesTarget && (checkpoint == nullptr || cp->elapsedTime > checkpoint->elapsedTime))
+				checkpoint = cp.get();
+		}
+		nextCheckpointTime = lastCheckpointTime + seekIndex->m_interval;
+	}
+
 	GetLengthMemory memory(*this);
 	CSoundFile::PlayState &playState = *memory.state;
 	// Temporary visited rows vector (so that GetLength() won't interfere with the player code if the module is playing at the same time)
-	RowVisitor visitedRows(*this, sequence);
+	std::unique_ptr<RowVisitor> visitedRowsStorage = (checkpoint != nullptr) ? mpt::make_unique<RowVisitor>(checkpoint->visitedRows) : mpt::make_unique<RowVisitor>(*this, sequence);
+	RowVisitor &visitedRows = *visitedRowsStorage;
 
 	playState.m_nNextRow = playState.m_nRow = target.startRow;
 	playState.m_nNextOrder = playState.m_nCurrentOrder = target.startOrder;
 
+	// If samples are being synced, force them to resync if tick duration changes
+	uint32 oldTickDuration = 0;
+
+	if(checkpoint != nullptr)
+	{
+		// Continue from snapshot
+		checkpointModes = checkpoint->validModes;
+		memory.elapsedTime = checkpoint->elapsedTime;
+		memory.chnSettings = checkpoint->chnSettings;
+#ifndef NO_PLUGINS
+		memory.plugParams = checkpoint->plugParams;
+#endif
+		oldTickDuration = checkpoint->oldTickDuration;
+		playState.m_lTotalSampleCount = checkpoint->totalSampleCount;
+		playState.m_dBufferDiff = checkpoint->bufferDiff;
+		playState.m_nMusicSpeed = checkpoint->musicSpeed;
+		playState.m_nMusicTempo = checkpoint->musicTempo;
+		playState.m_nGlobalVolume = checkpoint->globalVolume;
+		playState.m_nRow = checkpoint->row;
+		playState.m_nNextRow = checkpoint->nextRow;
+		playState.m_nNextPatStartRow = checkpoint->nextPatStartRow;
+		playState.m_nCurrentRowsPerBeat = checkpoint->currentRowsPerBeat;
+		playState.m_nPattern = checkpoint->pattern;
+		playState.m_nCurrentOrder = checkpoint->currentOrder;
+		playState.m_nNextOrder = checkpoint->nextOrder;
+		std::copy(checkpoint->channels.begin(), checkpoint->channels.end(), playState.Chn.begin());
+	}
+	// Snapshots are only taken of the first sub song, as later sub songs depend on the rows visited by the previous sub songs.
+	bool takeCheckpoints = useSeekIndex;
+
 	// Fast LUTs for commands that are too weird / complicated / whatever to emulate in sample position adjust mode.
 	std::bitset<MAX_EFFECTS> forbiddenCommands;
 	std::bitset<MAX_VOLCMDS> forbiddenVolCommands;
@@ -287,11 +534,38 @@ std::vector<GetLengthType> CSoundFile::GetLength(enmGetLengthResetMode adjustMod
 		}
 	}
 
-	// If samples are being synced, force them to resync if tick duration changes
-	uint32 oldTickDuration = 0;
-
 	for (;;)
 	{
+		if(takeCheckpoints && memory.elapsedTime >= nextCheckpointTime)
+		{
+			std::unique_ptr<GetLengthSeekIndex::Checkpoint> cp = mpt::make_unique<GetLengthSeekIndex::Checkpoint>(visitedRows);
+			cp->sequence = sequence;
+			cp->startOrder = target.startOrder;
+			cp->startRow = target.startRow;
+			cp->validModes = checkpointModes;
+			cp->elapsedTime = memory.elapsedTime;
+			cp->oldTickDuration = oldTickDuration;
+			cp->chnSettings = memory.chnSettings;
+#ifndef NO_PLUGINS
+			cp->plugParams = memory.plugParams;
+#endif
+			cp->totalSampleCount = playState.m_lTotalSampleCount;
+			cp->bufferDiff = playState.m_dBufferDiff;
+			cp->musicSpeed = playState.m_nMusicSpeed;
+			cp->musicTempo = playState.m_nMusicTempo;
+			cp->globalVolume = playState.m_nGlobalVolume;
+			cp->row = playState.m_nRow;
+			cp->nextRow = playState.m_nNextRow;
+			cp->nextPatStartRow = playState.m_nNextPatStartRow;
+			cp->currentRowsPerBeat = playState.m_nCurrentRowsPerBeat;
+			cp->pattern = playState.m_nPattern;
+			cp->currentOrder = playState.m_nCurrentOrder;
+			cp->nextOrder = playState.m_nNextOrder;
+			cp->channels.assign(playState.Chn.begin(), playState.Chn.begin() + GetNumChannels());
+			seekIndex->m_checkpoints.push_back(std::move(cp));
+			nextCheckpointTime = memory.elapsedTime + seekIndex->m_interval;
+		}
+
 		// Time target reached.
 		if(target.mode == GetLengthTarget::SeekSeconds && memory.elapsedTime >= target.time)
 		{
@@ -356,6 +630,7 @@ std::vector<GetLengthType> CSoundFile::GetLength(enmGetLengthResetMode adjustMod
 					retval.startRow = playState.m_nRow;
 					retval.startOrder = playState.m_nNextOrder;
 					memory.Reset();
+					takeCheckpoints = false;
 
 					playState.m_nCurrentOrder = playState.m_nNextOrder;
 					playState.m_nPattern = orderList[playState.m_nCurrentOrder];
@@ -388,6 +663,7 @@ std::vector<GetLengthType> CSoundFile::GetLength(enmGetLengthResetMode adjustMod
 					retval.startRow = playState.m_nRow;
 					retval.startOrder = playState.m_nNextOrder;
 					memory.Reset();
+					takeCheckpoints = false;
 					playState.m_nNextRow = playState.m_nRow;
 					continue;
 				}
@@ -420,6 +696,7 @@ std::vector<GetLengthType> CSoundFile::GetLength(enmGetLengthResetMode adjustMod
 				retval.startRow = playState.m_nRow;
 				retval.startOrder = playState.m_nNextOrder;
 				memory.Reset();
+				takeCheckpoints = false;
 				playState.m_nNextRow = playState.m_nRow;
 				continue;
 			}
@@ -456,7 +733,7 @@ std::vector<GetLengthType> CSoundFile::GetLength(enmGetLengthResetMode adjustMod
 			if(p->IsPcNote())
 			{
 #ifndef NO_PLUGINS
-				if((adjustMode & eAdjust) && p->instr > 0 && p->instr <= MAX_MIXPLUGINS)
+				if(updateChannelState && p->instr > 0 && p->instr <= MAX_MIXPLUGINS)
 				{
 					memory.plugParams[std::make_pair(p->instr, p->GetValueVolCol())] = p->GetValueEffectCol();
 				}
@@ -548,9 +825,9 @@ std::vector<GetLengthType> CSoundFile::GetLength(enmGetLengthResetMode adjustMod
 				}
 				if(smp > 0 && smp <= GetNumSamples())
 				{
-					if(Samples[smp].uFlags[CHN_PANNING])
-						chn.nPan = Samples[smp].nPan;
-					if(Samples[smp].uFlags[CHN_ADLIB])
+					if(Samples.Get(smp).uFlags[CHN_PANNING])
+						chn.nPan = Samples.Get(smp).nPan;
+					if(Samples.Get(smp).uFlags[CHN_ADLIB])
 					{
 						memory.state->Chn[nChn].Stop();
 						memory.chnSettings[nChn].ticksToRender = 0;
@@ -582,7 +859,7 @@ std::vector<GetLengthType> CSoundFile::GetLength(enmGetLengthResetMode adjustMod
 				if(!patternBreakOnThisRow || (GetType() & (MOD_TYPE_MOD | MOD_TYPE_XM)))
 					playState.m_nNextRow = 0;
 
-				if (adjustMode & eAdjust)
+				if (updateChannelState)
 				{
 					chn.nPatternLoopCount = 0;
 					chn.nPatternLoop = 0;
@@ -601,7 +878,7 @@ std::vector<GetLengthType> CSoundFile::GetLength(enmGetLengthResetMode adjustMod
 						{
 							playState.m_nNextOrder = playState.m_nCurrentOrder + 1;
 						}
-						if(adjustMode & eAdjust)
+						if(updateChannelState)
 						{
 							chn.nPatternLoopCount = 0;
 							chn.nPatternLoop = 0;
@@ -614,9 +891,17 @@ std::vector<GetLengthType> CSoundFile::GetLength(enmGetLengthResetMode adjustMod
 				if(!m_playBehaviour[kMODVBlankTiming])
 				{
 					TEMPO tempo(CalculateXParam(playState.m_nPattern, playState.m_nRow, nChn), 0);
-					if ((adjustMode & eAdjust) && (GetType() & (MOD_TYPE_S3M | MOD_TYPE_IT | MOD_TYPE_MPT)))
+					if (GetType() & (MOD_TYPE_S3M | MOD_TYPE_IT | MOD_TYPE_MPT))
 					{
-						if (tempo.GetInt()) chn.nOldTempo = static_cast<uint8>(tempo.GetInt()); else tempo.Set(chn.nOldTempo);
+						if (tempo.GetInt())
+						{
+							if (updateChannelState) chn.nOldTempo = static_cast<uint8>(tempo.GetInt());
+						} else
+						{
+							// Tempo memory is only evaluated when adjusting, so from here on, the timing depends on the adjust mode.
+							checkpointModes &= (adjustMode & eAdjust) ? GetLengthSeekIndex::Checkpoint::validAdjust : GetLengthSeekIndex::Checkpoint::validNoAdjust;
+							if (adjustMode & eAdjust) tempo.Set(chn.nOldTempo);
+						}
 					}
 
 					if (tempo.GetInt() >= 0x20) playState.m_nMusicTempo = tempo;
@@ -723,7 +1008,7 @@ std::vector<GetLengthType> CSoundFile::GetLength(enmGetLengthResetMode adjustMod
 			}
 
 			// The following calculations are not interesting if we just want to get the song length.
-			if (!(adjustMode & eAdjust)) continue;
+			if (!updateChannelState) continue;
 			switch(command)
 			{
 			// Portamento Up/Down
@@ -891,7 +1176,7 @@ std::vector<GetLengthType> CSoundFile::GetLength(enmGetLengthResetMode adjustMod
 			case CMD_VIBRATO:
 			case CMD_FINEVIBRATO:
 			case CMD_VIBRATOVOL:
-				if(adjustMode & eAdjust)
+				if(updateChannelState)
 				{
 					uint32 vibTicks = ((GetType() & (MOD_TYPE_IT | MOD_TYPE_MPT)) && !m_SongFlags[SONG_ITOLDEFFECTS]) ? numTicks : nonRowTicks;
 					uint32 inc = chn.nVibratoSpeed * vibTicks;
@@ -902,7 +1187,7 @@ std::vector<GetLengthType> CSoundFile::GetLength(enmGetLengthResetMode adjustMod
 				break;
 
 			case CMD_TREMOLO:
-				if(adjustMode & eAdjust)
+				if(updateChannelState)
 				{
 					uint32 tremTicks = ((GetType() & (MOD_TYPE_IT | MOD_TYPE_MPT)) && !m_SongFlags[SONG_ITOLDEFFECTS]) ? numTicks : nonRowTicks;
 					uint32 inc = chn.nTremoloSpeed * tremTicks;
@@ -913,7 +1198,7 @@ std::vector<GetLengthType> CSoundFile::GetLength(enmGetLengthResetMode adjustMod
 				break;
 
 			case CMD_PANBRELLO:
-				if(adjustMode & eAdjust)
+				if(updateChannelState)
 				{
 					// Panbrello effect is permanent in compatible mode, so actually apply panbrello for the last tick of this row
 					chn.nPanbrelloPos += static_cast<uint8>(chn.nPanbrelloSpeed * (numTicks - 1));
@@ -1246,72 +1531,15 @@ std::vector<GetLengthType> CSoundFile::GetLength(enmGetLengthResetMode adjustMod
 	retval.duration = memory.elapsedTime;
 	results.push_back(retval);
 
-	// Store final variables
-	if(adjustMode & eAdjust)
+	if(adjustState != nullptr)
 	{
-		if(retval.targetReached || target.mode == GetLengthTarget::NoTarget)
-		{
-			// Target found, or there is no target (i.e. play whole song)...
-			m_PlayState = std::move(playState);
-			m_PlayState.m_nNextRow = m_PlayState.m_nRow;
-			m_PlayState.m_nFrameDelay = m_PlayState.m_nPatternDelay = 0;
-			m_PlayState.m_nTickCount = Util::MaxValueOfType(m_PlayState.m_nTickCount) - 1;
-			m_PlayState.m_bPositionChanged = true;
-			for(CHANNELINDEX n = 0; n < GetNumChannels(); n++)
-			{
-				if(m_PlayState.Chn[n].nLastNote != NOTE_NONE)
-				{
-					m_PlayState.Chn[n].nNewNote = m_PlayState.Chn[n].nLastNote;
-				}
-				if(memory.chnSettings[n].vol != 0xFF && !adjustSamplePos)
-				{
-					m_PlayState.Chn[n].nVolume = std::min(memory.chnSettings[n].vol, uint8(64)) * 4;
-				}
-			}
-			if(m_opl != nullptr) m_opl->Reset();
-
+		adjustState->playState = std::move(memory.state);
+		adjustState->chnSettings = std::move(memory.chnSettings);
 #ifndef NO_PLUGINS
-			// If there were any PC events, update plugin parameters to their latest value.
-			std::bitset<MAX_MIXPLUGINS> plugSetProgram;
-			for(const auto &param : memory.plugParams)
-			{
-				PLUGINDEX plug = param.first.first - 1;
-				IMixPlugin *plugin = m_MixPlugins[plug].pMixPlugin;
-				if(plugin != nullptr)
-				{
-					if(!plugSetProgram[plug])
-					{
-						// Used for bridged plugins to avoid sending out individual messages for each parameter.
-						plugSetProgram.set(plug);
-						plugin->BeginSetProgram();
-					}
-					plugin->SetParameter(param.first.second, param.second / PlugParamValue(ModCommand::maxColumnValue));
-				}
-			}
-			if(plugSetProgram.any())
-			{
-				for(PLUGINDEX i = 0; i < MAX_MIXPLUGINS; i++)
-				{
-					if(plugSetProgram[i])
-					{
-						m_MixPlugins[i].pMixPlugin->EndSetProgram();
-					}
-				}
-			}
-#endif // NO_PLUGINS
-		} else if(adjustMode != eAdjustOnSuccess)
-		{
-			// Target not found (e.g. when jumping to a hidden sub song), reset global variables...
-			m_PlayState.m_nMusicSpeed = m_nDefaultSpeed;
-			m_PlayState.m_nMusicTempo = m_nDefaultTempo;
-			m_PlayState.m_nGlobalVolume = m_nDefaultGlobalVolume;
-		}
-		// When adjusting the playback status, we will also want to update the visited rows vector according to the current position.
-		if(sequence != Order.GetCurrentSequenceIndex())
-		{
-			Order.SetSequence(sequence);
-		}
-		visitedSongRows = std::move(visitedRows);
+		adjustState->plugParams = std::move(memory.plugParams);
+#endif
+		adjustState->visitedRows = std::move(visitedRowsStorage);
+		adjustState->sequence = sequence;
 	}
 
 	return results;
@@ -1326,7 +1554,7 @@ std::vector<GetLengthType> CSoundFile::GetLength(enmGetLengthResetMode adjustMod
 void CSoundFile::InstrumentChange(ModChannel &chn, uint32 instr, bool bPorta, bool bUpdVol, bool bResetEnv) const
 {
 	const ModInstrument *pIns = instr <= GetNumInstruments() ? Instruments[instr] : nullptr;
-	const ModSample *pSmp = &Samples[instr];
+	const ModSample *pSmp = &Samples.Get(instr);
 	ModCommand::NOTE note = chn.nNewNote;
 
 	if(note == NOTE_NONE && m_playBehaviour[kITInstrWithoutNote]) return;
@@ -1344,7 +1572,7 @@ void CSoundFile::InstrumentChange(ModChannel &chn, uint32 instr, bool bPorta, bo
 
 		if(pIns->NoteMap[note - NOTE_MIN] > NOTE_MAX) return;
 		uint32 n = pIns->Keyboard[note - NOTE_MIN];
-		pSmp = ((n) && (n < MAX_SAMPLES)) ? &Samples[n] : nullptr;
+		pSmp = ((n) && (n < MAX_SAMPLES)) ? &Samples.Get(n) : nullptr;
 	} else if(GetNumInstruments())
 	{
 		// No valid instrument, or not a valid note.
@@ -1677,7 +1905,7 @@ void CSoundFile::NoteChange(ModChannel &chn, int note, bool bPorta, bool bResetE
 		uint32 n = pIns->Keyboard[note - NOTE_MIN];
 		if((n) && (n < MAX_SAMPLES))
 		{
-			pSmp = &Samples[n];
+			pSmp = &Samples.Get(n);
 		} else if(m_playBehaviour[kITEmptyNoteMapSlot] && !chn.HasMIDIOutput())
 		{
 			// Impulse Tracker ignores empty slots.
@@ -2044,7 +2272,7 @@ void CSoundFile::ApplyInstrumentPanning(ModChannel &chn, const ModInstrument *in
 CHANNELINDEX CSoundFile::GetNNAChannel(CHANNELINDEX nChn) const
 {
 	// Check for empty channel
-	for (CHANNELINDEX i = m_nChannels; i < MAX_CHANNELS; i++)
+	for (CHANNELINDEX i = m_nChannels; i < GetNumVoices(); i++)
 	{
 		const ModChannel &c = m_PlayState.Chn[i];
 		// No sample and no plugin playing
@@ -2056,7 +2284,7 @@ CHANNELINDEX CSoundFile::GetNNAChannel(CHANNELINDEX nChn) const
 	}
 
 	uint32 vol = 0x800000;
-	if(nChn < MAX_CHANNELS)
+	if(nChn < GetNumVoices())
 	{
 		const ModChannel &srcChn = m_PlayState.Chn[nChn];
 		if(!srcChn.nFadeOutVol && srcChn.nLength) return 0;
@@ -2066,7 +2294,7 @@ CHANNELINDEX CSoundFile::GetNNAChannel(CHANNELINDEX nChn) const
 	// All channels are used: check for lowest volume
 	CHANNELINDEX result = 0;
 	uint32 envpos = 0;
-	for (CHANNELINDEX i = m_nChannels; i < MAX_CHANNELS; i++)
+	for (CHANNELINDEX i = m_nChannels; i < GetNumVoices(); i++)
 	{
 		const ModChannel &c = m_PlayState.Chn[i];
 		if(c.nLength && !c.nFadeOutVol)
@@ -2139,7 +2367,7 @@ CHANNELINDEX CSoundFile::CheckNNA(CHANNELINDEX nChn, uint32 instr, int note, boo
 		note = pIns->NoteMap[note - NOTE_MIN];
 		if ((n) && (n < MAX_SAMPLES))
 		{
-			pSample = &Samples[n];
+			pSample = &Samples.Get(n);
 		} else if(m_playBehaviour[kITEmptyNoteMapSlot] && !pIns->HasValidMIDIChannel())
 		{
 			// Impulse Tracker ignores empty slots.
@@ -2151,7 +2379,7 @@ CHANNELINDEX CSoundFile::CheckNNA(CHANNELINDEX nChn, uint32 instr, int note, boo
 	if (srcChn.dwFlags[CHN_MUTE])
 		return CHANNELINDEX_INVALID;
 
-	for(CHANNELINDEX i = nChn; i < MAX_CHANNELS; i++)
+	for(CHANNELINDEX i = nChn; i < GetNumVoices(); i++)
 	if(i >= m_nChannels || i == nChn)
 	{
 		ModChannel &chn = m_PlayState.Chn[i];
@@ -2561,8 +2789,8 @@ bool CSoundFile::ProcessEffects()
 				chn.nNewIns = static_cast<ModCommand::INSTR>(instr);
 				if(instr <= GetNumSamples())
 				{
-					chn.nVolume = Samples[instr].nVolume;
-					chn.nFineTune = Samples[instr].nFineTune;
+					chn.nVolume = Samples.Get(instr).nVolume;
+					chn.nFineTune = Samples.Get(instr).nFineTune;
 				}
 			}
 		}
@@ -2597,7 +2825,7 @@ bool CSoundFile::ProcessEffects()
 					}
 					if(sample <= GetNumSamples())
 					{
-						transpose = GetSample(sample).RelativeTone;
+						transpose = Samples.Get(sample).RelativeTone;
 					}
 				}
 
@@ -2697,7 +2925,7 @@ bool CSoundFile::ProcessEffects()
 				} else if (instr <= GetNumSamples())
 				{
 					// Case: Only samples are used; no instruments.
-					oldSample = &Samples[instr];
+					oldSample = &Samples.Get(instr);
 				}
 
 				if(oldSample != nullptr)
@@ -2735,7 +2963,7 @@ bool CSoundFile::ProcessEffects()
 					} else
 					{
 						// Sample mode
-						if(instr < MAX_SAMPLES && (chn.pModSample != &Samples[instr] || triggerAfterSmpEnd))
+						if(instr < MAX_SAMPLES && (chn.pModSample != &Samples.Get(instr) || triggerAfterSmpEnd))
 							note = chn.nNote;
 					}
 				}
@@ -2772,8 +3000,8 @@ bool CSoundFile::ProcessEffects()
 							smp = Instruments[instr]->Keyboard[chn.nLastNote - NOTE_MIN];
 						}
 					}
-					if(smp > 0 && smp <= GetNumSamples() && !Samples[smp].uFlags[SMP_NODEFAULTVOLUME])
-						chn.nVolume = Samples[smp].nVolume;
+					if(smp > 0 && smp <= GetNumSamples() && !Samples.Get(smp).uFlags[SMP_NODEFAULTVOLUME])
+						chn.nVolume = Samples.Get(smp).nVolume;
 				}
 				instr = 0;
 			}
@@ -4181,7 +4409,7 @@ void CSoundFile::Panning(ModChannel &chn, uint32 param, PanningType panBits) con
 }
 
 
-void CSoundFile::VolumeSlide(ModChannel &chn, ModCommand::PARAM param)
+void CSoundFile::VolumeSlide(ModChannel &chn, ModCommand::PARAM param) const
 {
 	if (param)
 		chn.nOldVolumeSlide = param;
@@ -4574,7 +4802,7 @@ void CSoundFile::ExtendedS3MCommands(CHANNELINDEX nChn, ModCommand::PARAM param)
 				case 1:
 				case 2:
 					{
-						for (CHANNELINDEX i = m_nChannels; i < MAX_CHANNELS; i++)
+						for (CHANNELINDEX i = m_nChannels; i < GetNumVoices(); i++)
 						{
 							ModChannel &bkChn = m_PlayState.Chn[i];
 							if (bkChn.nMasterChn == nChn + 1)
@@ -4749,10 +4977,14 @@ void CSoundFile::InvertLoop(ModChannel &chn)
 	if (++chn.nEFxOffset >= pModSample->nLoopEnd - pModSample->nLoopStart)
 		chn.nEFxOffset = 0;
 
+	// Other modules sharing the sample data must not hear the effect.
+	if(!MakeSampleDataPrivate(*pModSample)) return;
+
 	// TRASH IT!!! (Yes, the sample!)
-	uint8 &sample = mpt::byte_cast<uint8 *>(pModSample->sampleb())[pModSample->nLoopStart + chn.nEFxOffset];
+	const SmpLength position = pModSample->nLoopStart + chn.nEFxOffset;
+	uint8 &sample = mpt::byte_cast<uint8 *>(pModSample->sampleb())[position];
 	sample = ~sample;
-	ctrlSmp::PrecomputeLoops(*pModSample, *this, false);
+	ctrlSmp::UpdateModifiedRange(*pModSample, *this, position, position);
 }
 
 
@@ -5674,7 +5906,7 @@ ROWINDEX CSoundFile::PatternLoop(ModChannel &chn, uint32 param)
 			// IT compatibility 10. Pattern loops (+ same fix for XM / MOD / S3M files)
 			if(!m_playBehaviour[kITFT2PatternLoop] && !(GetType() & (MOD_TYPE_MOD | MOD_TYPE_S3M)))
 			{
-				ModChannel *p = m_PlayState.Chn;
+				ModChannel *p = m_PlayState.Chn.data();
 				for(CHANNELINDEX i = 0; i < GetNumChannels(); i++, p++) if (p != &chn)
 				{
 					// Loop on other channel
@@ -5925,7 +6157,7 @@ uint32 CSoundFile::GetFreqFromPeriod(uint32 period, uint32 c5speed, int32 nPerio
 
 PLUGINDEX CSoundFile::GetBestPlugin(CHANNELINDEX nChn, PluginPriority priority, PluginMutePriority respectMutes) const
 {
-	if (nChn >= MAX_CHANNELS)		//Check valid channel number
+	if (nChn >= GetNumVoices())		//Check valid channel number
 	{
 		return 0;
 	}
@@ -6043,7 +6275,7 @@ IMixPlugin *CSoundFile::GetChannelInstrumentPlugin(CHANNELINDEX chn) const
 // Get the MIDI channel currently associated with a given tracker channel
 uint8 CSoundFile::GetBestMidiChannel(CHANNELINDEX trackerChn) const
 {
-	if(trackerChn >= mpt::size(m_PlayState.Chn))
+	if(trackerChn >= m_PlayState.Chn.size())
 	{
 		return 0;
 	}
@@ -33,7 +33,10 @@
 #include "../common/mptStringBuffer.h"
 #include "../common/FileReader.h"
 #include "Container.h"
+#include "DeferredSamples.h"
+#include "SharedSamples.h"
 #include "OPL.h"
+#include "../common/mptThreadPool.h"
 
 #ifndef NO_ARCHIVE_SUPPORT
 #include "../unarchiver/unarchiver.h"
@@ -80,9 +83,8 @@ CSoundFile::CSoundFile() :
 	m_PRNG(mpt::make_prng<mpt::fast_prng>(mpt::global_prng())),
 	visitedSongRows(*this)
 {
-	MemsetZero(MixSoundBuffer);
-	MemsetZero(MixRearBuffer);
-	MemsetZero(MixFloatBuffer);
+	AllocateMixBuffers();
+	m_ResampleCache.SetMaxSize(m_MixerSettings.ResampleCacheSize);
 
 #ifdef MODPLUG_TRACKER
 	m_bChannelMuteTogglePending.reset();
@@ -95,7 +97,7 @@ CSoundFile::CSoundFile() :
 #endif // MODPLUG_TRACKER
 
 	MemsetZero(Instruments);
-	MemsetZero(m_szNames);
+	m_szNames.clear();
 
 	m_pTuningsTuneSpecific = new CTuningCollection();
 }
@@ -188,46 +190,62 @@ void CSoundFile::InitializeChannels()
 }
 
 
+// Magic bytes that a format's file header always contains at a fixed offset.
+// Formats without such magic bytes (e.g. 15-sample MODs) have a signature of length 0.
+// Both alternatives must have the same length.
+struct FileFormatSignature
+{
+	uint16 offset;
+	uint8 length;
+	const char *magic;
+	const char *magicAlt;
+};
+
 struct FileFormatLoader
 {
 	decltype(CSoundFile::ProbeFileHeaderXM) *prober;
 	decltype(&CSoundFile::ReadXM) loader;
+	FileFormatSignature signature;
 };
 
 #ifdef MODPLUG_TRACKER
-#define MPT_DECLARE_FORMAT(format) { nullptr, &CSoundFile::Read ## format }
+#define MPT_DECLARE_FORMAT_SIGNATURE(format, offset, magic, magicAlt) { nullptr, &CSoundFile::Read ## format, { offset, sizeof(magic) - 1, magic, magicAlt } }
 #else
-#define MPT_DECLARE_FORMAT(format) { CSoundFile::ProbeFileHeader ## format, &CSoundFile::Read ## format }
+#define MPT_DECLARE_FORMAT_SIGNATURE(format, offset, magic, magicAlt) { CSoundFile::ProbeFileHeader ## format, &CSoundFile::Read ## format, { offset, sizeof(magic) - 1, magic, magicAlt } }
 #endif
+#define MPT_DECLARE_FORMAT_MAGIC(format, offset, magic) MPT_DECLARE_FORMAT_SIGNATURE(format, offset, magic, magic)
+#define MPT_DECLARE_FORMAT(format) MPT_DECLARE_FORMAT_SIGNATURE(format, 0, "", "")
 
 // All module format loaders, in the order they should be executed.
 // This order matters, depending on the format, due to some unfortunate
 // clashes or lack of magic bytes that can lead to mis-detection of some formats.
 // Apart from that, more common formats with sane magic bytes are also found
 // at the top of the list to match the most common cases more quickly.
+// Formats whose magic bytes are not found in the file header are skipped entirely,
+// so that in practice only the matching loader and the header-less formats are tried.
 static constexpr FileFormatLoader ModuleFormatLoaders[] =
 {
-	MPT_DECLARE_FORMAT(XM),
-	MPT_DECLARE_FORMAT(IT),
-	MPT_DECLARE_FORMAT(S3M),
+	MPT_DECLARE_FORMAT_MAGIC(XM, 0, "Extended Module: "),
+	MPT_DECLARE_FORMAT_SIGNATURE(IT, 0, "IMPM", "tpm."),
+	MPT_DECLARE_FORMAT_MAGIC(S3M, 44, "SCRM"),
 	MPT_DECLARE_FORMAT(STM),
-	MPT_DECLARE_FORMAT(MED),
-	MPT_DECLARE_FORMAT(MTM),
-	MPT_DECLARE_FORMAT(MDL),
-	MPT_DECLARE_FORMAT(DBM),
-	MPT_DECLARE_FORMAT(FAR),
-	MPT_DECLARE_FORMAT(AMS),
-	MPT_DECLARE_FORMAT(AMS2),
-	MPT_DECLARE_FORMAT(OKT),
-	MPT_DECLARE_FORMAT(PTM),
-	MPT_DECLARE_FORMAT(ULT),
-	MPT_DECLARE_FORMAT(DMF),
-	MPT_DECLARE_FORMAT(DSM),
-	MPT_DECLARE_FORMAT(AMF_Asylum),
-	MPT_DECLARE_FORMAT(AMF_DSMI),
-	MPT_DECLARE_FORMAT(PSM),
-	MPT_DECLARE_FORMAT(PSM16),
-	MPT_DECLARE_FORMAT(MT2),
+	MPT_DECLARE_FORMAT_MAGIC(MED, 0, "MMD"),
+	MPT_DECLARE_FORMAT_MAGIC(MTM, 0, "MTM"),
+	MPT_DECLARE_FORMAT_MAGIC(MDL, 0, "DMDL"),
+	MPT_DECLARE_FORMAT_MAGIC(DBM, 0, "DBM0"),
+	MPT_DECLARE_FORMAT_MAGIC(FAR, 0, "FAR\xFE"),
+	MPT_DECLARE_FORMAT_MAGIC(AMS, 0, "Extreme"),
+	MPT_DECLARE_FORMAT_MAGIC(AMS2, 0, "AMShdr\x1A"),
+	MPT_DECLARE_FORMAT_MAGIC(OKT, 0, "OKTASONG"),
+	MPT_DECLARE_FORMAT_MAGIC(PTM, 44, "PTMF"),
+	MPT_DECLARE_FORMAT_MAGIC(ULT, 0, "MAS_UTrack_V00"),
+	MPT_DECLARE_FORMAT_MAGIC(DMF, 0, "DDMF"),
+	MPT_DECLARE_FORMAT_SIGNATURE(DSM, 0, "RIFF", "DSMF"),
+	MPT_DECLARE_FORMAT_MAGIC(AMF_Asylum, 0, "ASYLUM Music Format V1.0\0"),
+	MPT_DECLARE_FORMAT_MAGIC(AMF_DSMI, 0, "AMF"),
+	MPT_DECLARE_FORMAT_SIGNATURE(PSM, 0, "PSM ", "QUP$"),
+	MPT_DECLARE_FORMAT_MAGIC(PSM16, 0, "PSM\xFE"),
+	MPT_DECLARE_FORMAT_MAGIC(MT2, 0, "MT20"),
 	MPT_DECLARE_FORMAT(ITP),
 #if defined(MODPLUG_TRACKER) || defined(MPT_FUZZ_TRACKER)
 	// These make little sense for a module player library
@@ -235,25 +253,41 @@ static constexpr FileFormatLoader ModuleFormatLoaders[] =
 	MPT_DECLARE_FORMAT(WAV),
 	MPT_DECLARE_FORMAT(MID),
 #endif // MODPLUG_TRACKER || MPT_FUZZ_TRACKER
-	MPT_DECLARE_FORMAT(GDM),
-	MPT_DECLARE_FORMAT(IMF),
-	MPT_DECLARE_FORMAT(DIGI),
-	MPT_DECLARE_FORMAT(DTM),
-	MPT_DECLARE_FORMAT(PLM),
-	MPT_DECLARE_FORMAT(AM),
-	MPT_DECLARE_FORMAT(J2B),
-	MPT_DECLARE_FORMAT(PT36),
+	MPT_DECLARE_FORMAT_MAGIC(GDM, 0, "GDM\xFE"),
+	MPT_DECLARE_FORMAT_MAGIC(IMF, 60, "IM10"),
+	MPT_DECLARE_FORMAT_MAGIC(DIGI, 0, "DIGI Booster module\0"),
+	MPT_DECLARE_FORMAT_MAGIC(DTM, 0, "D.T."),
+	MPT_DECLARE_FORMAT_MAGIC(PLM, 0, "PLM\x1A"),
+	MPT_DECLARE_FORMAT_MAGIC(AM, 0, "RIFF"),
+	MPT_DECLARE_FORMAT_MAGIC(J2B, 0, "MUSE"),
+	MPT_DECLARE_FORMAT_MAGIC(PT36, 0, "FORM"),
 	MPT_DECLARE_FORMAT(SFX),
-	MPT_DECLARE_FORMAT(STP),
+	MPT_DECLARE_FORMAT_MAGIC(STP, 0, "STP3"),
 	MPT_DECLARE_FORMAT(MOD),
-	MPT_DECLARE_FORMAT(ICE),
-	MPT_DECLARE_FORMAT(669),
+	MPT_DECLARE_FORMAT_SIGNATURE(ICE, 1464, "MTN\0", "IT10"),
+	MPT_DECLARE_FORMAT_SIGNATURE(669, 0, "if", "JN"),
 	MPT_DECLARE_FORMAT(C67),
-	MPT_DECLARE_FORMAT(MO3),
+	MPT_DECLARE_FORMAT_MAGIC(MO3, 0, "MO3"),
 	MPT_DECLARE_FORMAT(M15),
 };
 
 #undef MPT_DECLARE_FORMAT
+#undef MPT_DECLARE_FORMAT_MAGIC
+#undef MPT_DECLARE_FORMAT_SIGNATURE
+
+
+// Returns true if the file header is long enough to contain the format's magic bytes but does not contain them.
+// In that case, neither the format's prober nor its loader can succeed and both can be skipped.
+static bool IsFormatRuledOut(const FileFormatLoader &format, mpt::span<const mpt::byte> header)
+{
+	const FileFormatSignature &signature = format.signature;
+	if(signature.length == 0 || header.size() < static_cast<std::size_t>(signature.offset) + signature.length)
+	{
+		return false;
+	}
+	const mpt::byte *magic = header.data() + signature.offset;
+	return std::memcmp(magic, signature.magic, signature.length) != 0 && std::memcmp(magic, signature.magicAlt, signature.length) != 0;
+}
 
 
 CSoundFile::ProbeResult CSoundFile::ProbeAdditionalSize(MemoryFileReader &file, const uint64 *pfilesize, uint64 minimumAdditionalSize)
@@ -320,9 +354,12 @@ CSoundFile::ProbeResult CSoundFile::Probe(ProbeFlags flags, mpt::span<const mpt:
 	}
 	if(flags & ProbeModules)
 	{
+		// Only rule out formats by their magic bytes if no prober could ask for more data anymore,
+		// otherwise the result for short headers would change.
+		const bool headerComplete = (data.size() >= ProbeRecommendedSize) || (pfilesize && *pfilesize <= data.size());
 		for(const auto &format : ModuleFormatLoaders)
 		{
-			if(format.prober != nullptr)
+			if(format.prober != nullptr && !(headerComplete && IsFormatRuledOut(format, data)))
 			{
 				MPT_DO_PROBE(result, format.prober(file, pfilesize));
 			}
@@ -364,7 +401,7 @@ bool CSoundFile::Create(FileReader file, ModLoadingFlags loadFlags)
 #endif
 
 	MemsetZero(Instruments);
-	MemsetZero(m_szNames);
+	m_szNames.clear();
 #ifndef NO_PLUGINS
 	std::fill(std::begin(m_MixPlugins), std::end(m_MixPlugins), SNDMIXPLUGIN());
 #endif // NO_PLUGINS
@@ -381,6 +418,8 @@ bool CSoundFile::Create(FileReader file, ModLoadingFlags loadFlags)
 				if (unarchiver.ExtractBestFile(GetSupportedExtensions(true)))
 				{
 					file = unarchiver.GetOutputFile();
+					// The extracted data does not outlive this function.
+					loadFlags = static_cast<ModLoadingFlags>(loadFlags & ~deferSampleData);
 				}
 			}
 #endif
@@ -403,6 +442,8 @@ bool CSoundFile::Create(FileReader file, ModLoadingFlags loadFlags)
 					if(!containerItems.empty())
 					{
 						file = containerItems[0].file;
+						// The unpacked data does not outlive this function.
+						loadFlags = static_cast<ModLoadingFlags>(loadFlags & ~deferSampleData);
 					}
 				}
 			}
@@ -412,15 +453,34 @@ bool CSoundFile::Create(FileReader file, ModLoadingFlags loadFlags)
 				return false;
 			}
 
-			// Try all module format loaders
+			bool decodeDeferredSamples = false;
+			if(m_numLoadThreads > 1 && (loadFlags & loadSampleData) && !(loadFlags & deferSampleData))
+			{
+				// Let the loaders only locate the sample data, so that all of it can be decoded in parallel afterwards.
+				loadFlags = static_cast<ModLoadingFlags>(loadFlags | deferSampleData);
+				decodeDeferredSamples = true;
+			}
+
+			// Try all module format loaders that are not ruled out by the file's magic bytes
+			file.Rewind();
+			const FileReader::PinnedRawDataView header = file.GetPinnedRawDataView(ProbeRecommendedSize);
 			bool loaderSuccess = false;
 			for(const auto &format : ModuleFormatLoaders)
 			{
+				if(IsFormatRuledOut(format, header.span()))
+					continue;
 				loaderSuccess = (this->*(format.loader))(file, loadFlags);
 				if(loaderSuccess)
 					break;
 			}
 
+			if(decodeDeferredSamples)
+			{
+				// Decode while the file is still valid - unpacked or extracted data does not outlive this scope.
+				// Loops are precomputed below together with all other samples.
+				DecodeDeferredSampleData();
+			}
+
 			if(!loaderSuccess)
 			{
 				m_nType = MOD_TYPE_NONE;
@@ -461,11 +521,13 @@ bool CSoundFile::Create(FileReader file, ModLoadingFlags loadFlags)
 	}
 
 	// Adjust channels
+	UpdateNumVoices();
 	for(CHANNELINDEX ich = 0; ich < MAX_BASECHANNELS; ich++)
 	{
 		LimitMax(ChnSettings[ich].nVolume, uint16(64));
 		if (ChnSettings[ich].nPan > 256) ChnSettings[ich].nPan = 128;
-		m_PlayState.Chn[ich].Reset(ModChannel::resetTotal, *this, ich);
+		if(ich < GetNumVoices())
+			m_PlayState.Chn[ich].Reset(ModChannel::resetTotal, *this, ich);
 	}
 
 	// Checking samples, load external samples
@@ -502,6 +564,9 @@ bool CSoundFile::Create(FileReader file, ModLoadingFlags loadFlags)
 		if(sample.HasSampleData())
 		{
 			sample.PrecomputeLoops(*this, false);
+		} else if(IsSampleDataDeferred(nSmp))
+		{
+			// Loops are precomputed once the sample has been decoded.
 		} else if(!sample.uFlags[SMP_KEEPONDISK])
 		{
 			sample.nLength = 0;
@@ -526,35 +591,7 @@ bool CSoundFile::Create(FileReader file, ModLoadingFlags loadFlags)
 	}
 	m_nInstruments = maxInstr;
 
-	// Set default play state values
-	if (!m_nDefaultTempo.GetInt()) m_nDefaultTempo.Set(125);
-	if (!m_nDefaultSpeed) m_nDefaultSpeed = 6;
-	m_PlayState.m_nMusicSpeed = m_nDefaultSpeed;
-	m_PlayState.m_nMusicTempo = m_nDefaultTempo;
-	m_PlayState.m_nCurrentRowsPerBeat = m_nDefaultRowsPerBeat;
-	m_PlayState.m_nCurrentRowsPerMeasure = m_nDefaultRowsPerMeasure;
-	m_PlayState.m_nGlobalVolume = static_cast<int32>(m_nDefaultGlobalVolume);
-	m_PlayState.m_lHighResRampingGlobalVolume = m_PlayState.m_nGlobalVolume<<VOLUMERAMPPRECISION;
-	m_PlayState.m_nGlobalVolumeDestination = m_PlayState.m_nGlobalVolume;
-	m_PlayState.m_nSamplesToGlobalVolRampDest = 0;
-	m_PlayState.m_nGlobalVolumeRampAmount = 0;
-	m_PlayState.m_nNextOrder = 0;
-	m_PlayState.m_nCurrentOrder = 0;
-	m_PlayState.m_nPattern = 0;
-	m_PlayState.m_nBufferCount = 0;
-	m_PlayState.m_dBufferDiff = 0;
-	m_PlayState.m_nTickCount = m_PlayState.m_nMusicSpeed;
-	m_PlayState.m_nNextRow = 0;
-	m_PlayState.m_nRow = 0;
-	m_PlayState.m_nPatternDelay = 0;
-	m_PlayState.m_nFrameDelay = 0;
-	m_PlayState.m_nNextPatStartRow = 0;
-	m_PlayState.m_nSeqOverride = ORDERINDEX_INVALID;
-
-	m_nMaxOrderPosition = 0;
-
-	RecalculateSamplesPerTick();
-	visitedSongRows.Initialize(true);
+	InitializePlayState();
 
 	for(auto &order : Order)
 	{
@@ -661,6 +698,40 @@ bool CSoundFile::Create(FileReader file, ModLoadingFlags loadFlags)
 }
 
 
+void CSoundFile::InitializePlayState()
+{
+	// Set default play state values
+	if (!m_nDefaultTempo.GetInt()) m_nDefaultTempo.Set(125);
+	if (!m_nDefaultSpeed) m_nDefaultSpeed = 6;
+	m_PlayState.m_nMusicSpeed = m_nDefaultSpeed;
+	m_PlayState.m_nMusicTempo = m_nDefaultTempo;
+	m_PlayState.m_nCurrentRowsPerBeat = m_nDefaultRowsPerBeat;
+	m_PlayState.m_nCurrentRowsPerMeasure = m_nDefaultRowsPerMeasure;
+	m_PlayState.m_nGlobalVolume = static_cast<int32>(m_nDefaultGlobalVolume);
+	m_PlayState.m_lHighResRampingGlobalVolume = m_PlayState.m_nGlobalVolume<<VOLUMERAMPPRECISION;
+	m_PlayState.m_nGlobalVolumeDestination = m_PlayState.m_nGlobalVolume;
+	m_PlayState.m_nSamplesToGlobalVolRampDest = 0;
+	m_PlayState.m_nGlobalVolumeRampAmount = 0;
+	m_PlayState.m_nNextOrder = 0;
+	m_PlayState.m_nCurrentOrder = 0;
+	m_PlayState.m_nPattern = 0;
+	m_PlayState.m_nBufferCount = 0;
+	m_PlayState.m_dBufferDiff = 0;
+	m_PlayState.m_nTickCount = m_PlayState.m_nMusicSpeed;
+	m_PlayState.m_nNextRow = 0;
+	m_PlayState.m_nRow = 0;
+	m_PlayState.m_nPatternDelay = 0;
+	m_PlayState.m_nFrameDelay = 0;
+	m_PlayState.m_nNextPatStartRow = 0;
+	m_PlayState.m_nSeqOverride = ORDERINDEX_INVALID;
+
+	m_nMaxOrderPosition = 0;
+
+	RecalculateSamplesPerTick();
+	visitedSongRows.Initialize(true);
+}
+
+
 bool CSoundFile::Destroy()
 {
 	for(auto &chn : m_PlayState.Chn)
@@ -678,10 +749,18 @@ bool CSoundFile::Destroy()
 	m_songMessage.clear();
 	m_FileHistory.clear();
 
-	for(auto &smp : Samples)
+	Samples.ForEachAllocated([this](ModSample &smp)
 	{
+		if(IsSampleDataShared(smp))
+		{
+			// Freed once no CSoundFile refers to it anymore
+			smp.pData.pSample = nullptr;
+		}
 		smp.FreeSample();
-	}
+	});
+	m_sharedSamples.reset();
+	m_deferredSamples.reset();
+	m_ResampleCache.Clear();
 	for(auto &ins : Instruments)
 	{
 		delete ins;
@@ -701,6 +780,193 @@ bool CSoundFile::Destroy()
 }
 
 
+bool CSoundFile::CreateSharedCopy(CSoundFile &other)
+{
+	if(other.GetType() == MOD_TYPE_NONE)
+	{
+		return false;
+	}
+
+	// Only fully decoded sample data can be shared.
+	other.DecodeDeferredSamples();
+	if(!other.m_sharedSamples)
+	{
+		std::vector<void *> sampleData;
+		for(SAMPLEINDEX smp = 1; smp <= other.GetNumSamples(); smp++)
+		{
+			if(other.Samples[smp].HasSampleData())
+			{
+				sampleData.push_back(other.Samples[smp].samplev());
+			}
+		}
+		other.m_sharedSamples = std::make_shared<const SharedSamples>(std::move(sampleData));
+	}
+	m_sharedSamples = other.m_sharedSamples;
+
+	m_nType = other.m_nType;
+	m_ContainerType = other.m_ContainerType;
+	m_pModSpecs = other.m_pModSpecs;
+	m_playBehaviour = other.m_playBehaviour;
+	m_nChannels = other.m_nChannels;
+	m_nSamples = other.m_nSamples;
+	m_nInstruments = other.m_nInstruments;
+	m_nDefaultSpeed = other.m_nDefaultSpeed;
+	m_nDefaultGlobalVolume = other.m_nDefaultGlobalVolume;
+	m_nDefaultTempo = other.m_nDefaultTempo;
+	m_SongFlags = other.m_SongFlags;
+	m_SongFlags.reset(SONG_FADINGSONG | SONG_ENDREACHED);
+	m_nDefaultRowsPerBeat = other.m_nDefaultRowsPerBeat;
+	m_nDefaultRowsPerMeasure = other.m_nDefaultRowsPerMeasure;
+	m_nTempoMode = other.m_nTempoMode;
+	m_nSamplePreAmp = other.m_nSamplePreAmp;
+	m_nVSTiVolume = other.m_nVSTiVolume;
+	m_OPLVolumeFactor = other.m_OPLVolumeFactor;
+	m_tempoSwing = other.m_tempoSwing;
+	m_nMinPeriod = other.m_nMinPeriod;
+	m_nMaxPeriod = other.m_nMaxPeriod;
+	m_nResampling = other.m_nResampling;
+	std::copy(std::begin(other.ChnSettings), std::end(other.ChnSettings), std::begin(ChnSettings));
+	Patterns = other.Patterns;
+	Order = other.Order;
+	m_MidiCfg = other.m_MidiCfg;
+	m_szNames = other.m_szNames;
+	m_dwCreatedWithVersion = other.m_dwCreatedWithVersion;
+	m_dwLastSavedWithVersion = other.m_dwLastSavedWithVersion;
+	m_nMixLevels = other.m_nMixLevels;
+	m_songName = other.m_songName;
+	m_songArtist = other.m_songArtist;
+	m_songMessage = other.m_songMessage;
+	m_modFormat = other.m_modFormat;
+	m_FileHistory = other.m_FileHistory;
+#ifdef MPT_EXTERNAL_SAMPLES
+	m_samplePaths = other.m_samplePaths;
+#endif // MPT_EXTERNAL_SAMPLES
+
+	for(SAMPLEINDEX smp = 1; smp <= m_nSamples; smp++)
+	{
+		ModSample &sample = Samples[smp];
+		sample = other.Samples[smp];
+		if(sample.HasSampleData() && !IsSampleDataShared(sample))
+		{
+			// The other module has already modified this sample's data, so it cannot be shared.
+			sample.pData.pSample = nullptr;
+			if(!MakeSampleDataPrivate(sample, other.Samples[smp].samplev()))
+			{
+				return false;
+			}
+		}
+	}
+
+	for(size_t tuning = 0; tuning < other.GetTuneSpecificTunings().GetNumTunings(); tuning++)
+	{
+		std::unique_ptr<CTuning> copy = mpt::make_unique<CTuning>(other.GetTuneSpecificTunings().GetTuning(tuning));
+		if(!GetTuneSpecificTunings().AddTuning(copy.get()))
+		{
+			copy.release();
+		}
+	}
+	for(INSTRUMENTINDEX ins = 1; ins <= m_nInstruments; ins++)
+	{
+		if(other.Instruments[ins] == nullptr)
+		{
+			continue;
+		}
+		Instruments[ins] = new (std::nothrow) ModInstrument(*other.Instruments[ins]);
+		if(Instruments[ins] == nullptr)
+		{
+			return false;
+		}
+		// Tune-specific tunings are referred to by the instruments, so they have to point to this module's copies.
+		const CTuning *tuning = other.Instruments[ins]->pTuning;
+		Instruments[ins]->pTuning = nullptr;
+		for(size_t i = 0; i < other.GetTuneSpecificTunings().GetNumTunings() && i < GetTuneSpecificTunings().GetNumTunings(); i++)
+		{
+			if(tuning == &other.GetTuneSpecificTunings().GetTuning(i))
+			{
+				Instruments[ins]->pTuning = &GetTuneSpecificTunings().GetTuning(i);
+				break;
+			}
+		}
+	}
+
+	UpdateNumVoices();
+	for(CHANNELINDEX chn = 0; chn < std::min(MAX_BASECHANNELS, GetNumVoices()); chn++)
+	{
+		m_PlayState.Chn[chn].Reset(ModChannel::resetTotal, *this, chn);
+	}
+	for(SAMPLEINDEX smp = 1; smp <= m_nSamples; smp++)
+	{
+		if(Samples[smp].uFlags[CHN_ADLIB] && m_opl == nullptr) InitOPL();
+	}
+	InitializePlayState();
+
+#ifndef NO_PLUGINS
+	// Plugins keep their own state, so every module gets its own instances.
+	for(PLUGINDEX plug = 0; plug < MAX_MIXPLUGINS; plug++)
+	{
+		auto &plugin = m_MixPlugins[plug];
+		plugin = other.m_MixPlugins[plug];
+		plugin.pMixPlugin = nullptr;
+		if(plugin.IsValidPlugin() && other.m_MixPlugins[plug].pMixPlugin != nullptr)
+		{
+			CreateMixPluginProc(plugin, *this);
+			if(plugin.pMixPlugin)
+			{
+				plugin.pMixPlugin->RestoreAllParameters(plugin.defaultProgram);
+			}
+		}
+	}
+#endif // NO_PLUGINS
+
+	SetMixLevels(m_nMixLevels);
+	return true;
+}
+
+
+bool CSoundFile::IsSampleDataShared(const ModSample &sample) const
+{
+	return m_sharedSamples && m_sharedSamples->Contains(sample.samplev());
+}
+
+
+bool CSoundFile::MakeSampleDataPrivate(ModSample &sample)
+{
+	if(!IsSampleDataShared(sample))
+	{
+		return true;
+	}
+	const void *sharedData = sample.samplev();
+	if(!MakeSampleDataPrivate(sample, sharedData))
+	{
+		return false;
+	}
+	// Voices that are playing the sample have to continue with the copy.
+	for(auto &chn : m_PlayState.Chn)
+	{
+		if(chn.pCurrentSample == sharedData)
+		{
+			chn.pCurrentSample = sample.samplev();
+		}
+	}
+	return true;
+}
+
+
+// Replace a sample's data pointer by a copy of the given data.
+bool CSoundFile::MakeSampleDataPrivate(ModSample &sample, const void *data)
+{
+	void *copy = ModSample::AllocateSample(sample.nLength, sample.GetBytesPerSample());
+	if(copy == nullptr)
+	{
+		return false;
+	}
+	std::memcpy(copy, data, sample.GetSampleSizeInBytes());
+	sample.pData.pSample = copy;
+	sample.PrecomputeLoops(*this, false);
+	return true;
+}
+
+
 //////////////////////////////////////////////////////////////////////////
 // Misc functions
 
@@ -754,7 +1020,7 @@ double CSoundFile::GetCurrentBPM() const
 
 void CSoundFile::ResetPlayPos()
 {
-	for(CHANNELINDEX i = 0; i < MAX_CHANNELS; i++)
+	for(CHANNELINDEX i = 0; i < GetNumVoices(); i++)
 		m_PlayState.Chn[i].Reset(ModChannel::resetSetPosFull, *this, i);
 
 	visitedSongRows.Initialize(true);
@@ -908,7 +1174,7 @@ void CSoundFile::ResetChannels()
 		chn.nLength = 0;
 		if(chn.dwFlags[CHN_ADLIB] && m_opl)
 		{
-			CHANNELINDEX c = static_cast<CHANNELINDEX>(std::distance(std::begin(m_PlayState.Chn), &chn));
+			CHANNELINDEX c = static_cast<CHANNELINDEX>(std::distance(m_PlayState.Chn.data(), &chn));
 			m_opl->NoteCut(c);
 		}
 	}
@@ -1258,7 +1524,8 @@ bool CSoundFile::InitChannel(CHANNELINDEX nChn)
 	if(nChn >= MAX_BASECHANNELS) return true;
 
 	ChnSettings[nChn].Reset();
-	m_PlayState.Chn[nChn].Reset(ModChannel::resetTotal, *this, nChn);
+	if(nChn < GetNumVoices())
+		m_PlayState.Chn[nChn].Reset(ModChannel::resetTotal, *this, nChn);
 
 #ifdef MODPLUG_TRACKER
 	if(GetpModDoc() != nullptr)
@@ -1276,6 +1543,32 @@ bool CSoundFile::InitChannel(CHANNELINDEX nChn)
 }
 
 
+void CSoundFile::SetMaxVoices(CHANNELINDEX maxVoices)
+{
+	m_maxVoices = Clamp(maxVoices, CHANNELINDEX(1), MAX_CHANNELS);
+	UpdateNumVoices();
+}
+
+
+void CSoundFile::UpdateNumVoices()
+{
+	const CHANNELINDEX numVoices = Clamp(std::max(m_maxVoices, m_nChannels), CHANNELINDEX(1), MAX_CHANNELS);
+	if(numVoices < GetNumVoices())
+	{
+		for(CHANNELINDEX chn = numVoices; chn < GetNumVoices(); chn++)
+		{
+			if(m_opl)
+				m_opl->NoteCut(chn);
+		}
+		// Voices that are cut off must not be mixed anymore
+		auto mixEnd = std::remove_if(std::begin(m_PlayState.ChnMix), std::begin(m_PlayState.ChnMix) + m_nMixChannels, [numVoices](CHANNELINDEX chn) { return chn >= numVoices; });
+		m_nMixChannels = static_cast<CHANNELINDEX>(std::distance(std::begin(m_PlayState.ChnMix), mixEnd));
+	}
+	m_PlayState.Chn.resize(numVoices);
+	m_PlayState.Chn.shrink_to_fit();
+}
+
+
 void CSoundFile::InitAmigaResampler()
 {
 	if(m_SongFlags[SONG_ISAMIGA] && m_Resampler.m_Settings.emulateAmiga)
@@ -1398,6 +1691,10 @@ bool CSoundFile::DestroySample(SAMPLEINDEX nSample)
 	{
 		return false;
 	}
+	if(m_deferredSamples)
+	{
+		m_deferredSamples->Remove(nSample);
+	}
 	if(!Samples[nSample].HasSampleData())
 	{
 		return true;
@@ -1415,6 +1712,10 @@ bool CSoundFile::DestroySample(SAMPLEINDEX nSample)
 		}
 	}
 
+	if(IsSampleDataShared(sample))
+	{
+		sample.pData.pSample = nullptr;
+	}
 	sample.FreeSample();
 	sample.nLength = 0;
 	sample.uFlags.reset(CHN_16BIT | CHN_STEREO);
@@ -1434,6 +1735,122 @@ bool CSoundFile::DestroySampleThreadsafe(SAMPLEINDEX nSample)
 }
 
 
+void CSoundFile::DeferSampleData(SAMPLEINDEX smp, const SampleIO &format, const FileReader &file)
+{
+	if(Samples[smp].nLength == 0 || !file.IsValid())
+	{
+		return;
+	}
+	if(!m_deferredSamples)
+	{
+		m_deferredSamples = mpt::make_unique<DeferredSamples>();
+	}
+	m_deferredSamples->Add(smp, format, file);
+}
+
+
+bool CSoundFile::IsSampleDataDeferred(SAMPLEINDEX smp) const
+{
+	return m_deferredSamples && m_deferredSamples->Contains(smp);
+}
+
+
+SAMPLEINDEX CSoundFile::GetNumDeferredSamples() const
+{
+	return m_deferredSamples ? static_cast<SAMPLEINDEX>(m_deferredSamples->size()) : 0;
+}
+
+
+// Precomputing loops invalidates the resample cache, so it must not be done from a sample decode job.
+static void FinishDeferredSample(ModSample &sample, CSoundFile &sndFile)
+{
+	if(sample.HasSampleData())
+	{
+		sample.PrecomputeLoops(sndFile, false);
+	} else
+	{
+		sample.nLength = 0;
+		sample.SanitizeLoops();
+	}
+}
+
+
+bool CSoundFile::DecodeDeferredSample(SAMPLEINDEX smp)
+{
+	DeferredSamples::Entry entry;
+	if(!m_deferredSamples || !m_deferredSamples->Take(smp, entry))
+	{
+		return false;
+	}
+	if(m_deferredSamples->empty())
+	{
+		m_deferredSamples.reset();
+	}
+
+	ModSample &sample = Samples[smp];
+	entry.format.ReadSample(sample, entry.file);
+	FinishDeferredSample(sample, *this);
+	return true;
+}
+
+
+void CSoundFile::DecodeDeferredSamples()
+{
+	for(SAMPLEINDEX smp : DecodeDeferredSampleData())
+	{
+		FinishDeferredSample(Samples[smp], *this);
+	}
+}
+
+
+std::vector<SAMPLEINDEX> CSoundFile::DecodeDeferredSampleData()
+{
+	std::vector<SAMPLEINDEX> decoded;
+	if(!m_deferredSamples)
+	{
+		return decoded;
+	}
+	auto entries = m_deferredSamples->TakeAll();
+	m_deferredSamples.reset();
+
+	if(m_numLoadThreads > 1)
+	{
+		// Reading from a stream is not thread-safe, so make sure that the decode jobs only ever read from memory.
+		for(const auto &entry : entries)
+		{
+			entry.second.file.CacheWholeFile();
+		}
+	}
+	RunSampleDecodeJobs(entries.size(), [this, &entries](std::size_t i)
+	{
+		entries[i].second.format.ReadSample(Samples[entries[i].first], entries[i].second.file);
+	});
+	decoded.reserve(entries.size());
+	for(const auto &entry : entries)
+	{
+		decoded.push_back(entry.first);
+	}
+	return decoded;
+}
+
+
+void CSoundFile::RunSampleDecodeJobs(std::size_t numJobs, const std::function<void(std::size_t)> &job) const
+{
+#if defined(MPT_ENABLE_THREAD)
+	const std::size_t numThreads = std::min(static_cast<std::size_t>(m_numLoadThreads), numJobs);
+	if(numThreads > 1)
+	{
+		mpt::ThreadPool(numThreads).Run(numJobs, job);
+		return;
+	}
+#endif // MPT_ENABLE_THREAD
+	for(std::size_t i = 0; i < numJobs; i++)
+	{
+		job(i);
+	}
+}
+
+
 CTuning* CSoundFile::CreateTuning12TET(const std::string &name)
 {
 	CTuning* pT = CTuning::CreateGeometric(name, 12, 2, 15);
@@ -1851,6 +2268,7 @@ bool CSoundFile::LoadExternalSample(SAMPLEINDEX smp, const mpt::PathString &file
 			SampleFlags newFlags = sample.uFlags;
 
 			sample = origSample;
+			sample.InvalidatePeakMap();
 			sample.nLength = newLength;
 			sample.pData.pSample = newData;
 			sample.uFlags.set(CHN_16BIT, newFlags[CHN_16BIT]);
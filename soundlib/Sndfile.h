@@ -21,15 +21,18 @@
 #include <vector>
 #include <bitset>
 #include <set>
+#include <functional>
 #include "Snd_defs.h"
 #include "tuningbase.h"
 #include "MIDIMacros.h"
+#include "ChunkedArray.h"
 #ifdef MODPLUG_TRACKER
 #include "../mptrack/MIDIMapping.h"
 #endif // MODPLUG_TRACKER
 
 #include "Mixer.h"
 #include "Resampler.h"
+#include "ResampleCache.h"
 #ifndef NO_REVERB
 #include "../sounddsp/Reverb.h"
 #endif
@@ -82,6 +85,13 @@ class CVstPluginManager;
 
 typedef std::bitset<kMaxPlayBehaviours> PlayBehaviourSet;
 
+#ifdef MPT_ENABLE_THREAD
+namespace mpt
+{
+class ThreadPool;
+} // namespace mpt
+#endif // MPT_ENABLE_THREAD
+
 #ifdef MODPLUG_TRACKER
 
 // For WAV export (writing pattern positions to file)
@@ -199,6 +209,34 @@ enum enmGetLengthResetMode
 };
 
 
+// Seek index for GetLength(): Snapshots of the GetLength() state, taken in regular intervals while scanning a song.
+// Seeking can then resume from the closest snapshot preceding the target instead of simulating the song from its start.
+// Snapshots are only valid for the mixing frequency and tempo factor they were taken with; if either changes, the index is cleared automatically.
+// The index is not used in eAdjustSamplePositions mode.
+class GetLengthSeekIndex
+{
+	friend class CSoundFile;
+public:
+	struct Checkpoint;
+
+	// interval: Minimum distance between two snapshots, in seconds
+	explicit GetLengthSeekIndex(double interval = 10.0);
+	~GetLengthSeekIndex();
+
+	void Clear();
+	// Move all snapshots of another index (e.g. one that was filled by a concurrent scan) to the end of this index.
+	void Append(GetLengthSeekIndex &other);
+	std::size_t GetNumCheckpoints() const { return m_checkpoints.size(); }
+	double GetInterval() const { return m_interval; }
+
+protected:
+	std::vector<std::unique_ptr<Checkpoint>> m_checkpoints;
+	double m_interval;
+	uint32 m_mixingFreq = 0;
+	uint32 m_tempoFactor = 0;
+};
+
+
 // Delete samples assigned to instrument
 enum deleteInstrumentSamples
 {
@@ -213,6 +251,10 @@ class CTuningCollection;
 typedef Tuning::CTuningCollection CTuningCollection;
 struct CModSpecifications;
 class OPL;
+class SampleIO;
+class DeferredSamples;
+class SharedSamples;
+struct GetLengthAdjustState;
 #ifdef MODPLUG_TRACKER
 class CModDoc;
 #endif // MODPLUG_TRACKER
@@ -245,6 +287,31 @@ struct TimingInfo
 };
 
 
+// Time spent in the processing stages of CSoundFile::Read, and the amount of work done.
+// The counters are always collected, as this only requires reading the clock once per stage and render chunk.
+struct RenderProfile
+{
+	enum Stage
+	{
+		stageReadNote = 0,	// Pattern and effect processing (once per tick)
+		stageMix,	// Mixing of sample voices
+		stageOPL,	// OPL synthesis
+		stageReverb,	// Reverb
+		stagePlugins,	// Mix plugins
+		stageDSP,	// Global volume, stereo separation and DSP effects
+		stageOutput,	// Conversion to the output format
+		numStages
+	};
+
+	uint64 nanoseconds[numStages] = { };
+	uint64 calls[numStages] = { };
+	uint64 voicesMixed = 0;	// Sum of the number of voices mixed in each render chunk
+	uint64 frames = 0;	// Number of rendered frames
+
+	void Reset() { *this = RenderProfile(); }
+};
+
+
 struct ModFormatDetails
 {
 	mpt::ustring formatName;         // "FastTracker 2"
@@ -351,18 +418,53 @@ private: //Misc data
 	const CModSpecifications *m_pModSpecs;
 
 private:
+	// Mix buffers, sized according to the render block size (see AllocateMixBuffers)
+	std::vector<mixsample_t> m_mixBufferStorage;
+	std::vector<float> m_mixFloatBufferStorage;
 	// Interleaved Front Mix Buffer (Also room for interleaved rear mix)
-	mixsample_t MixSoundBuffer[MIXBUFFERSIZE * 4];
-	mixsample_t MixRearBuffer[MIXBUFFERSIZE * 2];
+	mixsample_t *MixSoundBuffer = nullptr;
+	mixsample_t *MixRearBuffer = nullptr;
 	// Non-interleaved plugin processing buffer
-	float MixFloatBuffer[2][MIXBUFFERSIZE];
+	float *MixFloatBuffer[2] = { nullptr, nullptr };
 	mixsample_t gnDryLOfsVol = 0;
 	mixsample_t gnDryROfsVol = 0;
-	mixsample_t MixInputBuffer[NUMMIXINPUTBUFFERS][MIXBUFFERSIZE];
+	mixsample_t *MixInputBuffer[NUMMIXINPUTBUFFERS] = { };
+	uint32 m_mixBufferSize = 0;	// Number of frames that fit into the mix buffers
+
+#ifdef MPT_ENABLE_THREAD
+	// Voices that are mixed on a worker thread, and the buffers they are mixed into.
+	// The partial buffers of all jobs are summed up in job order after mixing, so the result does not depend on thread scheduling.
+	struct MixJob
+	{
+		enum Target : uint8
+		{
+			targetDry,
+			targetReverb,
+			targetRear,
+			targetRearReverbOfs,	// Surround voice with reverb send: Mixed into rear buffer, but click removal goes to the reverb buffer
+		};
+		struct Voice
+		{
+			CHANNELINDEX channel;
+			Target target;
+		};
+		std::vector<Voice> voices;
+		std::vector<mixsample_t> dryBuffer;
+		std::vector<mixsample_t> rearBuffer;
+		std::vector<mixsample_t> reverbBuffer;
+		mixsample_t dryOfsR, dryOfsL, reverbOfsR, reverbOfsL;
+		CHANNELINDEX numMixed;
+		uint32 skippedFrames;
+		bool useRear, useReverb;
+	};
+	std::unique_ptr<mpt::ThreadPool> m_mixThreadPool;
+	std::vector<MixJob> m_mixJobs;
+#endif // MPT_ENABLE_THREAD
 
 public:
 	MixerSettings m_MixerSettings;
 	CResampler m_Resampler;
+	ResampleCache m_ResampleCache;
 #ifndef NO_REVERB
 	CReverb m_Reverb;
 #endif
@@ -395,7 +497,12 @@ public:
 	FlagSet<SongFlags> m_SongFlags;
 	CHANNELINDEX m_nMixChannels = 0;
 private:
+	CHANNELINDEX m_maxVoices = MAX_CHANNELS;	// Upper limit for the number of voices (pattern channels and NNA background channels)
 	CHANNELINDEX m_nMixStat;
+	uint64 m_silentFramesSkipped = 0;	// Number of voice frames that were not mixed because the sample was silent
+	CHANNELINDEX m_numDegradedVoices = 0;	// Number of quietest voices that are rendered with reduced resampling quality to meet the render time budget
+	uint64 m_qualityDegradations = 0;	// Number of times the resampling quality was reduced because the render time budget was exceeded
+	RenderProfile m_renderProfile;
 public:
 	ROWINDEX m_nDefaultRowsPerBeat, m_nDefaultRowsPerMeasure;	// default rows per beat and measure for this module
 	TempoMode m_nTempoMode = tempoModeClassic;
@@ -432,14 +539,14 @@ public:
 	CPatternContainer Patterns;
 	ModSequenceSet Order;								// Pattern sequences (order lists)
 protected:
-	ModSample Samples[MAX_SAMPLES];						// Sample Headers
+	ChunkedArray<ModSample, MAX_SAMPLES> Samples;		// Sample Headers, only allocated for the sample slots in use
 public:
 	ModInstrument *Instruments[MAX_INSTRUMENTS];		// Instrument Headers
 	MIDIMacroConfig m_MidiCfg;							// MIDI Macro config table
 #ifndef NO_PLUGINS
 	SNDMIXPLUGIN m_MixPlugins[MAX_MIXPLUGINS];			// Mix plugins
 #endif
-	char m_szNames[MAX_SAMPLES][MAX_SAMPLENAME];		// Sample names
+	ChunkedArray<char[MAX_SAMPLENAME], MAX_SAMPLES> m_szNames;	// Sample names
 
 	Version m_dwCreatedWithVersion;
 	Version m_dwLastSavedWithVersion;
@@ -499,12 +606,12 @@ public:
 
 	public:
 		CHANNELINDEX ChnMix[MAX_CHANNELS]; // Channels to be mixed
-		ModChannel Chn[MAX_CHANNELS];      // Mixing channels... First m_nChannels channels are master channels (i.e. they are never NNA channels)!
+		std::vector<ModChannel> Chn;       // Mixing channels (see CSoundFile::GetNumVoices)... First m_nChannels channels are master channels (i.e. they are never NNA channels)!
 
 	public:
 		PlayState()
+			: Chn(MAX_CHANNELS)
 		{
-			std::fill(std::begin(Chn), std::end(Chn), ModChannel());
 		}
 	};
 
@@ -558,6 +665,46 @@ public:
 	bool LoadExternalSample(SAMPLEINDEX smp, const mpt::PathString &filename);
 #endif // MPT_EXTERNAL_SAMPLES
 
+	// Sample data whose decoding has been postponed while loading (see deferSampleData)
+protected:
+	std::unique_ptr<DeferredSamples> m_deferredSamples;
+
+public:
+	// Remember the location of a sample's data instead of decoding it. The file must be positioned at the start of the encoded data.
+	void DeferSampleData(SAMPLEINDEX smp, const SampleIO &format, const FileReader &file);
+	bool IsSampleDataDeferred(SAMPLEINDEX smp) const;
+	SAMPLEINDEX GetNumDeferredSamples() const;
+	// Decode the deferred data of a sample. Returns false if the sample's data has not been deferred.
+	bool DecodeDeferredSample(SAMPLEINDEX smp);
+	// Decode all remaining deferred sample data. Rendering and seeking never decode anything, samples whose data is still deferred are simply not played.
+	void DecodeDeferredSamples();
+protected:
+	// Decode all remaining deferred sample data without precomputing loops. Returns the indices of the decoded samples.
+	std::vector<SAMPLEINDEX> DecodeDeferredSampleData();
+
+	// Sample data that is shared with other CSoundFile instances (see CreateSharedCopy)
+protected:
+	std::shared_ptr<const SharedSamples> m_sharedSamples;
+
+public:
+	bool IsSampleDataShared(const ModSample &sample) const;
+	// Give a sample its own copy of its data if the data is shared, so that it can be modified. Returns false if the data could not be copied.
+	bool MakeSampleDataPrivate(ModSample &sample);
+protected:
+	bool MakeSampleDataPrivate(ModSample &sample, const void *data);
+
+	// Number of threads used for decoding sample data while loading, including the loading thread
+protected:
+	uint32 m_numLoadThreads = 1;
+
+public:
+	void SetNumLoadThreads(uint32 numThreads) { m_numLoadThreads = std::max(numThreads, uint32(1)); }
+	uint32 GetNumLoadThreads() const { return m_numLoadThreads; }
+	// Calls job(i) for all i in [0, numJobs), spread over GetNumLoadThreads() threads.
+	// Jobs must not touch any state except for the sample they are decoding (in particular, they must not log anything).
+	void RunSampleDecodeJobs(std::size_t numJobs, const std::function<void(std::size_t)> &job) const;
+
+public:
 	bool m_bIsRendering = false;
 	TimingInfo m_TimingInfo; // only valid if !m_bIsRendering
 
@@ -586,6 +733,8 @@ public:
 		loadPluginInstance = 0x08, // If unset, plugins are not instanciated.
 		skipContainer      = 0x10,
 		skipModules        = 0x20,
+		deferSampleData    = 0x40, // If set, loaders that support it only remember where sample data is located and decode it in DecodeDeferredSamples().
+		                           // The file data must stay valid until all samples have been decoded or the CSoundFile is destroyed.
 
 		// Shortcuts
 		loadCompleteModule = loadSampleData | loadPatternData | loadPluginData | loadPluginInstance,
@@ -629,6 +778,9 @@ public:
 #endif // MODPLUG_TRACKER
 
 	bool Destroy();
+	// Turn this (empty) CSoundFile into a copy of another, already loaded module that shares the other module's sample data.
+	// Patterns, instruments and plugins are copied, and the play state is reset. The other module must not be playing while it is being copied.
+	bool CreateSharedCopy(CSoundFile &other);
 	Enum<MODTYPE> GetType() const noexcept { return m_nType; }
 
 	MODCONTAINERTYPE GetContainerType() const noexcept { return m_ContainerType; }
@@ -659,6 +811,15 @@ public:
 	PATTERNINDEX GetCurrentPattern() const { return m_PlayState.m_nPattern; }
 	ORDERINDEX GetCurrentOrder() const { return m_PlayState.m_nCurrentOrder; }
 	CHANNELINDEX GetNumChannels() const { return m_nChannels; }
+	// Number of voices (pattern channels and NNA background channels) that can play at the same time
+	CHANNELINDEX GetNumVoices() const { return static_cast<CHANNELINDEX>(m_PlayState.Chn.size()); }
+	CHANNELINDEX GetMaxVoices() const { return m_maxVoices; }
+	// Limit the number of voices to save memory and CPU time. The limit is never lower than the number of pattern channels.
+	// Notes that are playing on voices beyond the new limit are cut.
+	void SetMaxVoices(CHANNELINDEX maxVoices);
+protected:
+	void UpdateNumVoices();
+public:
 
 #ifndef NO_PLUGINS
 	IMixPlugin* GetInstrumentPlugin(INSTRUMENTINDEX instr);
@@ -675,6 +836,13 @@ public:
 	void DontLoopPattern(PATTERNINDEX nPat, ROWINDEX nRow = 0);
 	CHANNELINDEX GetMixStat() const { return m_nMixStat; }
 	void ResetMixStat() { m_nMixStat = 0; }
+	uint64 GetSilentFramesSkipped() const { return m_silentFramesSkipped; }
+	void ResetSilentFramesSkipped() { m_silentFramesSkipped = 0; }
+	CHANNELINDEX GetNumDegradedVoices() const { return m_numDegradedVoices; }
+	uint64 GetQualityDegradations() const { return m_qualityDegradations; }
+	void ResetQualityDegradations() { m_qualityDegradations = 0; }
+	const RenderProfile &GetRenderProfile() const { return m_renderProfile; }
+	void ResetRenderProfile() { m_renderProfile.Reset(); }
 	void ResetPlayPos();
 	void SetCurrentOrder(ORDERINDEX nOrder);
 	std::string GetTitle() const { return m_songName; }
@@ -686,7 +854,14 @@ public:
 	bool IsFirstTick() const { return (m_PlayState.m_lTotalSampleCount == 0); }
 
 	// Get song duration in various cases: total length, length to specific order & row, etc.
-	std::vector<GetLengthType> GetLength(enmGetLengthResetMode adjustMode, GetLengthTarget target = GetLengthTarget());
+	// If a seek index is provided, seeking starts from the closest suitable snapshot, and new snapshots are recorded while scanning.
+	std::vector<GetLengthType> GetLength(enmGetLengthResetMode adjustMode, GetLengthTarget target = GetLengthTarget(), GetLengthSeekIndex *seekIndex = nullptr);
+	// Same as GetLength(eNoAdjust, ...), but guaranteed not to modify the CSoundFile object.
+	// Several scans (e.g. of different sequences) may run concurrently if each of them uses its own seek index (or none)
+	// and the module is neither modified nor played in the meantime.
+	std::vector<GetLengthType> ScanLength(GetLengthTarget target = GetLengthTarget(), GetLengthSeekIndex *seekIndex = nullptr) const { return GetLengthScan(eNoAdjust, target, seekIndex, nullptr); }
+protected:
+	std::vector<GetLengthType> GetLengthScan(enmGetLengthResetMode adjustMode, const GetLengthTarget &target, GetLengthSeekIndex *seekIndex, GetLengthAdjustState *adjustState) const;
 
 public:
 	void RecalculateSamplesPerTick();
@@ -851,7 +1026,15 @@ public:
 	samplecount_t Read(samplecount_t count, IAudioReadTarget &target) { AudioSourceNone source; return Read(count, target, source); }
 	samplecount_t Read(samplecount_t count, IAudioReadTarget &target, IAudioSource &source);
 private:
+	void AllocateMixBuffers();
+	void UpdateRenderQuality(uint64 renderMicroseconds);
+	void DegradeQuietVoices();
 	void CreateStereoMix(int count);
+	CHANNELINDEX MixVoice(ModChannel &chn, mixsample_t *pbuffer, mixsample_t &ofsR, mixsample_t &ofsL, int count, bool mixLimitReached, uint32 &skippedFrames, ResampleCache *resampleCache) const;
+#ifdef MPT_ENABLE_THREAD
+	void UpdateMixThreads();
+	void RunMixJobs(int count);
+#endif // MPT_ENABLE_THREAD
 public:
 	bool FadeSong(uint32 msec);
 private:
@@ -898,6 +1081,8 @@ protected:
 	void SetType(MODTYPE type);
 	void InitializeGlobals(MODTYPE type = MOD_TYPE_NONE);
 	void InitializeChannels();
+	// Set up the play state for playback from the start of the song after loading
+	void InitializePlayState();
 
 	// Channel effect processing
 	int GetVibratoDelta(int type, int position) const;
@@ -952,7 +1137,7 @@ protected:
 	void TonePortamento(ModChannel &chn, uint32 param) const;
 	void Vibrato(ModChannel &chn, uint32 param) const;
 	void FineVibrato(ModChannel &chn, uint32 param) const;
-	void VolumeSlide(ModChannel &chn, ModCommand::PARAM param);
+	void VolumeSlide(ModChannel &chn, ModCommand::PARAM param) const;
 	void PanningSlide(ModChannel &chn, ModCommand::PARAM param, bool memory = true);
 	void ChannelVolSlide(ModChannel &chn, ModCommand::PARAM param) const;
 	void FineVolumeUp(ModChannel &chn, ModCommand::PARAM param, bool volCol) const;
@@ -1091,8 +1276,8 @@ public:
 	uint32 GetPeriodFromNote(uint32 note, int32 nFineTune, uint32 nC5Speed) const;
 	uint32 GetFreqFromPeriod(uint32 period, uint32 c5speed, int32 nPeriodFrac = 0) const;
 	// Misc functions
-	ModSample &GetSample(SAMPLEINDEX sample) { MPT_ASSERT(sample <= m_nSamples && sample < CountOf(Samples)); return Samples[sample]; }
-	const ModSample &GetSample(SAMPLEINDEX sample) const { MPT_ASSERT(sample <= m_nSamples && sample < CountOf(Samples)); return Samples[sample]; }
+	ModSample &GetSample(SAMPLEINDEX sample) { MPT_ASSERT(sample <= m_nSamples && sample < Samples.size()); return Samples[sample]; }
+	const ModSample &GetSample(SAMPLEINDEX sample) const { MPT_ASSERT(sample <= m_nSamples && sample < Samples.size()); return Samples[sample]; }
 
 	uint32 MapMidiInstrument(uint8 program, uint16 bank, uint8 midiChannel, uint8 note, bool isXG, std::bitset<16> drumChns);
 	size_t ITInstrToMPT(FileReader &file, ModInstrument &ins, uint16 trkvers);
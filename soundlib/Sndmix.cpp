@@ -24,6 +24,8 @@
 #endif // NO_PLUGINS
 #include "OPL.h"
 
+#include <chrono>
+
 OPENMPT_NAMESPACE_BEGIN
 
 // VU-Meter
@@ -70,12 +72,56 @@ void CSoundFile::SetMixerSettings(const MixerSettings &mixersettings)
 		(mixersettings.MixerFlags != m_MixerSettings.MixerFlags))
 		reset = true;
 	m_MixerSettings = mixersettings;
+	if(!m_MixerSettings.RenderTimeBudgetMicroseconds)
+		m_numDegradedVoices = 0;
+	m_ResampleCache.SetMaxSize(m_MixerSettings.ResampleCacheSize);
+#ifdef MPT_ENABLE_THREAD
+	UpdateMixThreads();
+#endif // MPT_ENABLE_THREAD
+	AllocateMixBuffers();
 	InitPlayer(reset);
 }
 
 
+// Resize all mix buffers so that they can hold a full render block
+void CSoundFile::AllocateMixBuffers()
+{
+	// Leave some headroom for SIMD loops that process a few more frames than requested
+	const uint32 bufferSize = Util::AlignUp<uint32>(Clamp(m_MixerSettings.RenderBlockSize, 1u, uint32(MIXBUFFERSIZE_MAX)), 8);
+	if(bufferSize != m_mixBufferSize)
+	{
+		m_mixBufferSize = bufferSize;
+		// Front buffer with room for interleaved rear mix, rear buffer, input buffers
+		m_mixBufferStorage.assign(bufferSize * (4 + 2 + NUMMIXINPUTBUFFERS), 0);
+		MixSoundBuffer = m_mixBufferStorage.data();
+		MixRearBuffer = MixSoundBuffer + bufferSize * 4;
+		for(std::size_t channel = 0; channel < NUMMIXINPUTBUFFERS; ++channel)
+		{
+			MixInputBuffer[channel] = MixRearBuffer + bufferSize * (2 + channel);
+		}
+		m_mixFloatBufferStorage.assign(bufferSize * 2, 0.0f);
+		MixFloatBuffer[0] = m_mixFloatBufferStorage.data();
+		MixFloatBuffer[1] = m_mixFloatBufferStorage.data() + bufferSize;
+#ifndef NO_REVERB
+		m_Reverb.SetBufferSize(bufferSize);
+#endif // NO_REVERB
+	}
+#ifdef MPT_ENABLE_THREAD
+	for(auto &job : m_mixJobs)
+	{
+		job.dryBuffer.resize(bufferSize * 2);
+		job.rearBuffer.resize(bufferSize * 2);
+		job.reverbBuffer.resize(bufferSize * 2);
+	}
+#endif // MPT_ENABLE_THREAD
+}
+
+
 void CSoundFile::SetResamplerSettings(const CResamplerSettings &resamplersettings)
 {
+	// Cached sampling points were interpolated with the old filter tables
+	if(resamplersettings != m_Resampler.m_Settings)
+		m_ResampleCache.Clear();
 	m_Resampler.m_Settings = resamplersettings;
 	m_Resampler.UpdateTables();
 	InitAmigaResampler();
@@ -207,6 +253,8 @@ CSoundFile::samplecount_t CSoundFile::Read(samplecount_t count, IAudioReadTarget
 {
 	MPT_ASSERT_ALWAYS(m_MixerSettings.IsValid());
 
+	const auto renderStart = std::chrono::steady_clock::now();
+
 	bool mixPlugins = false;
 #ifndef NO_PLUGINS
 	for(const auto &plug : m_MixPlugins)
@@ -219,9 +267,32 @@ CSoundFile::samplecount_t CSoundFile::Read(samplecount_t count, IAudioReadTarget
 	}
 #endif // NO_PLUGINS
 
+	// Plugins and the EQ can only process up to MIXBUFFERSIZE frames at once
+	samplecount_t maxChunkSize = std::min<samplecount_t>(m_MixerSettings.RenderBlockSize, m_mixBufferSize);
+	if(mixPlugins)
+	{
+		maxChunkSize = std::min<samplecount_t>(maxChunkSize, MIXBUFFERSIZE);
+	}
+#ifndef NO_EQ
+	if(m_MixerSettings.DSPMask & SNDDSP_EQ)
+	{
+		maxChunkSize = std::min<samplecount_t>(maxChunkSize, MIXBUFFERSIZE);
+	}
+#endif // NO_EQ
+
 	samplecount_t countRendered = 0;
 	samplecount_t countToRender = count;
 
+	// Attribute the time since the end of the previous stage to the given stage
+	auto stageStart = renderStart;
+	const auto endStage = [this, &stageStart](RenderProfile::Stage stage)
+	{
+		const auto now = std::chrono::steady_clock::now();
+		m_renderProfile.nanoseconds[stage] += static_cast<uint64>(std::chrono::duration_cast<std::chrono::nanoseconds>(now - stageStart).count());
+		m_renderProfile.calls[stage]++;
+		stageStart = now;
+	};
+
 	while(!m_SongFlags[SONG_ENDREACHED] && countToRender > 0)
 	{
 
@@ -237,6 +308,7 @@ CSoundFile::samplecount_t CSoundFile::Read(samplecount_t count, IAudioReadTarget
 			} else if(ReadNote())
 			{
 				// Render next tick (normal progress)
+				endStage(RenderProfile::stageReadNote);
 				MPT_ASSERT(m_PlayState.m_nBufferCount > 0);
 				#ifdef MODPLUG_TRACKER
 					// Save pattern cue points for WAV rendering here (if we reached a new pattern, that is.)
@@ -290,7 +362,7 @@ CSoundFile::samplecount_t CSoundFile::Read(samplecount_t count, IAudioReadTarget
 
 		MPT_ASSERT(m_PlayState.m_nBufferCount > 0); // assert that we have actually something to do
 
-		const samplecount_t countChunk = std::min<samplecount_t>({ MIXBUFFERSIZE, m_PlayState.m_nBufferCount, countToRender });
+		const samplecount_t countChunk = std::min<samplecount_t>({ maxChunkSize, m_PlayState.m_nBufferCount, countToRender });
 
 		if(m_MixerSettings.NumInputChannels > 0)
 		{
@@ -298,19 +370,23 @@ CSoundFile::samplecount_t CSoundFile::Read(samplecount_t count, IAudioReadTarget
 		}
 
 		CreateStereoMix(countChunk);
+		endStage(RenderProfile::stageMix);
 
 		if(m_opl)
 		{
 			m_opl->Mix(MixSoundBuffer, countChunk, m_OPLVolumeFactor * m_nVSTiVolume / 48);
+			endStage(RenderProfile::stageOPL);
 		}
 
 		#ifndef NO_REVERB
 			m_Reverb.Process(MixSoundBuffer, countChunk);
+			endStage(RenderProfile::stageReverb);
 		#endif // NO_REVERB
 
 		if(mixPlugins)
 		{
 			ProcessPlugins(countChunk);
+			endStage(RenderProfile::stagePlugins);
 		}
 
 		if(m_MixerSettings.gnChannels == 1)
@@ -337,8 +413,11 @@ CSoundFile::samplecount_t CSoundFile::Read(samplecount_t count, IAudioReadTarget
 		{
 			InterleaveFrontRear(MixSoundBuffer, MixRearBuffer, countChunk);
 		}
+		endStage(RenderProfile::stageDSP);
 
 		target.DataCallback(MixSoundBuffer, m_MixerSettings.gnChannels, countChunk);
+		endStage(RenderProfile::stageOutput);
+		m_renderProfile.frames += countChunk;
 
 		// Buffer ready
 		countRendered += countChunk;
@@ -365,11 +444,63 @@ CSoundFile::samplecount_t CSoundFile::Read(samplecount_t count, IAudioReadTarget
 
 	// mix done
 
+	if(m_MixerSettings.RenderTimeBudgetMicroseconds)
+	{
+		const auto renderTime = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - renderStart);
+		UpdateRenderQuality(static_cast<uint64>(renderTime.count()));
+	}
+
 	return countRendered;
 
 }
 
 
+// Adjust the number of voices rendered with reduced resampling quality, based on how long the last Read() call took.
+// If rendering comes close to the time budget, the resampling quality of more voices is reduced,
+// and it is restored voice by voice once rendering is fast enough again.
+void CSoundFile::UpdateRenderQuality(uint64 renderMicroseconds)
+{
+	const uint64 budget = m_MixerSettings.RenderTimeBudgetMicroseconds;
+	const CHANNELINDEX numVoices = static_cast<CHANNELINDEX>(std::min<uint32>(m_nMixChannels, m_MixerSettings.m_nMaxMixChannels));
+	if(renderMicroseconds * 4 >= budget * 3)
+	{
+		if(m_numDegradedVoices < numVoices)
+		{
+			m_numDegradedVoices = std::min<CHANNELINDEX>(numVoices, m_numDegradedVoices + std::max<CHANNELINDEX>(1, numVoices / 4));
+			m_qualityDegradations++;
+		}
+	} else if(renderMicroseconds * 2 < budget && m_numDegradedVoices > 0)
+	{
+		m_numDegradedVoices--;
+	}
+}
+
+
+// Fall back to linear interpolation for the m_numDegradedVoices quietest voices.
+// Called at the end of ReadNote, after the resampling mode of all voices has been determined.
+void CSoundFile::DegradeQuietVoices()
+{
+	const CHANNELINDEX numVoices = static_cast<CHANNELINDEX>(std::min<uint32>(m_nMixChannels, m_MixerSettings.m_nMaxMixChannels));
+	const CHANNELINDEX numDegraded = std::min(m_numDegradedVoices, numVoices);
+	if(!numDegraded)
+		return;
+
+	// Use a copy of the mix list, as the mix order must not change
+	CHANNELINDEX voices[MAX_CHANNELS];
+	std::copy(std::begin(m_PlayState.ChnMix), std::begin(m_PlayState.ChnMix) + numVoices, std::begin(voices));
+	std::nth_element(std::begin(voices), std::begin(voices) + numDegraded - 1, std::begin(voices) + numVoices,
+		[this](CHANNELINDEX i, CHANNELINDEX j) { return (m_PlayState.Chn[i].nRealVolume < m_PlayState.Chn[j].nRealVolume); });
+	for(CHANNELINDEX i = 0; i < numDegraded; i++)
+	{
+		ModChannel &chn = m_PlayState.Chn[voices[i]];
+		if(chn.resamplingMode != SRCMODE_NEAREST && chn.resamplingMode != SRCMODE_LINEAR && chn.resamplingMode != SRCMODE_AMIGA)
+		{
+			chn.resamplingMode = SRCMODE_LINEAR;
+		}
+	}
+}
+
+
 void CSoundFile::ProcessDSP(uint32 countChunk)
 {
 	#ifndef NO_DSP
@@ -500,7 +631,7 @@ bool CSoundFile::ProcessRow()
 						m_PlayState.m_nMusicSpeed = m_nDefaultSpeed;
 						m_PlayState.m_nMusicTempo = m_nDefaultTempo;
 						m_PlayState.m_nGlobalVolume = m_nDefaultGlobalVolume;
-						for(CHANNELINDEX i = 0; i < MAX_CHANNELS; i++)
+						for(CHANNELINDEX i = 0; i < GetNumVoices(); i++)
 						{
 							m_PlayState.Chn[i].dwFlags.set(CHN_NOTEFADE | CHN_KEYOFF);
 							m_PlayState.Chn[i].nFadeOutVol = 0;
@@ -624,7 +755,7 @@ bool CSoundFile::ProcessRow()
 						visitedSongRows.Initialize(true);
 					}
 					// When jumping to the next subsong, stop all playing notes from the previous song...
-					for(CHANNELINDEX i = 0; i < MAX_CHANNELS; i++)
+					for(CHANNELINDEX i = 0; i < GetNumVoices(); i++)
 						m_PlayState.Chn[i].Reset(ModChannel::resetSetPosFull, *this, i);
 					StopAllVsti();
 					// ...and the global playback information.
@@ -665,7 +796,7 @@ bool CSoundFile::ProcessRow()
 
 		// Reset channel values
 		ModCommand *m = Patterns[m_PlayState.m_nPattern].GetRow(m_PlayState.m_nRow);
-		for (ModChannel *pChn = m_PlayState.Chn, *pEnd = pChn + m_nChannels; pChn != pEnd; pChn++, m++)
+		for (ModChannel *pChn = m_PlayState.Chn.data(), *pEnd = pChn + m_nChannels; pChn != pEnd; pChn++, m++)
 		{
 			// First, handle some quirks that happen after the last tick of the previous row...
 			if(m_playBehaviour[KST3PortaAfterArpeggio]
@@ -2028,7 +2159,7 @@ bool CSoundFile::ReadNote()
 	////////////////////////////////////////////////////////////////////////////////////
 	// Update channels data
 	m_nMixChannels = 0;
-	for (CHANNELINDEX nChn = 0; nChn < MAX_CHANNELS; nChn++)
+	for (CHANNELINDEX nChn = 0; nChn < GetNumVoices(); nChn++)
 	{
 		ModChannel &chn = m_PlayState.Chn[nChn];
 		// FT2 Compatibility: Prevent notes to be stopped after a fadeout. This way, a portamento effect can pick up a faded instrument which is long enough.
@@ -2391,6 +2522,9 @@ bool CSoundFile::ReadNote()
 				// Default to global mixer settings
 				chn.resamplingMode = static_cast<uint8>(m_Resampler.m_Settings.SrcMode);
 			}
+			// The high-order modes can only be selected in the mixer settings, which create their tables (see CResampler::InitHighOrderTables).
+			MPT_ASSERT(chn.resamplingMode != SRCMODE_SINC16 || m_Resampler.gSinc16 != nullptr);
+			MPT_ASSERT(chn.resamplingMode != SRCMODE_SINC32 || m_Resampler.gSinc32 != nullptr);
 
 			if(chn.increment.IsUnity() && !(chn.dwFlags[CHN_VIBRATO] || chn.nAutoVibDepth || chn.resamplingMode == SRCMODE_AMIGA))
 			{
@@ -2434,6 +2568,12 @@ bool CSoundFile::ReadNote()
 		std::partial_sort(std::begin(m_PlayState.ChnMix), std::begin(m_PlayState.ChnMix) + m_MixerSettings.m_nMaxMixChannels, std::begin(m_PlayState.ChnMix) + m_nMixChannels,
 			[this](CHANNELINDEX i, CHANNELINDEX j) { return (m_PlayState.Chn[i].nRealVolume > m_PlayState.Chn[j].nRealVolume); });
 	}
+
+	// Reduce resampling quality of the quietest voices if rendering takes too long
+	if(m_numDegradedVoices)
+	{
+		DegradeQuietVoices();
+	}
 	return true;
 }
 
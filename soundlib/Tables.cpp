@@ -751,6 +751,59 @@ static void getsinc(SINC_TYPE *psinc, double beta, double lowpass_factor)
 }
 
 
+// Same as getsinc, but for an arbitrary (even) filter width and with float coefficients
+static void getsinc_float(float *psinc, int width, double beta, double lowpass_factor)
+{
+	if(lowpass_factor >= 0.999)
+	{
+		lowpass_factor = 0.999;
+	}
+	const int halfWidth = width / 2;
+	const double izero_beta = izero(beta);
+	const double kPi = 4.0*atan(1.0)*lowpass_factor;
+	for(int isrc = 0; isrc < width * SINC_PHASES; isrc++)
+	{
+		double fsinc;
+		int ix = (width - 1) - (isrc % width);
+		ix = (ix * SINC_PHASES) + (isrc / width);
+		if(ix == (halfWidth * SINC_PHASES))
+		{
+			fsinc = 1.0;
+		} else
+		{
+			double x = (double)(ix - (halfWidth * SINC_PHASES)) * (double)(1.0/SINC_PHASES);
+			fsinc = sin(x*kPi) * izero(beta*sqrt(1-x*x*(1.0/(halfWidth*halfWidth)))) / (izero_beta*x*kPi); // Kaiser window
+		}
+		*psinc++ = static_cast<float>(fsinc * lowpass_factor);
+	}
+}
+
+
+HighOrderSincTables::HighOrderSincTables(int width)
+	: width(width)
+	, kaiserSinc(width * SINC_PHASES)
+	, downsample13x(width * SINC_PHASES)
+	, downsample2x(width * SINC_PHASES)
+{
+	getsinc_float(kaiserSinc.data(), width, 9.6377, 0.97);
+	getsinc_float(downsample13x.data(), width, 8.5, 0.5);
+	getsinc_float(downsample2x.data(), width, 2.7625, 0.425);
+}
+
+
+const HighOrderSincTables &HighOrderSincTables::Get(int width)
+{
+	MPT_ASSERT(width == 16 || width == 32);
+	if(width == 16)
+	{
+		static const HighOrderSincTables s_Sinc16(16);
+		return s_Sinc16;
+	}
+	static const HighOrderSincTables s_Sinc32(32);
+	return s_Sinc32;
+}
+
+
 #ifdef MODPLUG_TRACKER
 bool CResampler::StaticTablesInitialized = false;
 SINC_TYPE CResampler::gKaiserSinc[SINC_PHASES*8];     // Upsampling
@@ -780,6 +833,52 @@ void CResampler::InitFloatmixerTables()
 }
 
 
+void CResampler::InitHighOrderTables()
+{
+	if(m_Settings.SrcMode == SRCMODE_SINC16 && !gSinc16)
+	{
+		gSinc16 = &HighOrderSincTables::Get(16);
+	}
+	if(m_Settings.SrcMode == SRCMODE_SINC32 && !gSinc32)
+	{
+		gSinc32 = &HighOrderSincTables::Get(32);
+	}
+}
+
+
+#ifdef MPT_RESAMPLER_TABLES_CACHED
+
+// Tables that are the same for all resampler objects in the library.
+// Resampler objects only point to them, so that they do not have to be copied into every CSoundFile instance.
+struct CachedResamplerTables
+{
+	SINC_TYPE gKaiserSinc[SINC_PHASES * 8];     // Upsampling
+	SINC_TYPE gDownsample13x[SINC_PHASES * 8];  // Downsample 1.333x
+	SINC_TYPE gDownsample2x[SINC_PHASES * 8];   // Downsample 2x
+	CResamplerSettings settings;                // Settings the windowed FIR table has been created for
+	std::shared_ptr<const CWindowedFIR> windowedFIR;
+
+	CachedResamplerTables()
+	{
+		getsinc(gKaiserSinc, 9.6377, 0.97);
+		getsinc(gDownsample13x, 8.5, 0.5);
+		getsinc(gDownsample2x, 2.7625, 0.425);
+		auto fir = std::make_shared<CWindowedFIR>();
+		fir->InitTable(settings.gdWFIRCutoff, settings.gbWFIRType);
+		windowedFIR = std::move(fir);
+	}
+};
+
+
+static const CachedResamplerTables & GetCachedResamplerTables()
+{
+	static const CachedResamplerTables s_CachedTables;
+	return s_CachedTables;
+}
+
+#endif // MPT_RESAMPLER_TABLES_CACHED
+
+
 void CResampler::InitializeTablesFromScratch(bool force)
 {
 
@@ -799,21 +898,40 @@ void CResampler::InitializeTablesFromScratch(bool force)
 	{
 		InitFloatmixerTables();
 
-		getsinc(gKaiserSinc, 9.6377, 0.97);
-		getsinc(gDownsample13x, 8.5, 0.5);
-		getsinc(gDownsample2x, 2.7625, 0.425);
+		#ifdef MPT_RESAMPLER_TABLES_CACHED
+			const CachedResamplerTables &cache = GetCachedResamplerTables();
+			gKaiserSinc = cache.gKaiserSinc;
+			gDownsample13x = cache.gDownsample13x;
+			gDownsample2x = cache.gDownsample2x;
+		#else
+			getsinc(gKaiserSinc, 9.6377, 0.97);
+			getsinc(gDownsample13x, 8.5, 0.5);
+			getsinc(gDownsample2x, 2.7625, 0.425);
+		#endif
 
 		#ifdef MODPLUG_TRACKER
 			StaticTablesInitialized = true;
 		#endif // MODPLUG_TRACKER
 	}
 
-	if((m_OldSettings == m_Settings) && !force)
+	if((m_OldSettings == m_Settings) && m_WindowedFIR && !force)
 	{
 		return;
 	}
 
-	m_WindowedFIR.InitTable(m_Settings.gdWFIRCutoff, m_Settings.gbWFIRType);
+	#ifdef MPT_RESAMPLER_TABLES_CACHED
+		const CachedResamplerTables &cache = GetCachedResamplerTables();
+		if(m_Settings.gdWFIRCutoff == cache.settings.gdWFIRCutoff && m_Settings.gbWFIRType == cache.settings.gbWFIRType)
+		{
+			m_WindowedFIR = cache.windowedFIR;
+		} else
+	#endif // MPT_RESAMPLER_TABLES_CACHED
+		{
+			auto fir = std::make_shared<CWindowedFIR>();
+			fir->InitTable(m_Settings.gdWFIRCutoff, m_Settings.gbWFIRType);
+			m_WindowedFIR = std::move(fir);
+		}
+	InitHighOrderTables();
 
 	m_OldSettings = m_Settings;
 
@@ -822,21 +940,15 @@ void CResampler::InitializeTablesFromScratch(bool force)
 
 #ifdef MPT_RESAMPLER_TABLES_CACHED
 
-static const CResampler & GetCachedResampler()
-{
-	static CResampler s_CachedResampler(true);
-	return s_CachedResampler;	
-}
-
-
 void CResampler::InitializeTablesFromCache()
 {
-	const CResampler & s_CachedResampler = GetCachedResampler();
+	const CachedResamplerTables &cache = GetCachedResamplerTables();
 	InitFloatmixerTables();
-	std::copy(s_CachedResampler.gKaiserSinc, s_CachedResampler.gKaiserSinc + SINC_PHASES*8, gKaiserSinc);
-	std::copy(s_CachedResampler.gDownsample13x, s_CachedResampler.gDownsample13x + SINC_PHASES*8, gDownsample13x);
-	std::copy(s_CachedResampler.gDownsample2x, s_CachedResampler.gDownsample2x + SINC_PHASES*8, gDownsample2x);
-	std::copy(s_CachedResampler.m_WindowedFIR.lut, s_CachedResampler.m_WindowedFIR.lut + WFIR_LUTLEN*WFIR_WIDTH, m_WindowedFIR.lut);
+	gKaiserSinc = cache.gKaiserSinc;
+	gDownsample13x = cache.gDownsample13x;
+	gDownsample2x = cache.gDownsample2x;
+	m_WindowedFIR = cache.windowedFIR;
+	InitHighOrderTables();
 }
 
 #endif // MPT_RESAMPLER_TABLES_CACHED
@@ -848,7 +960,7 @@ struct ResampleCacheInitializer
 {
 	ResampleCacheInitializer()
 	{
-		GetCachedResampler();
+		GetCachedResamplerTables();
 	}
 };
 static ResampleCacheInitializer g_ResamplerCachePrimer;
@@ -34,6 +34,8 @@ void ReplaceSample(ModSample &smp, void *pNewSample, const SmpLength newLength,
 	CriticalSection cs;
 
 	ctrlChn::ReplaceSample(sndFile, smp, pNewSample, newLength, setFlags, resetFlags);
+	smp.InvalidatePeakMap();
+	sndFile.m_ResampleCache.Clear();
 	smp.pData.pSample = pNewSample;
 	smp.nLength = newLength;
 	ModSample::FreeSample(pOldSmp);
@@ -316,10 +318,30 @@ bool PrecomputeLoops(ModSample &smp, CSoundFile &sndFile, bool updateChannels)
 	else if(smp.GetElementarySampleSize() == 1)
 		PrecomputeLoopsImpl<int8>(smp, sndFile);
 
+	smp.UpdatePeakMap();
+	// Sample data past the sample end may have changed
+	sndFile.m_ResampleCache.Invalidate(smp.samplev());
+
 	return true;
 }
 
 
+void UpdateModifiedRange(ModSample &smp, CSoundFile &sndFile, SmpLength first, SmpLength last)
+{
+	if(!smp.HasSampleData())
+		return;
+
+	// Only copies a few sampling points around the loop points
+	if(smp.GetElementarySampleSize() == 2)
+		PrecomputeLoopsImpl<int16>(smp, sndFile);
+	else if(smp.GetElementarySampleSize() == 1)
+		PrecomputeLoopsImpl<int8>(smp, sndFile);
+
+	smp.UpdatePeakMap(first, last);
+	sndFile.m_ResampleCache.Invalidate(smp.samplev());
+}
+
+
 // Propagate loop point changes to player
 bool UpdateLoopPoints(const ModSample &smp, CSoundFile &sndFile)
 {
@@ -53,6 +53,10 @@ void ReplaceSample(ModSample &smp, void *pNewSample,  const SmpLength newLength,
 // Update loop wrap-around buffers
 bool PrecomputeLoops(ModSample &smp, CSoundFile &sndFile, bool updateChannels = true);
 
+// Update loop wrap-around buffers, peak map and resample cache after the sampling points from first to last (inclusive)
+// have been modified in place. Unlike PrecomputeLoops, this only updates the parts of the peak map and the cache that are affected.
+void UpdateModifiedRange(ModSample &smp, CSoundFile &sndFile, SmpLength first, SmpLength last);
+
 // Propagate loop point changes to player
 bool UpdateLoopPoints(const ModSample &smp, CSoundFile &sndFile);
 
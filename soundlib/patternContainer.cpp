@@ -110,6 +110,19 @@ bool CPatternContainer::IsPatternEmpty(const PATTERNINDEX nPat) const
 }
 
 
+CPatternContainer& CPatternContainer::operator=(const CPatternContainer &other)
+{
+	if(&other == this)
+		return *this;
+	m_Patterns.assign(other.Size(), CPattern(*this));
+	for(PATTERNINDEX pat = 0; pat < other.Size(); pat++)
+	{
+		m_Patterns[pat] = other.m_Patterns[pat];
+	}
+	return *this;
+}
+
+
 void CPatternContainer::ResizeArray(const PATTERNINDEX newSize)
 {
 	if(Size() <= newSize)
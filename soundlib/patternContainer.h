@@ -28,6 +28,9 @@ public:
 
 public:
 	CPatternContainer(CSoundFile& sndFile) : m_rSndFile(sndFile) { }
+	CPatternContainer(const CPatternContainer &) = default;
+	// Copy all patterns of another container. The copies belong to this container's CSoundFile.
+	CPatternContainer& operator=(const CPatternContainer &other);
 
 	// Empty and initialize all patterns.
 	void ClearPatterns();
@@ -29,7 +29,10 @@
 #include "../soundbase/SampleFormatConverters.h"
 #include "../soundbase/SampleFormatCopy.h"
 #include "../soundlib/ModSampleCopy.h"
+#include "../soundlib/modsmp_ctrl.h"
 #include "../soundlib/ITCompression.h"
+#include "../soundlib/MixFuncTable.h"
+#include "../soundlib/Resampler.h"
 #include "../soundlib/tuningcollection.h"
 #include "../soundlib/tuning.h"
 #ifdef MODPLUG_TRACKER
@@ -48,6 +51,8 @@
 #include "../soundlib/plugins/PlugInterface.h"
 #endif
 #include "../common/mptBufferIO.h"
+#include "../common/mptThreadPool.h"
+#include <functional>
 #include <limits>
 #ifdef LIBOPENMPT_BUILD
 #include <iostream>
@@ -105,6 +110,7 @@ static MPT_NOINLINE void TestSettings();
 static MPT_NOINLINE void TestStringIO();
 static MPT_NOINLINE void TestMIDIEvents();
 static MPT_NOINLINE void TestSampleConversion();
+static MPT_NOINLINE void TestMixFunctions();
 static MPT_NOINLINE void TestITCompression();
 static MPT_NOINLINE void TestTunings();
 static MPT_NOINLINE void TestPCnoteSerialization();
@@ -205,6 +211,7 @@ void DoTests()
 	DO_TEST(TestStringIO);
 	DO_TEST(TestMIDIEvents);
 	DO_TEST(TestSampleConversion);
+	DO_TEST(TestMixFunctions);
 	DO_TEST(TestITCompression);
 	DO_TEST(TestTunings);
 
@@ -3808,6 +3815,179 @@ static void SaveS3M(const TSoundFileContainer &sndFile, const mpt::PathString &f
 #endif // MODPLUG_TRACKER
 
 
+class AudioReadTargetMixBuffer : public IAudioReadTarget
+{
+public:
+	std::vector<int32> data;
+	void DataCallback(int32 *MixSoundBuffer, std::size_t channels, std::size_t countChunk) override
+	{
+		data.insert(data.end(), MixSoundBuffer, MixSoundBuffer + channels * countChunk);
+	}
+};
+
+// Read a whole file into memory
+static std::vector<mpt::byte> ReadFileData(const mpt::PathString &filename)
+{
+	mpt::ifstream stream(filename, std::ios::binary);
+	return make_FileReader(&stream).GetRawDataAsByteVector();
+}
+
+
+// Render the first few seconds of a loaded module.
+// setup is called before rendering and may modify the module or override the default mixer settings.
+static std::vector<int32> RenderMixBuffer(CSoundFile &sndFile, const std::function<void(CSoundFile &)> &setup = nullptr)
+{
+	MixerSettings mixerSettings = sndFile.m_MixerSettings;
+	mixerSettings.gdwMixingFreq = 44100;
+	mixerSettings.gnChannels = 2;
+	sndFile.SetMixerSettings(mixerSettings);
+	sndFile.SetRepeatCount(0);
+	if(setup)
+	{
+		setup(sndFile);
+	}
+	AudioReadTargetMixBuffer target;
+	sndFile.Read(44100 * 4, target);
+	return target.data;
+}
+
+
+// Load a module with the given flags and render the first few seconds of it, see above
+static std::vector<int32> RenderMixBuffer(CSoundFile &sndFile, FileReader file, CSoundFile::ModLoadingFlags loadFlags, const std::function<void(CSoundFile &)> &setup = nullptr)
+{
+	sndFile.Create(file, loadFlags);
+	return RenderMixBuffer(sndFile, setup);
+}
+
+
+// Replace the first sample by a longer one-shot sample and the pattern data by a note triggering this sample on every row at a fast tempo
+static void SetupResampleCacheTest(CSoundFile &sndFile)
+{
+	ModSample &sample = sndFile.GetSample(1);
+	sample.uFlags.reset(CHN_LOOP | CHN_SUSTAINLOOP | CHN_PINGPONGLOOP | CHN_PINGPONGSUSTAIN);
+	ctrlSmp::InsertSilence(sample, 4000, sample.nLength, sndFile);
+	for(SmpLength i = 0; i < sample.GetSampleSizeInBytes(); i++)
+	{
+		sample.sampleb()[i] = static_cast<mpt::byte>(i * 37);
+	}
+	sample.PrecomputeLoops(sndFile, false);
+	for(auto &pattern : sndFile.Patterns)
+	{
+		for(ROWINDEX row = 0; row < pattern.GetNumRows(); row++)
+		{
+			for(CHANNELINDEX chn = 0; chn < pattern.GetNumChannels(); chn++)
+			{
+				pattern.GetpModCommand(row, chn)->Clear();
+			}
+			pattern.GetpModCommand(row, 0)->note = NOTE_MIDDLEC;
+			pattern.GetpModCommand(row, 0)->instr = 1;
+		}
+		pattern.GetpModCommand(0, 1)->command = CMD_SPEED;
+		pattern.GetpModCommand(0, 1)->param = 2;
+		pattern.GetpModCommand(0, 2)->command = CMD_TEMPO;
+		pattern.GetpModCommand(0, 2)->param = 0xFF;
+	}
+}
+
+
+// Append silence to every sample and disable all loops, with or without using the silence map
+static void SetupSilenceTest(CSoundFile &sndFile, bool usePeakMap)
+{
+	for(SAMPLEINDEX smp = 1; smp <= sndFile.GetNumSamples(); smp++)
+	{
+		ModSample &sample = sndFile.GetSample(smp);
+		if(!sample.HasSampleData())
+			continue;
+		sample.uFlags.reset(CHN_LOOP | CHN_SUSTAINLOOP | CHN_PINGPONGLOOP | CHN_PINGPONGSUSTAIN);
+		ctrlSmp::InsertSilence(sample, 16384, sample.nLength, sndFile);
+		sample.PrecomputeLoops(sndFile, false);
+		if(!usePeakMap)
+			sample.InvalidatePeakMap();
+	}
+}
+
+
+// Replace the patterns by playing the first sample on the first channel every few rows. Some of the test modules are silent otherwise,
+// e.g. because their instruments map to missing or empty samples, filter everything or because the first channel is muted.
+static void SetupAudibleTest(CSoundFile &sndFile)
+{
+	sndFile.InitChannel(0);
+	for(INSTRUMENTINDEX ins = 1; ins <= sndFile.GetNumInstruments(); ins++)
+	{
+		if(sndFile.Instruments[ins] != nullptr)
+		{
+			*sndFile.Instruments[ins] = ModInstrument(1);
+		}
+	}
+	for(auto &pattern : sndFile.Patterns)
+	{
+		for(ROWINDEX row = 0; row < pattern.GetNumRows(); row++)
+		{
+			for(CHANNELINDEX chn = 0; chn < pattern.GetNumChannels(); chn++)
+			{
+				pattern.GetpModCommand(row, chn)->Clear();
+			}
+			if(row % 8 == 0)
+			{
+				pattern.GetpModCommand(row, 0)->note = NOTE_MIDDLEC;
+				pattern.GetpModCommand(row, 0)->instr = 1;
+			}
+		}
+	}
+}
+
+
+// Compare the sample headers and decoded sample data of two modules
+static void VerifySamplesEqual(const CSoundFile &expectedFile, const CSoundFile &actualFile)
+{
+	VERIFY_EQUAL_NONCONT(actualFile.GetNumSamples(), expectedFile.GetNumSamples());
+	for(SAMPLEINDEX smp = 1; smp <= actualFile.GetNumSamples(); smp++)
+	{
+		const ModSample &expected = expectedFile.GetSample(smp), &actual = actualFile.GetSample(smp);
+		VERIFY_EQUAL_NONCONT(actual.nLength, expected.nLength);
+		VERIFY_EQUAL_NONCONT(actual.nLoopStart, expected.nLoopStart);
+		VERIFY_EQUAL_NONCONT(actual.nLoopEnd, expected.nLoopEnd);
+		VERIFY_EQUAL_NONCONT(actual.uFlags == expected.uFlags, true);
+		VERIFY_EQUAL_NONCONT(actual.HasSampleData(), expected.HasSampleData());
+		if(actual.HasSampleData() && expected.HasSampleData())
+		{
+			VERIFY_EQUAL_NONCONT(std::memcmp(actual.samplev(), expected.samplev(), expected.GetSampleSizeInBytes()), 0);
+		}
+	}
+}
+
+
+// Wrap a file in an MMCMP container consisting of a single uncompressed block
+static std::vector<mpt::byte> PackMMCMP(const std::vector<mpt::byte> &data)
+{
+	std::vector<mpt::byte> packed;
+	auto write = [&packed](uint32 value, std::size_t size)
+	{
+		for(std::size_t i = 0; i < size; i++)
+		{
+			packed.push_back(mpt::byte_cast<mpt::byte>(static_cast<uint8>(value >> (i * 8))));
+		}
+	};
+	const uint32 size = static_cast<uint32>(data.size());
+	for(char c : std::string("ziRCONia"))
+		write(c, 1);
+	write(14, 2);	// Header size
+	write(0x1310, 2); write(1, 2); write(size, 4); write(24, 4); write(0, 1); write(0, 1);	// Version, number of blocks, unpacked size, block table offset, compression flags
+	write(28, 4);	// Block table
+	write(size, 4); write(size, 4); write(0, 4); write(1, 2); write(0, 2); write(0, 2); write(0, 2);	// Block header
+	write(0, 4); write(size, 4);	// Sub-block
+	packed.insert(packed.end(), data.begin(), data.end());
+	return packed;
+}
+
+
+// Exposes which sample slots have been allocated
+class SampleSlotInspector : public CSoundFile
+{
+public:
+	bool IsSampleSlotAllocated(SAMPLEINDEX smp) const { return Samples.IsAllocated(smp); }
+};
+
 
 // Test file loading and saving
 static MPT_NOINLINE void TestLoadSaveFile()
@@ -3831,6 +4011,46 @@ static MPT_NOINLINE void TestLoadSaveFile()
 
 		TestLoadMPTMFile(GetSoundFile(sndFileContainer));
 
+		// Scanning all sequences at once must yield the same lengths and seek index as scanning them one after another
+		{
+			CSoundFile &sndFile = GetSoundFile(sndFileContainer);
+			const SEQUENCEINDEX numSequences = sndFile.Order.GetNumSequences();
+			GetLengthSeekIndex serialIndex(1.0), mergedIndex(1.0);
+			std::vector<std::vector<GetLengthType>> expected, actual(numSequences);
+			std::vector<std::unique_ptr<GetLengthSeekIndex>> seekIndices;
+			for(SEQUENCEINDEX seq = 0; seq < numSequences; seq++)
+			{
+				expected.push_back(sndFile.GetLength(eNoAdjust, GetLengthTarget(true).StartPos(seq, 0, 0), &serialIndex));
+				seekIndices.push_back(mpt::make_unique<GetLengthSeekIndex>(1.0));
+			}
+			auto scan = [&](std::size_t seq)
+			{
+				const CSoundFile &constSndFile = sndFile;
+				actual[seq] = constSndFile.ScanLength(GetLengthTarget(true).StartPos(static_cast<SEQUENCEINDEX>(seq), 0, 0), seekIndices[seq].get());
+			};
+#ifdef MPT_ENABLE_THREAD
+			mpt::ThreadPool(numSequences).Run(numSequences, scan);
+#else
+			for(SEQUENCEINDEX seq = 0; seq < numSequences; seq++)
+				scan(seq);
+#endif // MPT_ENABLE_THREAD
+			for(SEQUENCEINDEX seq = 0; seq < numSequences; seq++)
+			{
+				VERIFY_EQUAL_NONCONT(actual[seq].size(), expected[seq].size());
+				for(std::size_t i = 0; i < std::min(actual[seq].size(), expected[seq].size()); i++)
+				{
+					VERIFY_EQUAL_EPS(actual[seq][i].duration, expected[seq][i].duration, 0.000001);
+					VERIFY_EQUAL_NONCONT(actual[seq][i].startOrder, expected[seq][i].startOrder);
+					VERIFY_EQUAL_NONCONT(actual[seq][i].startRow, expected[seq][i].startRow);
+					VERIFY_EQUAL_NONCONT(actual[seq][i].endOrder, expected[seq][i].endOrder);
+					VERIFY_EQUAL_NONCONT(actual[seq][i].endRow, expected[seq][i].endRow);
+				}
+				mergedIndex.Append(*seekIndices[seq]);
+				VERIFY_EQUAL_NONCONT(seekIndices[seq]->GetNumCheckpoints(), 0u);
+			}
+			VERIFY_EQUAL_NONCONT(mergedIndex.GetNumCheckpoints(), serialIndex.GetNumCheckpoints());
+		}
+
 		#ifndef MODPLUG_NO_FILESAVE
 			// Test file saving
 			GetSoundFile(sndFileContainer).m_dwLastSavedWithVersion = Version::Current();
@@ -3840,6 +4060,23 @@ static MPT_NOINLINE void TestLoadSaveFile()
 		DestroySoundFileContainer(sndFileContainer);
 	}
 
+#if defined(MPT_FILEREADER_MMAP_POSIX)
+	// Test MPTM file loading from a memory-mapped file
+	{
+		auto mapped = std::make_shared<FileDataContainerMappedFile>((filenameBaseSrc + P_("mptm")).AsNative().c_str());
+		VERIFY_EQUAL(mapped->IsValid(), true);
+		VERIFY_EQUAL(mapped->HasPinnedView(), true);
+		VERIFY_EQUAL(mapped->GetLength() > 0, true);
+		FileReader file{std::shared_ptr<const IFileDataContainer>(mapped)};
+		VERIFY_EQUAL(FileReader::PinnedRawDataView(file).data() == mapped->GetRawData(), true);
+		std::shared_ptr<CSoundFile> sndFile = std::make_shared<CSoundFile>();
+		sndFile->Create(file, CSoundFile::loadCompleteModule);
+		TestLoadMPTMFile(*sndFile);
+
+		VERIFY_EQUAL(FileDataContainerMappedFile((filenameBaseSrc + P_("does-not-exist")).AsNative().c_str()).IsValid(), false);
+	}
+#endif // MPT_FILEREADER_MMAP_POSIX
+
 	// Reload the saved file and test if everything is still working correctly.
 	#ifndef MODPLUG_NO_FILESAVE
 	{
@@ -3911,6 +4148,27 @@ static MPT_NOINLINE void TestLoadSaveFile()
 		}
 		VERIFY_EQUAL_EPS(totalDuration, 3674.38, 1.0);
 
+		// Seeking from a seek index must yield the same results as seeking from the song start
+		{
+			GetLengthSeekIndex seekIndex(2.0);
+			sndFile.GetLength(eNoAdjust, GetLengthTarget(true), &seekIndex);
+			VERIFY_EQUAL_NONCONT(seekIndex.GetNumCheckpoints() > 0, true);
+			for(const double seconds : { 0.0, 3.0, 7.5, 19.0, 60.0, 1000.0 })
+			{
+				const GetLengthType expected = sndFile.GetLength(eNoAdjust, GetLengthTarget(seconds)).back();
+				const GetLengthType actual = sndFile.GetLength(eNoAdjust, GetLengthTarget(seconds), &seekIndex).back();
+				VERIFY_EQUAL_NONCONT(actual.targetReached, expected.targetReached);
+				VERIFY_EQUAL_NONCONT(actual.lastOrder, expected.lastOrder);
+				VERIFY_EQUAL_NONCONT(actual.lastRow, expected.lastRow);
+				VERIFY_EQUAL_EPS(actual.duration, expected.duration, 0.000001);
+				if(expected.targetReached)
+				{
+					const double expectedPos = sndFile.GetLength(eNoAdjust, GetLengthTarget(expected.lastOrder, expected.lastRow)).back().duration;
+					VERIFY_EQUAL_EPS(sndFile.GetLength(eNoAdjust, GetLengthTarget(expected.lastOrder, expected.lastRow), &seekIndex).back().duration, expectedPos, 0.000001);
+				}
+			}
+		}
+
 		#ifndef MODPLUG_NO_FILESAVE
 			// Test file saving
 			sndFile.ChnSettings[1].dwFlags.set(CHN_MUTE);
@@ -3934,6 +4192,415 @@ static MPT_NOINLINE void TestLoadSaveFile()
 	}
 	#endif
 
+	const std::vector<mpt::byte> s3mData = ReadFileData(filenameBaseSrc + P_("s3m"));
+
+	// The seek index is not used when seeking with sample position adjustment, so passing one must neither change the output nor modify the index
+	{
+		auto seekAndRender = [&s3mData](double seconds, bool useSeekIndex)
+		{
+			std::unique_ptr<CSoundFile> sndFile = mpt::make_unique<CSoundFile>();
+			return RenderMixBuffer(*sndFile, FileReader(mpt::as_span(s3mData)), CSoundFile::loadCompleteModule, [seconds, useSeekIndex](CSoundFile &sndFile)
+			{
+				// Only trigger a note every few rows so that the seek target lies within a playing sample.
+				// The second channel, which sets the speed, is disabled in the original file.
+				SetupResampleCacheTest(sndFile);
+				sndFile.ChnSettings[1].dwFlags.reset(CHN_MUTE);
+				for(auto &pattern : sndFile.Patterns)
+				{
+					for(ROWINDEX row = 0; row < pattern.GetNumRows(); row++)
+					{
+						if(row % 16u)
+						{
+							pattern.GetpModCommand(row, 0)->Clear();
+						}
+					}
+				}
+				GetLengthSeekIndex seekIndex(0.5);
+				sndFile.GetLength(eNoAdjust, GetLengthTarget(true), &seekIndex);
+				const std::size_t numCheckpoints = seekIndex.GetNumCheckpoints();
+				VERIFY_EQUAL_NONCONT(numCheckpoints > 0, true);
+				// Seek like libopenmpt does with seek.sync_samples enabled
+				const GetLengthType target = sndFile.GetLength(eNoAdjust, GetLengthTarget(seconds), useSeekIndex ? &seekIndex : nullptr).back();
+				VERIFY_EQUAL_NONCONT(target.targetReached, true);
+				sndFile.m_PlayState.m_nCurrentOrder = target.lastOrder;
+				sndFile.SetCurrentOrder(target.lastOrder);
+				sndFile.m_PlayState.m_nNextRow = target.lastRow;
+				VERIFY_EQUAL_NONCONT(sndFile.GetLength(eAdjustSamplePositions, GetLengthTarget(target.lastOrder, target.lastRow), useSeekIndex ? &seekIndex : nullptr).back().targetReached, true);
+				VERIFY_EQUAL_NONCONT(seekIndex.GetNumCheckpoints(), numCheckpoints);
+			});
+		};
+		for(const double seconds : { 0.2, 0.45, 0.9 })
+		{
+			const std::vector<int32> expected = seekAndRender(seconds, false);
+			VERIFY_EQUAL_NONCONT(std::count(expected.begin(), expected.end(), 0) != static_cast<std::ptrdiff_t>(expected.size()), true);
+			VERIFY_EQUAL_NONCONT(seekAndRender(seconds, true) == expected, true);
+		}
+	}
+
+	// Neither the render block size nor mixing voices on several threads may change the output
+	{
+		auto render = [&s3mData](uint32 numThreads, uint32 blockSize)
+		{
+			std::unique_ptr<CSoundFile> sndFile = mpt::make_unique<CSoundFile>();
+			return RenderMixBuffer(*sndFile, FileReader(mpt::as_span(s3mData)), CSoundFile::loadCompleteModule, [numThreads, blockSize](CSoundFile &sndFile)
+			{
+				MixerSettings mixerSettings = sndFile.m_MixerSettings;
+				mixerSettings.NumMixThreads = numThreads;
+				mixerSettings.RenderBlockSize = blockSize;
+				sndFile.SetMixerSettings(mixerSettings);
+			});
+		};
+		const std::vector<int32> expected = render(1, MIXBUFFERSIZE);
+		VERIFY_EQUAL_NONCONT(expected.empty(), false);
+		VERIFY_EQUAL_NONCONT(std::count(expected.begin(), expected.end(), 0) != static_cast<std::ptrdiff_t>(expected.size()), true);
+		for(uint32 blockSize : { 1u, 37u, 4096u, static_cast<uint32>(MIXBUFFERSIZE_MAX) })
+		{
+			VERIFY_EQUAL_NONCONT(render(1, blockSize) == expected, true);
+		}
+#ifdef MPT_ENABLE_THREAD
+		for(uint32 numThreads : { 2u, 3u, 8u })
+		{
+			VERIFY_EQUAL_NONCONT(render(numThreads, MIXBUFFERSIZE) == expected, true);
+		}
+		VERIFY_EQUAL_NONCONT(render(4, 4096) == expected, true);
+#endif // MPT_ENABLE_THREAD
+	}
+
+	// Mixing from the resample cache may not change the output
+	for(ResamplingMode mode : { SRCMODE_CUBIC, SRCMODE_SINC8, SRCMODE_SINC8LP, SRCMODE_SINC16, SRCMODE_SINC32 })
+	{
+		// If changeWindowedFIR is true, the windowed FIR filter settings are changed after the cache has been filled
+		auto render = [&s3mData, mode](uint32 cacheSize, uint64 &cacheHits, bool changeWindowedFIR)
+		{
+			std::unique_ptr<CSoundFile> sndFile = mpt::make_unique<CSoundFile>();
+			const std::vector<int32> output = RenderMixBuffer(*sndFile, FileReader(mpt::as_span(s3mData)), CSoundFile::loadCompleteModule, [mode, cacheSize, changeWindowedFIR](CSoundFile &sndFile)
+			{
+				SetupResampleCacheTest(sndFile);
+				CResamplerSettings resamplerSettings = sndFile.m_Resampler.m_Settings;
+				resamplerSettings.SrcMode = mode;
+				sndFile.SetResamplerSettings(resamplerSettings);
+				MixerSettings mixerSettings = sndFile.m_MixerSettings;
+				mixerSettings.ResampleCacheSize = cacheSize;
+				sndFile.SetMixerSettings(mixerSettings);
+				if(changeWindowedFIR)
+				{
+					AudioReadTargetMixBuffer target;
+					sndFile.Read(44100 * 2, target);
+					resamplerSettings.gdWFIRCutoff = 0.7;
+					resamplerSettings.gbWFIRType = WFIR_HANN;
+					sndFile.SetResamplerSettings(resamplerSettings);
+				}
+			});
+			cacheHits = sndFile->m_ResampleCache.hits;
+			return output;
+		};
+		uint64 hitsWithoutCache = 0, hitsWithCache = 0, hitsWithSmallCache = 0;
+		const std::vector<int32> expected = render(0, hitsWithoutCache, false);
+		VERIFY_EQUAL_NONCONT(render(1024 * 1024, hitsWithCache, false) == expected, true);
+		VERIFY_EQUAL_NONCONT(render(1024, hitsWithSmallCache, false) == expected, true);
+		VERIFY_EQUAL_NONCONT(hitsWithoutCache, 0u);
+		VERIFY_EQUAL_NONCONT(hitsWithCache > 0, true);
+		// Changing the resampler settings must not leave data interpolated with the old filter in the cache
+		const std::vector<int32> expectedChanged = render(0, hitsWithoutCache, true);
+		VERIFY_EQUAL_NONCONT(render(1024 * 1024, hitsWithCache, true) == expectedChanged, true);
+	}
+
+	// High-order resampling modes are only available as global mixer setting.
+	// Song resampling modes with their values (e.g. read from a file) are ignored, so the global mixer setting is used instead.
+	for(ResamplingMode mode : { SRCMODE_SINC16, SRCMODE_SINC32 })
+	{
+		VERIFY_EQUAL_NONCONT(Resampling::IsKnownMode(mode), false);
+		VERIFY_EQUAL_NONCONT(Resampling::ToKnownMode(mode), Resampling::Default());
+		auto render = [&s3mData](ResamplingMode globalMode, int songMode)
+		{
+			std::unique_ptr<CSoundFile> sndFile = mpt::make_unique<CSoundFile>();
+			return RenderMixBuffer(*sndFile, FileReader(mpt::as_span(s3mData)), CSoundFile::loadCompleteModule, [globalMode, songMode](CSoundFile &sndFile)
+			{
+				CResamplerSettings resamplerSettings = sndFile.m_Resampler.m_Settings;
+				resamplerSettings.SrcMode = globalMode;
+				sndFile.SetResamplerSettings(resamplerSettings);
+				sndFile.m_nResampling = static_cast<ResamplingMode>(songMode);
+			});
+		};
+		const std::vector<int32> expectedDefault = render(Resampling::Default(), SRCMODE_DEFAULT);
+		const std::vector<int32> expectedHighOrder = render(mode, SRCMODE_DEFAULT);
+		VERIFY_EQUAL_NONCONT(std::count(expectedHighOrder.begin(), expectedHighOrder.end(), 0) != static_cast<std::ptrdiff_t>(expectedHighOrder.size()), true);
+		VERIFY_EQUAL_NONCONT(expectedHighOrder != expectedDefault, true);
+		VERIFY_EQUAL_NONCONT(render(Resampling::Default(), mode) == expectedDefault, true);
+		VERIFY_EQUAL_NONCONT(render(mode, mode) == expectedHighOrder, true);
+	}
+
+	// Skipping silent sample data may not change the output
+	{
+		std::unique_ptr<CSoundFile> withMap = mpt::make_unique<CSoundFile>(), withoutMap = mpt::make_unique<CSoundFile>();
+		const std::vector<int32> expected = RenderMixBuffer(*withMap, FileReader(mpt::as_span(s3mData)), CSoundFile::loadCompleteModule, [](CSoundFile &sndFile) { SetupSilenceTest(sndFile, true); });
+		VERIFY_EQUAL_NONCONT(RenderMixBuffer(*withoutMap, FileReader(mpt::as_span(s3mData)), CSoundFile::loadCompleteModule, [](CSoundFile &sndFile) { SetupSilenceTest(sndFile, false); }) == expected, true);
+		VERIFY_EQUAL_NONCONT(withMap->GetSilentFramesSkipped() > 0, true);
+		VERIFY_EQUAL_NONCONT(withoutMap->GetSilentFramesSkipped(), 0u);
+	}
+
+	// Exceeding the render time budget reduces the resampling quality, which is restored when rendering is fast enough again
+	{
+		TSoundFileContainer sndFileContainer = CreateSoundFileContainer(filenameBaseSrc + P_("s3m"));
+		CSoundFile &sndFile = GetSoundFile(sndFileContainer);
+		sndFile.SetRepeatCount(-1);
+		MixerSettings mixerSettings = sndFile.m_MixerSettings;
+		mixerSettings.RenderTimeBudgetMicroseconds = 1;
+		sndFile.SetMixerSettings(mixerSettings);
+		AudioReadTargetMixBuffer target;
+		for(int i = 0; i < 100; i++)
+		{
+			sndFile.Read(441, target);
+		}
+		VERIFY_EQUAL_NONCONT(sndFile.GetQualityDegradations() > 0, true);
+		VERIFY_EQUAL_NONCONT(sndFile.GetNumDegradedVoices() > 0, true);
+		mixerSettings.RenderTimeBudgetMicroseconds = uint32_max;
+		sndFile.SetMixerSettings(mixerSettings);
+		const uint64 degradations = sndFile.GetQualityDegradations();
+		for(int i = 0; i < MAX_CHANNELS; i++)
+		{
+			sndFile.Read(441, target);
+		}
+		VERIFY_EQUAL_NONCONT(sndFile.GetQualityDegradations(), degradations);
+		VERIFY_EQUAL_NONCONT(sndFile.GetNumDegradedVoices(), 0u);
+		DestroySoundFileContainer(sndFileContainer);
+	}
+
+	// Render profiling counters
+	{
+		TSoundFileContainer sndFileContainer = CreateSoundFileContainer(filenameBaseSrc + P_("s3m"));
+		CSoundFile &sndFile = GetSoundFile(sndFileContainer);
+		AudioReadTargetMixBuffer target;
+		CSoundFile::samplecount_t rendered = 0;
+		for(int i = 0; i < 10; i++)
+		{
+			rendered += sndFile.Read(4410, target);
+		}
+		const RenderProfile &profile = sndFile.GetRenderProfile();
+		VERIFY_EQUAL_NONCONT(profile.frames, rendered);
+		VERIFY_EQUAL_NONCONT(profile.calls[RenderProfile::stageReadNote] > 0, true);
+		VERIFY_EQUAL_NONCONT(profile.calls[RenderProfile::stageMix], profile.calls[RenderProfile::stageOutput]);
+		VERIFY_EQUAL_NONCONT(profile.voicesMixed > 0, true);
+		sndFile.ResetRenderProfile();
+		VERIFY_EQUAL_NONCONT(profile.frames, 0u);
+		VERIFY_EQUAL_NONCONT(profile.calls[RenderProfile::stageMix], 0u);
+		VERIFY_EQUAL_NONCONT(profile.nanoseconds[RenderProfile::stageMix], 0u);
+		DestroySoundFileContainer(sndFileContainer);
+	}
+
+	// Magic bytes may only rule out formats when probing a complete header
+	for(const auto &extension : { P_("mptm"), P_("s3m"), P_("xm") })
+	{
+		std::vector<mpt::byte> fileData;
+		{
+			mpt::ifstream stream(filenameBaseSrc + extension, std::ios::binary);
+			fileData = make_FileReader(&stream).GetRawDataAsByteVector();
+		}
+		const uint64 fileSize = fileData.size();
+		VERIFY_EQUAL_NONCONT(CSoundFile::Probe(CSoundFile::ProbeFlagsDefault, mpt::as_span(fileData), &fileSize), CSoundFile::ProbeSuccess);
+		VERIFY_EQUAL_NONCONT(CSoundFile::Probe(CSoundFile::ProbeFlagsDefault, mpt::as_span(fileData), nullptr), CSoundFile::ProbeSuccess);
+		VERIFY_EQUAL_NONCONT(CSoundFile::Probe(CSoundFile::ProbeFlagsDefault, mpt::as_span(fileData.data(), 64), &fileSize), CSoundFile::ProbeWantMoreData);
+		VERIFY_EQUAL_NONCONT(CSoundFile::Probe(CSoundFile::ProbeFlagsDefault, mpt::as_span(fileData.data(), 64), nullptr), CSoundFile::ProbeWantMoreData);
+	}
+	{
+		std::vector<mpt::byte> noise(CSoundFile::ProbeRecommendedSize * 2);
+		mpt::rng::lcg_musl prng(0x1234u);
+		for(auto &b : noise)
+			b = mpt::byte_cast<mpt::byte>(mpt::random<uint8>(prng));
+		const uint64 noiseSize = noise.size();
+		VERIFY_EQUAL_NONCONT(CSoundFile::Probe(CSoundFile::ProbeFlagsDefault, mpt::as_span(noise), &noiseSize), CSoundFile::ProbeFailure);
+		std::memcpy(noise.data() + 44, "SCRM", 4);
+		VERIFY_EQUAL_NONCONT(CSoundFile::Probe(CSoundFile::ProbeFlagsDefault, mpt::as_span(noise), &noiseSize), CSoundFile::ProbeFailure);
+		std::shared_ptr<CSoundFile> sndFile = std::make_shared<CSoundFile>();
+		VERIFY_EQUAL_NONCONT(sndFile->Create(FileReader(mpt::as_span(noise)), CSoundFile::onlyVerifyHeader), false);
+	}
+
+	// Different ways of loading a module or sharing its data with other modules may not change the output or the decoded sample data
+	for(const auto &extension : { P_("mptm"), P_("s3m"), P_("xm") })
+	{
+		const std::vector<mpt::byte> fileData = ReadFileData(filenameBaseSrc + extension);
+		const std::vector<mpt::byte> packedData = PackMMCMP(fileData);
+		mpt::ifstream stream(filenameBaseSrc + extension, std::ios::binary);
+		const CSoundFile::ModLoadingFlags deferSampleData = static_cast<CSoundFile::ModLoadingFlags>(CSoundFile::loadCompleteModule | CSoundFile::deferSampleData);
+
+		std::unique_ptr<CSoundFile> reference = mpt::make_unique<CSoundFile>();
+		reference->Create(FileReader(mpt::as_span(fileData)), CSoundFile::loadCompleteModule);
+		SetupAudibleTest(*reference);
+		const double expectedDuration = reference->ScanLength().back().duration;
+		const std::vector<int32> expectedOutput = RenderMixBuffer(*reference);
+		VERIFY_EQUAL_NONCONT(std::count(expectedOutput.begin(), expectedOutput.end(), 0) != static_cast<std::ptrdiff_t>(expectedOutput.size()), true);
+		VERIFY_EQUAL_NONCONT(reference->GetNumDeferredSamples(), 0);
+		VERIFY_EQUAL_NONCONT(reference->GetNumVoices(), MAX_CHANNELS);
+
+		std::unique_ptr<CSoundFile> copy, secondCopy;
+		// Leave some voices for NNA background notes
+		const CHANNELINDEX limitedVoices = reference->GetNumChannels() + 16;
+		const struct
+		{
+			FileReader file;
+			CSoundFile::ModLoadingFlags loadFlags;
+			uint32 loadThreads;
+			CHANNELINDEX maxVoices;
+			std::function<void(CSoundFile &)> setup;	// Called after loading and SetupAudibleTest, before rendering
+			std::function<void(std::unique_ptr<CSoundFile> &)> check;	// Called after rendering
+		} variants[] =
+		{
+			// Deferred sample decoding: Scanning the song does not need any sample data, which is decoded all at once before playback starts
+			{ FileReader(mpt::as_span(fileData)), deferSampleData, 1, MAX_CHANNELS, [&reference, expectedDuration](CSoundFile &sndFile)
+				{
+					VERIFY_EQUAL_NONCONT(sndFile.GetNumDeferredSamples() > 0, true);
+					for(SAMPLEINDEX smp = 1; smp <= sndFile.GetNumSamples(); smp++)
+					{
+						if(sndFile.IsSampleDataDeferred(smp))
+						{
+							VERIFY_EQUAL_NONCONT(sndFile.GetSample(smp).HasSampleData(), false);
+							VERIFY_EQUAL_NONCONT(sndFile.GetSample(smp).nLength, reference->GetSample(smp).nLength);
+						}
+					}
+					VERIFY_EQUAL_NONCONT(sndFile.ScanLength().back().duration, expectedDuration);
+					VERIFY_EQUAL_NONCONT(sndFile.GetNumDeferredSamples() > 0, true);
+					sndFile.DecodeDeferredSamples();
+				}, [&reference](std::unique_ptr<CSoundFile> &sndFile)
+				{
+					VERIFY_EQUAL_NONCONT(sndFile->GetNumDeferredSamples(), 0);
+					VerifySamplesEqual(*reference, *sndFile);
+				} },
+			// Decoding on several threads, reading from a stream that is not cached in memory yet
+			{ make_FileReader(&stream), CSoundFile::loadCompleteModule, 4, MAX_CHANNELS, [](CSoundFile &sndFile)
+				{
+					VERIFY_EQUAL_NONCONT(sndFile.GetNumDeferredSamples(), 0);
+				}, [&reference](std::unique_ptr<CSoundFile> &sndFile)
+				{
+					VerifySamplesEqual(*reference, *sndFile);
+				} },
+			// Decoding on several threads from data that only exists while the container is being unpacked
+			{ FileReader(mpt::as_span(packedData)), CSoundFile::loadCompleteModule, 4, MAX_CHANNELS, [](CSoundFile &sndFile)
+				{
+					VERIFY_EQUAL_NONCONT(sndFile.GetContainerType(), MOD_CONTAINERTYPE_MMCMP);
+					VERIFY_EQUAL_NONCONT(sndFile.GetNumDeferredSamples(), 0);
+				}, [&reference](std::unique_ptr<CSoundFile> &sndFile)
+				{
+					VerifySamplesEqual(*reference, *sndFile);
+				} },
+			// Modules that share their sample data with another module must play exactly like separately loaded modules
+			{ FileReader(mpt::as_span(fileData)), deferSampleData, 1, MAX_CHANNELS, [&copy](CSoundFile &original)
+				{
+					copy = mpt::make_unique<CSoundFile>();
+					VERIFY_EQUAL_NONCONT(copy->CreateSharedCopy(original), true);
+					VERIFY_EQUAL_NONCONT(original.GetNumDeferredSamples(), 0);
+					VERIFY_EQUAL_NONCONT(copy->GetType(), original.GetType());
+					VERIFY_EQUAL_NONCONT(copy->GetNumSamples(), original.GetNumSamples());
+					VERIFY_EQUAL_NONCONT(copy->GetNumInstruments(), original.GetNumInstruments());
+					VERIFY_EQUAL_NONCONT(copy->Patterns.Size(), original.Patterns.Size());
+					VERIFY_EQUAL_NONCONT(copy->Order.GetNumSequences(), original.Order.GetNumSequences());
+					VERIFY_EQUAL_NONCONT(copy->Order() == original.Order(), true);
+					for(SAMPLEINDEX smp = 1; smp <= copy->GetNumSamples(); smp++)
+					{
+						VERIFY_EQUAL_NONCONT(copy->GetSample(smp).samplev() == original.GetSample(smp).samplev(), true);
+						VERIFY_EQUAL_NONCONT(copy->IsSampleDataShared(copy->GetSample(smp)), copy->GetSample(smp).HasSampleData());
+					}
+					for(INSTRUMENTINDEX ins = 1; ins <= copy->GetNumInstruments(); ins++)
+					{
+						VERIFY_EQUAL_NONCONT(copy->Instruments[ins] != original.Instruments[ins], true);
+					}
+				}, [&copy, &secondCopy, &expectedOutput](std::unique_ptr<CSoundFile> &original)
+				{
+					secondCopy = mpt::make_unique<CSoundFile>();
+					VERIFY_EQUAL_NONCONT(secondCopy->CreateSharedCopy(*copy), true);
+					// The shared sample data must outlive the module it was loaded into.
+					original.reset();
+					VERIFY_EQUAL_NONCONT(RenderMixBuffer(*copy) == expectedOutput, true);
+
+					// Modifying a shared sample gives the module its own copy of the sample data.
+					for(SAMPLEINDEX smp = 1; smp <= copy->GetNumSamples(); smp++)
+					{
+						ModSample &sample = copy->GetSample(smp);
+						if(!sample.HasSampleData())
+						{
+							continue;
+						}
+						const void *sharedData = sample.samplev();
+						VERIFY_EQUAL_NONCONT(copy->MakeSampleDataPrivate(sample), true);
+						VERIFY_EQUAL_NONCONT(sample.samplev() != sharedData, true);
+						VERIFY_EQUAL_NONCONT(copy->IsSampleDataShared(sample), false);
+						VERIFY_EQUAL_NONCONT(std::memcmp(sample.samplev(), sharedData, sample.GetSampleSizeInBytes()), 0);
+						std::memset(sample.samplev(), 0, sample.GetSampleSizeInBytes());
+						VERIFY_EQUAL_NONCONT(secondCopy->GetSample(smp).samplev() == sharedData, true);
+					}
+					copy.reset();
+					VERIFY_EQUAL_NONCONT(RenderMixBuffer(*secondCopy) == expectedOutput, true);
+				} },
+			// Limiting the number of voices must not change the output as long as enough voices are left
+			{ FileReader(mpt::as_span(fileData)), CSoundFile::loadCompleteModule, 1, limitedVoices, [limitedVoices](CSoundFile &sndFile)
+				{
+					VERIFY_EQUAL_NONCONT(sndFile.GetNumVoices(), limitedVoices);
+				}, [](std::unique_ptr<CSoundFile> &sndFile)
+				{
+					// There are always enough voices for all pattern channels
+					sndFile->SetMaxVoices(1);
+					VERIFY_EQUAL_NONCONT(sndFile->GetMaxVoices(), 1);
+					VERIFY_EQUAL_NONCONT(sndFile->GetNumVoices(), sndFile->GetNumChannels());
+					sndFile->SetMaxVoices(MAX_CHANNELS);
+					VERIFY_EQUAL_NONCONT(sndFile->GetNumVoices(), MAX_CHANNELS);
+				} },
+		};
+
+		for(const auto &variant : variants)
+		{
+			std::unique_ptr<CSoundFile> sndFile = mpt::make_unique<CSoundFile>();
+			sndFile->SetNumLoadThreads(variant.loadThreads);
+			sndFile->SetMaxVoices(variant.maxVoices);
+			VERIFY_EQUAL_NONCONT(RenderMixBuffer(*sndFile, variant.file, variant.loadFlags, [&variant](CSoundFile &sndFile)
+			{
+				SetupAudibleTest(sndFile);
+				variant.setup(sndFile);
+			}) == expectedOutput, true);
+			variant.check(sndFile);
+		}
+
+		// Rendering never decodes sample data, so samples that are still deferred are not played
+		{
+			std::unique_ptr<CSoundFile> sndFile = mpt::make_unique<CSoundFile>();
+			const std::vector<int32> output = RenderMixBuffer(*sndFile, FileReader(mpt::as_span(fileData)), deferSampleData, SetupAudibleTest);
+			VERIFY_EQUAL_NONCONT(sndFile->IsSampleDataDeferred(1), true);
+			VERIFY_EQUAL_NONCONT(std::count(output.begin(), output.end(), 0) == static_cast<std::ptrdiff_t>(output.size()), true);
+		}
+	}
+
+	// Playing notes that refer to unused sample slots must not allocate memory for them
+	for(const auto &extension : { P_("mptm"), P_("s3m") })
+	{
+		const SAMPLEINDEX unusedSlot = 255;
+		const std::vector<mpt::byte> fileData = ReadFileData(filenameBaseSrc + extension);
+		std::unique_ptr<SampleSlotInspector> sndFile = mpt::make_unique<SampleSlotInspector>();
+		RenderMixBuffer(*sndFile, FileReader(mpt::as_span(fileData)), CSoundFile::loadCompleteModule, [&sndFile, unusedSlot](CSoundFile &)
+		{
+			VERIFY_EQUAL_NONCONT(sndFile->IsSampleSlotAllocated(unusedSlot), false);
+			// Instrument keyboards point to the unused slot, in sample mode lone sample numbers (which make IT retrigger the note if the sample changes) do.
+			for(INSTRUMENTINDEX ins = 1; ins <= sndFile->GetNumInstruments(); ins++)
+			{
+				if(sndFile->Instruments[ins] != nullptr)
+					sndFile->Instruments[ins]->AssignSample(unusedSlot);
+			}
+			sndFile->m_playBehaviour.set(kITInstrWithoutNote);
+			for(auto &pattern : sndFile->Patterns)
+			{
+				for(ROWINDEX row = 0; row < pattern.GetNumRows(); row++)
+				{
+					for(CHANNELINDEX chn = 0; chn < pattern.GetNumChannels(); chn++)
+					{
+						pattern.GetpModCommand(row, chn)->Clear();
+					}
+					pattern.GetpModCommand(row, 0)->note = (row % 2u) ? NOTE_NONE : NOTE_MIDDLEC;
+					pattern.GetpModCommand(row, 0)->instr = static_cast<ModCommand::INSTR>((row % 2u) ? unusedSlot : 1);
+				}
+				pattern.GetpModCommand(0, 1)->command = CMD_SPEED;
+				pattern.GetpModCommand(0, 1)->param = 2;
+			}
+		});
+		VERIFY_EQUAL_NONCONT(sndFile->IsSampleSlotAllocated(unusedSlot), false);
+	}
+
 	// General file I/O tests
 	{
 		mpt::ostringstream f;
@@ -4677,6 +5344,184 @@ static MPT_NOINLINE void TestSampleConversion()
 		VERIFY_EQUAL_NONCONT(signed8[3], 0);
 	}
 
+	// Conversion of the mix buffer to planar output
+	{
+		const std::size_t count = 37;
+		std::vector<int32> mix(count * 5);
+		for(std::size_t i = 0; i < mix.size(); i++)
+		{
+			mix[i] = static_cast<int32>((i * 0x12345) ^ (i << 20)) - (1 << 27);
+		}
+		for(std::size_t channels = 1; channels <= 5; channels++)
+		{
+			std::vector<int16> out16(count * channels);
+			std::vector<float> outFloat(count * channels);
+			int16 *buffers16[5];
+			float *buffersFloat[5];
+			for(std::size_t channel = 0; channel < channels; channel++)
+			{
+				buffers16[channel] = out16.data() + channel * count;
+				buffersFloat[channel] = outFloat.data() + channel * count;
+			}
+			ConvertInterleavedFixedPointToNonInterleaved<MIXING_FRACTIONAL_BITS, false>(buffers16, mix.data(), channels, count);
+			ConvertInterleavedToNonInterleaved(buffersFloat, mix.data(), channels, count, SC::ConvertFixedPointToFloatWithGain<MIXING_FRACTIONAL_BITS>(0.5f));
+			SC::ConvertFixedPoint<int16, int32, MIXING_FRACTIONAL_BITS, false> conv16;
+			SC::ConvertFixedPoint<float, int32, MIXING_FRACTIONAL_BITS, false> convFloat;
+			for(std::size_t i = 0; i < count; i++)
+			{
+				for(std::size_t channel = 0; channel < channels; channel++)
+				{
+					VERIFY_EQUAL_QUIET_NONCONT(buffers16[channel][i], conv16(mix[i * channels + channel]));
+					VERIFY_EQUAL_QUIET_NONCONT(buffersFloat[channel][i], convFloat(mix[i * channels + channel]) * 0.5f);
+				}
+			}
+		}
+	}
+
+	// Peak map
+	{
+		std::vector<int16> data(300, 0);
+		data[130] = -1;
+		ModSample sample;
+		sample.Initialize();
+		sample.nLength = 300;
+		sample.uFlags.set(CHN_16BIT);
+		sample.pData.pSample = data.data();
+		VERIFY_EQUAL_NONCONT(sample.IsSilent(0, 10), false);
+		sample.UpdatePeakMap();
+		VERIFY_EQUAL_NONCONT(sample.peakMap.size(), 5u);
+		VERIFY_EQUAL_NONCONT(sample.IsSilent(0, 127), true);
+		VERIFY_EQUAL_NONCONT(sample.IsSilent(100, 130), false);
+		VERIFY_EQUAL_NONCONT(sample.IsSilent(192, 1000), true);
+		data[299] = 5;
+		sample.UpdatePeakMap();
+		VERIFY_EQUAL_NONCONT(sample.IsSilent(192, 255), true);
+		VERIFY_EQUAL_NONCONT(sample.IsSilent(192, 1000), false);
+		// Partial updates only recompute the blocks covering the modified range
+		data[130] = 0;
+		data[10] = 7;
+		sample.UpdatePeakMap(130, 130);
+		VERIFY_EQUAL_NONCONT(sample.IsSilent(64, 191), true);
+		VERIFY_EQUAL_NONCONT(sample.IsSilent(0, 63), true);
+		sample.UpdatePeakMap(10, 10);
+		VERIFY_EQUAL_NONCONT(sample.IsSilent(0, 63), false);
+		// The map must not be used with different sample data
+		std::vector<int16> otherData(300, 0);
+		sample.pData.pSample = otherData.data();
+		VERIFY_EQUAL_NONCONT(sample.IsSilent(0, 127), false);
+		sample.InvalidatePeakMap();
+		VERIFY_EQUAL_NONCONT(sample.peakMap.empty(), true);
+		sample.pData.pSample = nullptr;
+	}
+
+	// Invalidating the resample cache entries of one sample keeps the entries of all other samples
+	{
+		ResampleCache cache;
+		cache.SetMaxSize(1024 * 1024);
+		const int16 sampleA[4] = { 0 }, sampleB[4] = { 0 };
+		for(int64 increment = 1; increment <= 3; increment++)
+		{
+			cache.Create({ sampleA, 4, increment, 0, 0 }, 16);
+			cache.Create({ sampleB, 4, increment, 0, 0 }, 16);
+		}
+		VERIFY_EQUAL_NONCONT(cache.GetNumEntries(), 6u);
+		cache.Invalidate(sampleA);
+		VERIFY_EQUAL_NONCONT(cache.GetNumEntries(), 3u);
+		VERIFY_EQUAL_NONCONT(cache.GetSize(), 3 * 16 * 2 * sizeof(mixsample_t));
+		VERIFY_EQUAL_NONCONT(cache.Find({ sampleA, 4, 1, 0, 0 }) == nullptr, true);
+		VERIFY_EQUAL_NONCONT(cache.Find({ sampleB, 4, 2, 0, 0 }) != nullptr, true);
+	}
+
+}
+
+static MPT_NOINLINE void TestMixFunctions()
+{
+	// Optimized mix functions must produce exactly the same output as the generic implementation.
+	// Every optimized table that is built and supported by the processor is tested, not only the one picked by GetFunctions().
+	std::vector<const MixFuncInterface *> optimizedTables;
+#if defined(MPT_INTMIXER) && defined(ENABLE_SSE4)
+	if(GetProcSupport() & PROCSUPPORT_SSE4_1)
+	{
+		optimizedTables.push_back(MixFuncTable::FunctionsSSE4);
+	}
+#endif // MPT_INTMIXER && ENABLE_SSE4
+
+	mpt::default_prng & prng = *s_PRNG;
+	CResampler resampler;
+	for(ResamplingMode mode : { SRCMODE_SINC16, SRCMODE_SINC32, SRCMODE_SINC8 })
+	{
+		resampler.m_Settings.SrcMode = mode;
+		resampler.UpdateTables();
+	}
+
+	std::vector<int16> sampleData(4096);
+	for(auto &smp : sampleData)
+	{
+		smp = mpt::random<int16>(prng);
+	}
+
+	for(const MixFuncInterface *mixFunctions : optimizedTables)
+	{
+		for(uint32 srcMode : { MixFuncTable::ndxKaiser, MixFuncTable::ndxFIRFilter, MixFuncTable::ndxSinc16, MixFuncTable::ndxSinc32 })
+		{
+			for(uint32 variant = 0; variant < 16; variant++)
+			{
+				const uint32 functionNdx = srcMode | variant;
+				ModChannel chn = ModChannel();
+				chn.pCurrentSample = sampleData.data() + 16;
+				chn.position = SamplePosition(0, mpt::random<uint32>(prng));
+				// Also test downsampling, which uses different Kaiser tables
+				chn.increment = SamplePosition(static_cast<int64>(mpt::random<uint64>(prng) % 0x200000000ull));
+				chn.leftVol = chn.rightVol = 4096;
+				chn.rampLeftVol = chn.rampRightVol = 4096 << VOLUMERAMPPRECISION;
+				chn.leftRamp = -1;
+				chn.rightRamp = 1;
+				chn.nFilter_A0 = 1 << (MIXING_FILTER_PRECISION - 2);
+				chn.nFilter_B0 = 1 << (MIXING_FILTER_PRECISION - 2);
+				chn.nFilter_B1 = -(1 << (MIXING_FILTER_PRECISION - 3));
+				ModChannel chnOptimized = chn;
+
+				std::vector<mixsample_t> mix(256 * 2, 0), mixOptimized(256 * 2, 0);
+				MixFuncTable::Functions[functionNdx](chn, resampler, mix.data(), 256);
+				mixFunctions[functionNdx](chnOptimized, resampler, mixOptimized.data(), 256);
+				if(srcMode == MixFuncTable::ndxSinc16 || srcMode == MixFuncTable::ndxSinc32)
+				{
+					// The float sums may be reordered by the compiler (e.g. with -ffast-math), so the rounded interpolated value may differ by one step.
+					// Mixing at unity volume (4096) scales one step of the interpolated value to 4096 in the mix buffer.
+					const auto isSimilar = [](mixsample_t a, mixsample_t b) { return std::abs(a - b) <= 4096; };
+					VERIFY_EQUAL(std::equal(mix.begin(), mix.end(), mixOptimized.begin(), isSimilar), true);
+					VERIFY_EQUAL(isSimilar(chn.nFilter_Y[0][0], chnOptimized.nFilter_Y[0][0]), true);
+				} else
+				{
+					VERIFY_EQUAL(mix == mixOptimized, true);
+					VERIFY_EQUAL(chn.nFilter_Y[0][0], chnOptimized.nFilter_Y[0][0]);
+				}
+				VERIFY_EQUAL(chn.position.GetRaw(), chnOptimized.position.GetRaw());
+				VERIFY_EQUAL(chn.rampLeftVol, chnOptimized.rampLeftVol);
+			}
+		}
+	}
+
+	// The high-order resamplers must reproduce a constant signal
+	std::vector<int16> dcData(64, 16384);
+	std::vector<const MixFuncInterface *> allTables = optimizedTables;
+	allTables.insert(allTables.begin(), MixFuncTable::Functions);
+	for(const MixFuncInterface *mixFunctions : allTables)
+	{
+		for(uint32 srcMode : { MixFuncTable::ndxSinc16, MixFuncTable::ndxSinc32 })
+		{
+			ModChannel chn = ModChannel();
+			chn.pCurrentSample = dcData.data() + 16;
+			chn.increment = SamplePosition(0x80000000ll);
+			chn.leftVol = chn.rightVol = 1;
+			std::vector<mixsample_t> mix(32 * 2, 0);
+			mixFunctions[srcMode | MixFuncTable::ndx16Bit](chn, resampler, mix.data(), 32);
+			for(auto smp : mix)
+			{
+				VERIFY_EQUAL_EPS(smp, 16384, 16384 * 0.02);
+			}
+		}
+	}
 }
 
 